@@ -239,6 +239,22 @@ static const uint64_t g_catalog_seeds[] = {
 static ledger_state_t g_ledger_state;
 static ttak_owner_t *g_ledger_owner;
 
+/* Owner handles resolved once in ledger_init_owner; the hot paths dispatch by index. */
+typedef struct {
+    ttak_owner_handle_t resource;
+    ttak_owner_handle_t store_found;
+    ttak_owner_handle_t store_jump;
+    ttak_owner_handle_t store_track;
+    ttak_owner_handle_t persist_found;
+    ttak_owner_handle_t persist_jump;
+    ttak_owner_handle_t persist_track;
+    ttak_owner_handle_t mark_found_persisted;
+    ttak_owner_handle_t mark_jump_persisted;
+    ttak_owner_handle_t mark_track_persisted;
+} ledger_handles_t;
+
+static ledger_handles_t g_ledger_handles;
+
 static pending_queue_t g_pending_queue;
 static ttak_mutex_t g_pending_lock = PTHREAD_MUTEX_INITIALIZER;
 
@@ -1138,34 +1154,34 @@ static void ledger_owner_mark_track_persisted(void *ctx, void *args) {
 static bool ledger_store_found_record(const found_record_t *rec) {
     if (!g_ledger_owner || !rec) return false;
     ledger_store_found_args_t args = {.record = rec, .ok = false};
-    ttak_owner_execute(g_ledger_owner, "store_found", LEDGER_RESOURCE_NAME, &args);
+    ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.store_found, g_ledger_handles.resource, &args);
     return args.ok;
 }
 
 static bool ledger_store_jump_record(const jump_record_t *rec) {
     if (!g_ledger_owner || !rec) return false;
     ledger_store_jump_args_t args = {.record = rec, .ok = false};
-    ttak_owner_execute(g_ledger_owner, "store_jump", LEDGER_RESOURCE_NAME, &args);
+    ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.store_jump, g_ledger_handles.resource, &args);
     return args.ok;
 }
 
 static bool ledger_store_track_record(const track_record_t *rec) {
     if (!g_ledger_owner || !rec) return false;
     ledger_store_track_args_t args = {.record = rec, .ok = false};
-    ttak_owner_execute(g_ledger_owner, "store_track", LEDGER_RESOURCE_NAME, &args);
+    ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.store_track, g_ledger_handles.resource, &args);
     return args.ok;
 }
 
 static void ledger_mark_found_persisted(void) {
-    if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "mark_found_persisted", LEDGER_RESOURCE_NAME, NULL);
+    if (g_ledger_owner) ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.mark_found_persisted, g_ledger_handles.resource, NULL);
 }
 
 static void ledger_mark_jump_persisted(void) {
-    if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "mark_jump_persisted", LEDGER_RESOURCE_NAME, NULL);
+    if (g_ledger_owner) ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.mark_jump_persisted, g_ledger_handles.resource, NULL);
 }
 
 static void ledger_mark_track_persisted(void) {
-    if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "mark_track_persisted", LEDGER_RESOURCE_NAME, NULL);
+    if (g_ledger_owner) ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.mark_track_persisted, g_ledger_handles.resource, NULL);
 }
 
 static bool ledger_init_owner(void) {
@@ -1194,6 +1210,19 @@ static bool ledger_init_owner(void) {
     ok &= ttak_owner_register_func(g_ledger_owner, "mark_found_persisted", ledger_owner_mark_found_persisted);
     ok &= ttak_owner_register_func(g_ledger_owner, "mark_jump_persisted", ledger_owner_mark_jump_persisted);
     ok &= ttak_owner_register_func(g_ledger_owner, "mark_track_persisted", ledger_owner_mark_track_persisted);
+    if (ok) {
+        ledger_handles_t *h = &g_ledger_handles;
+        h->resource = ttak_owner_resolve_resource(g_ledger_owner, LEDGER_RESOURCE_NAME);
+        h->store_found = ttak_owner_resolve_func(g_ledger_owner, "store_found");
+        h->store_jump = ttak_owner_resolve_func(g_ledger_owner, "store_jump");
+        h->store_track = ttak_owner_resolve_func(g_ledger_owner, "store_track");
+        h->persist_found = ttak_owner_resolve_func(g_ledger_owner, "persist_found");
+        h->persist_jump = ttak_owner_resolve_func(g_ledger_owner, "persist_jump");
+        h->persist_track = ttak_owner_resolve_func(g_ledger_owner, "persist_track");
+        h->mark_found_persisted = ttak_owner_resolve_func(g_ledger_owner, "mark_found_persisted");
+        h->mark_jump_persisted = ttak_owner_resolve_func(g_ledger_owner, "mark_jump_persisted");
+        h->mark_track_persisted = ttak_owner_resolve_func(g_ledger_owner, "mark_track_persisted");
+    }
     if (!ok) {
         fprintf(stderr, "[ALIQUOT] Failed to register ledger owner funcs\n");
         ttak_owner_destroy(g_ledger_owner);
@@ -1373,15 +1402,15 @@ static void rehydrate_track_record(const track_record_t *rec) {
 }
 
 static void persist_found_records(void) {
-    if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "persist_found", LEDGER_RESOURCE_NAME, NULL);
+    if (g_ledger_owner) ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.persist_found, g_ledger_handles.resource, NULL);
 }
 
 static void persist_jump_records(void) {
-    if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "persist_jump", LEDGER_RESOURCE_NAME, NULL);
+    if (g_ledger_owner) ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.persist_jump, g_ledger_handles.resource, NULL);
 }
 
 static void persist_track_records(void) {
-    if (g_ledger_owner) ttak_owner_execute(g_ledger_owner, "persist_track", LEDGER_RESOURCE_NAME, NULL);
+    if (g_ledger_owner) ttak_owner_execute_handle(g_ledger_owner, g_ledger_handles.persist_track, g_ledger_handles.resource, NULL);
 }
 
 static void persist_queue_state(void) {
@@ -0,0 +1,166 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+
+// libttak includes
+#include <ttak/ht/map.h>
+#include <ttak/ht/hash.h>
+
+// --- Configuration & Defaults ---
+
+typedef struct {
+    size_t keys;
+    size_t lookups;
+    int rounds;
+} config_t;
+
+static config_t cfg = {
+    .keys = 1000000,
+    .lookups = 10000000,
+    .rounds = 3
+};
+
+static const struct {
+    ttak_hash_policy_t policy;
+    const char *name;
+} policies[] = {
+    { TTAK_HASH_SIPHASH, "siphash-2-4 (keyed)" },
+    { TTAK_HASH_MIX,     "multiply-xorshift" },
+    { TTAK_HASH_WYHASH,  "wyhash" },
+};
+
+#define POLICY_COUNT (sizeof(policies) / sizeof(policies[0]))
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t xorshift(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+// --- Workload ---
+
+/**
+ * Pointer-like keys: 64-byte aligned addresses in one heap range, the case
+ * the mixer is meant for and the one that punishes weak low-bit hashing.
+ */
+static uintptr_t key_of(size_t i) {
+    return (uintptr_t)0x7f0000000000ULL + ((uintptr_t)i << 6);
+}
+
+typedef struct {
+    double hash_ns;     // Raw hash cost per key
+    double hit_ns;      // Lookup of a present key
+    double miss_ns;     // Lookup of an absent key
+    double insert_ns;   // Insert of a fresh key, growth included
+} result_t;
+
+static void run_policy(size_t p, const size_t *order, result_t *out) {
+    uint64_t k0, k1;
+    ttak_hash_process_keys(&k0, &k1);
+
+    // Raw hash throughput, folded into a sink so it is not optimized away.
+    volatile uint64_t sink = 0;
+    uint64_t acc = 0;
+    uint64_t t0 = now_ns();
+    for (size_t i = 0; i < cfg.lookups; i++) {
+        acc ^= ttak_hash_word(policies[p].policy, key_of(order[i]), k0, k1);
+    }
+    out->hash_ns = (double)(now_ns() - t0) / (double)cfg.lookups;
+    sink = acc;
+
+    tt_map_t *map = ttak_create_map_with_hash(16, policies[p].policy, 0);
+    if (!map) {
+        fprintf(stderr, "map allocation failed\n");
+        exit(1);
+    }
+    t0 = now_ns();
+    for (size_t i = 0; i < cfg.keys; i++) {
+        ttak_insert_to_map(map, key_of(i), i, 0);
+    }
+    out->insert_ns = (double)(now_ns() - t0) / (double)cfg.keys;
+
+    size_t found = 0, val = 0;
+    t0 = now_ns();
+    for (size_t i = 0; i < cfg.lookups; i++) {
+        found += ttak_map_get_key(map, key_of(order[i]), &val, 0);
+    }
+    out->hit_ns = (double)(now_ns() - t0) / (double)cfg.lookups;
+    if (found != cfg.lookups) {
+        fprintf(stderr, "%s: %zu of %zu lookups hit\n", policies[p].name, found, cfg.lookups);
+        exit(1);
+    }
+
+    t0 = now_ns();
+    for (size_t i = 0; i < cfg.lookups; i++) {
+        found -= ttak_map_get_key(map, key_of(cfg.keys + order[i]), NULL, 0);
+    }
+    out->miss_ns = (double)(now_ns() - t0) / (double)cfg.lookups;
+    sink ^= found + val;
+    (void)sink;
+
+    ttak_destroy_map(map);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--keys N] [--lookups N] [--rounds N]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    static const struct option options[] = {
+        { "keys",    required_argument, 0, 'k' },
+        { "lookups", required_argument, 0, 'n' },
+        { "rounds",  required_argument, 0, 'r' },
+        { 0, 0, 0, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "k:n:r:", options, NULL)) != -1) {
+        switch (opt) {
+            case 'k': cfg.keys = strtoull(optarg, NULL, 10); break;
+            case 'n': cfg.lookups = strtoull(optarg, NULL, 10); break;
+            case 'r': cfg.rounds = atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (cfg.keys == 0 || cfg.lookups == 0 || cfg.rounds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Random lookup order over the present keys, shared by every policy.
+    size_t *order = malloc(cfg.lookups * sizeof(size_t));
+    if (!order) return 1;
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < cfg.lookups; i++) {
+        order[i] = (size_t)(xorshift(&seed) % cfg.keys);
+    }
+
+    printf("keys=%zu lookups=%zu rounds=%d (best round shown)\n\n", cfg.keys, cfg.lookups, cfg.rounds);
+    printf("%-22s %10s %10s %10s %10s\n", "policy", "hash ns", "hit ns", "miss ns", "insert ns");
+    for (size_t p = 0; p < POLICY_COUNT; p++) {
+        result_t best = { 1e30, 1e30, 1e30, 1e30 };
+        for (int r = 0; r < cfg.rounds; r++) {
+            result_t res;
+            run_policy(p, order, &res);
+            if (res.hash_ns < best.hash_ns) best.hash_ns = res.hash_ns;
+            if (res.hit_ns < best.hit_ns) best.hit_ns = res.hit_ns;
+            if (res.miss_ns < best.miss_ns) best.miss_ns = res.miss_ns;
+            if (res.insert_ns < best.insert_ns) best.insert_ns = res.insert_ns;
+        }
+        printf("%-22s %10.2f %10.2f %10.2f %10.2f\n", policies[p].name,
+               best.hash_ns, best.hit_ns, best.miss_ns, best.insert_ns);
+    }
+    free(order);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#ifndef __TTAK_CONCURRENT_MAP_H__
+#define __TTAK_CONCURRENT_MAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <ttak/sync/sync.h>
+#include <ttak/mem/hazard.h>
+
+/**
+ * @brief Slots per versioned bucket.
+ */
+#define TTAK_CMAP_BUCKET_SLOTS 8
+
+/**
+ * @brief Most shards a concurrent map may be split into.
+ */
+#define TTAK_CMAP_MAX_SHARDS 4096
+
+/**
+ * @brief Eight slots guarded by one version counter.
+ *
+ * The control word packs one control byte per slot (byte i belongs to slot
+ * i; EMPTY, DELETED or the 7-bit hash fragment, as in ttak_map_t). A writer
+ * makes the version odd before it touches the bucket and even again after,
+ * so a reader that sees the same even version before and after its reads
+ * has read a consistent bucket.
+ */
+typedef struct ttak_cmap_bucket {
+    _Atomic uint64_t version;                           /**< Odd while a writer is inside the bucket. */
+    _Atomic uint64_t ctrl;                              /**< Control bytes of the eight slots. */
+    _Atomic uintptr_t keys[TTAK_CMAP_BUCKET_SLOTS];     /**< Slot keys. */
+    _Atomic size_t values[TTAK_CMAP_BUCKET_SLOTS];      /**< Slot values. */
+} ttak_cmap_bucket_t;
+
+/**
+ * @brief One shard's table. Replaced as a whole when the shard resizes.
+ */
+typedef struct ttak_cmap_table {
+    size_t bucket_mask;             /**< Buckets - 1 (a power of two minus one). */
+    ttak_cmap_bucket_t buckets[];   /**< Bucket array. */
+} ttak_cmap_table_t;
+
+/**
+ * @brief State behind each ttak_shard_t::data.
+ *
+ * Only writers holding the shard's lock modify it; readers only load the
+ * table pointer.
+ */
+typedef struct ttak_cmap_shard {
+    void *_Atomic table;            /**< Current ttak_cmap_table_t. */
+    _Atomic size_t size;            /**< Live entries. */
+    size_t growth_left;             /**< EMPTY slots that may still be filled before a resize. */
+} ttak_cmap_shard_t;
+
+/**
+ * @brief Map from machine words to machine words shared between threads.
+ *
+ * The key's hash picks one of a power-of-two number of ttak_shard_t. Writers
+ * take that shard's lock for writing, so writers to different shards never
+ * meet. Readers take no lock: they protect the shard's table with a hazard
+ * pointer and validate each bucket they read against its version, retrying
+ * the bucket if a writer was inside it. A shard that runs out of room builds
+ * a new table under its own lock, publishes it and retires the old one to
+ * the map's hazard domain; the other shards are not involved.
+ */
+typedef struct ttak_concurrent_map {
+    ttak_shard_t *shards;           /**< Shard locks; each data points to a ttak_cmap_shard_t. */
+    size_t shard_mask;              /**< Shards - 1. */
+    ttak_hazard_domain_t hazard;    /**< Reclaims tables replaced by a resize. */
+    uint64_t hash_k0;               /**< First SipHash key (per-process random). */
+    uint64_t hash_k1;               /**< Second SipHash key. */
+} ttak_concurrent_map_t;
+
+typedef ttak_concurrent_map_t tt_cmap_t;
+
+/**
+ * @brief Computes the value stored by ttak_concurrent_map_compute.
+ *
+ * @param old Current value (0 if @p found is false).
+ * @param found Whether the key was present.
+ * @param arg User argument.
+ * @return Value to store.
+ */
+typedef size_t (*ttak_cmap_compute_t)(size_t old, _Bool found, void *arg);
+
+/**
+ * @brief Creates a concurrent map.
+ *
+ * @param shards Number of shards, rounded up to a power of two (at most
+ *               TTAK_CMAP_MAX_SHARDS); 0 picks one per online CPU.
+ * @param init_cap Expected number of entries across all shards.
+ * @param now Timestamp for memory tracker integration.
+ * @return Newly created map or NULL on allocation failure.
+ */
+ttak_concurrent_map_t *ttak_concurrent_map_create(size_t shards, size_t init_cap, uint64_t now);
+
+/**
+ * @brief Frees the map, its tables and every retired table.
+ *
+ * No other thread may still use the map.
+ */
+void ttak_concurrent_map_destroy(ttak_concurrent_map_t *map);
+
+/**
+ * @brief Inserts or updates an entry.
+ *
+ * @return false if the shard could not grow to hold a new key.
+ */
+_Bool ttak_concurrent_map_insert(ttak_concurrent_map_t *map, uintptr_t key, size_t val, uint64_t now);
+
+/**
+ * @brief Atomically replaces the value of @p key with fn(old, found, arg).
+ *
+ * Runs under the shard's writer lock, so concurrent read-modify-write
+ * updates of one key are never lost.
+ *
+ * @param out Optional pointer receiving the stored value.
+ * @return false if the shard could not grow to hold a new key.
+ */
+_Bool ttak_concurrent_map_compute(ttak_concurrent_map_t *map, uintptr_t key, ttak_cmap_compute_t fn, void *arg, size_t *out, uint64_t now);
+
+/**
+ * @brief Looks up a key without taking a lock.
+ *
+ * @param out Optional pointer receiving the value.
+ * @return true if the key is present.
+ */
+_Bool ttak_concurrent_map_get(ttak_concurrent_map_t *map, uintptr_t key, size_t *out);
+
+/**
+ * @brief Removes a key.
+ *
+ * @return true if the key was present.
+ */
+_Bool ttak_concurrent_map_delete(ttak_concurrent_map_t *map, uintptr_t key);
+
+/**
+ * @brief Returns the number of entries (exact only while no writer runs).
+ */
+size_t ttak_concurrent_map_size(ttak_concurrent_map_t *map);
+
+/**
+ * @brief Releases the calling thread's reader state. Call before a reading thread exits.
+ */
+void ttak_concurrent_map_unregister_thread(ttak_concurrent_map_t *map);
+
+#endif // __TTAK_CONCURRENT_MAP_H__
@@ -3,33 +3,91 @@
 
 #include <stdint.h>
 #include <stddef.h>
-#include <stdalign.h>
 
-#define EMPTY    0x00
-#define DELETED  0xDE
-#define OCCUPIED 0x0C
+/**
+ * @brief Control bytes per probe group.
+ */
+#define TTAK_MAP_GROUP_WIDTH 16
 
 /**
- * @brief Node structure with max_align_t padding for Raspberry Pi compatibility.
+ * @brief Control byte values.
+ *
+ * A full slot stores the low 7 bits of its key's hash (0x00..0x7F), so
+ * EMPTY and DELETED are the only values with the high bit set.
  */
-typedef struct _node {
-    uintptr_t key;
-    size_t    value;
-    uint8_t   ctrl;
-    alignas(max_align_t) char padding[0]; 
-} ttak_node_t;
+#define EMPTY    0x80
+#define DELETED  0xFE
 
-typedef ttak_node_t tt_nd_t;
+/**
+ * @brief How a map hashes its keys, fixed when the map is created.
+ */
+typedef enum ttak_hash_policy {
+    TTAK_HASH_SIPHASH = 0,  /**< SipHash-2-4 with random per-process keys; for keys an attacker may choose. */
+    TTAK_HASH_MIX,          /**< Multiply-xorshift finalizer; for trusted pointer and integer keys. */
+    TTAK_HASH_WYHASH        /**< wyhash-style multiply-fold; fast general-purpose hashing. */
+} ttak_hash_policy_t;
 
+/**
+ * @brief Open-addressing map from machine words to machine words.
+ *
+ * Swiss-table layout: one control byte per slot, kept apart from the
+ * densely packed key and value arrays and scanned a group of
+ * TTAK_MAP_GROUP_WIDTH bytes at a time. All three arrays share one
+ * allocation, with the control bytes first.
+ *
+ * While a shrink is in progress the previous table stays attached as
+ * old_ctrl and is drained into the current one a few groups per update.
+ */
 typedef struct {
-    ttak_node_t *tbl;
-    size_t      cap;
-    size_t      size;
-    alignas(max_align_t) char padding[0];
+    uint8_t     *ctrl;          /**< cap control bytes; start of the table allocation */
+    uintptr_t   *keys;          /**< cap keys */
+    size_t      *values;        /**< cap values */
+    size_t      cap;            /**< Slots, a power of two and at least one group */
+    size_t      size;           /**< Live entries, including those not yet drained from old_ctrl */
+    size_t      growth_left;    /**< EMPTY slots that may still be filled before a rehash */
+    uint8_t     *old_ctrl;      /**< Table being drained by an incremental shrink, or NULL */
+    size_t      old_cap;        /**< Slots in old_ctrl */
+    size_t      old_next;       /**< First slot of old_ctrl not yet drained */
+    ttak_hash_policy_t hash_policy; /**< Key hash chosen at creation */
+    uint64_t    hash_k0;        /**< First hash key (per-process random) */
+    uint64_t    hash_k1;        /**< Second hash key, used by TTAK_HASH_SIPHASH */
 } ttak_map_t;
 
 typedef ttak_map_t tt_map_t;
 
 uint64_t gen_hash_sip24(uintptr_t key, uint64_t k0, uint64_t k1);
 
+/**
+ * @brief Mixes a machine word with a multiply-xorshift finalizer.
+ *
+ * Two multiplications; every output bit depends on every input bit, but
+ * the seed gives no protection against chosen keys.
+ */
+uint64_t ttak_hash_mix(uint64_t key, uint64_t seed);
+
+/**
+ * @brief wyhash-style hash of a machine word (the 8-byte case of ttak_hash_wy).
+ */
+uint64_t ttak_hash_wy_word(uint64_t key, uint64_t seed);
+
+/**
+ * @brief wyhash-style hash of @p len bytes.
+ *
+ * Folds 128-bit products of the input with fixed odd constants, 16 or 48
+ * bytes per step. Fast and well distributed, but not a keyed PRF.
+ */
+uint64_t ttak_hash_wy(const void *data, size_t len, uint64_t seed);
+
+/**
+ * @brief Returns the process-wide random hash keys.
+ *
+ * Drawn once from the OS random source on first use.
+ */
+void ttak_hash_process_keys(uint64_t *k0, uint64_t *k1);
+
+/**
+ * @brief Hashes @p key the way a map created with @p policy does.
+ */
+uint64_t ttak_hash_word(ttak_hash_policy_t policy, uintptr_t key, uint64_t k0, uint64_t k1);
+
 #endif // __TTAK_HASH_H__
\ No newline at end of file
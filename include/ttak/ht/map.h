@@ -7,14 +7,18 @@
 
 // Shortcuts definition
 #define ttak_create_map tt_create_map
+#define ttak_create_map_with_hash tt_create_map_hash
 #define ttak_insert_to_map tt_ins_map
 #define ttak_map_get_key tt_map_get
 #define ttak_delete_from_map tt_del_map
+#define ttak_destroy_map tt_destroy_map
 
 tt_map_t *ttak_create_map(size_t init_cap, uint64_t now);
+tt_map_t *ttak_create_map_with_hash(size_t init_cap, ttak_hash_policy_t policy, uint64_t now);
 void ttak_insert_to_map(tt_map_t *map, uintptr_t key, size_t val, uint64_t now);
 void ttak_delete_from_map(tt_map_t *map, uintptr_t key, uint64_t now);
 _Bool ttak_map_get_key(tt_map_t *map, uintptr_t key, size_t *out, uint64_t now);
+void ttak_destroy_map(tt_map_t *map);
 
 // Macros for memory resizing
 #define __TT_MAP_RESIZE__ 3
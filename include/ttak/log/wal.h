@@ -0,0 +1,161 @@
+#ifndef TTAK_LOG_WAL_H
+#define TTAK_LOG_WAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Default size at which the active log segment is rotated.
+ */
+#define TTAK_WAL_SEGMENT_BYTES (4 * 1024 * 1024)
+
+/**
+ * @brief Default number of closed segments that triggers a compaction.
+ */
+#define TTAK_WAL_COMPACT_SEGMENTS 4
+
+/**
+ * @brief Tuning knobs for ttak_wal_open. Zero fields take the defaults.
+ */
+typedef struct ttak_wal_options {
+    size_t segment_bytes;       /**< Rotate the active segment past this size. */
+    uint32_t compact_segments;  /**< Closed segments kept before they are folded into the snapshot. */
+} ttak_wal_options_t;
+
+/**
+ * @brief One changed byte range of a commit.
+ */
+typedef struct ttak_wal_range {
+    uint64_t offset;            /**< Offset into the state image. */
+    const void *data;           /**< New bytes; must stay valid until the commit returns. */
+    size_t len;                 /**< Number of bytes. */
+} ttak_wal_range_t;
+
+/**
+ * @brief Counters of one log.
+ */
+typedef struct ttak_wal_stats {
+    uint64_t commits;           /**< Records made durable. */
+    uint64_t syncs;             /**< fdatasync calls issued for them. */
+    uint64_t bytes_logged;      /**< Record bytes appended, headers included. */
+    uint64_t compactions;       /**< Snapshots written. */
+    uint64_t replayed;          /**< Records applied during recovery. */
+    uint64_t durable_lsn;       /**< Highest LSN known to be on disk. */
+} ttak_wal_stats_t;
+
+typedef struct ttak_wal ttak_wal_t;
+
+/**
+ * @brief Opens (and recovers) a durable state image backed by a write-ahead log.
+ *
+ * The state is a flat byte image. @p path holds the last snapshot: a 24-byte
+ * header (magic "SNP1", CRC32C, the LSN of the last record it covers, image
+ * size) followed by the image bytes. Commits since then live in append-only
+ * segments named "<path>.wal.<seq>". Opening loads the snapshot and replays
+ * every intact record above its LSN; a torn record at the tail (from a crash
+ * during an append) is cut off. A file at @p path without the header is
+ * loaded as a bare image at LSN 0.
+ *
+ * The handle holds an exclusive flock on "<path>.lock" until it is closed,
+ * so only one handle per path can be open at a time.
+ *
+ * @param path Snapshot path; segments are created next to it.
+ * @param opts Tuning knobs, or NULL for the defaults.
+ * @return The log, or NULL on I/O or allocation failure (errno EBUSY if
+ *         another handle holds the log).
+ */
+ttak_wal_t *ttak_wal_open(const char *path, const ttak_wal_options_t *opts);
+
+/**
+ * @brief Durably applies a set of byte ranges as one atomic record.
+ *
+ * Concurrent committers are merged: the first thread to find no flush in
+ * progress becomes the leader, appends every queued record with one writev
+ * and covers all of them with a single fdatasync, while the others sleep
+ * until their LSN is durable. The cost of a commit is proportional to the
+ * bytes it changes, not to the size of the state.
+ *
+ * @param wal The log.
+ * @param state_size Size of the image after the commit (growth is zero-filled).
+ * @param ranges Changed ranges; each must lie below @p state_size.
+ * @param count Number of ranges (may be 0 for a pure resize).
+ * @return 0 on success, -1 if the record could not be written or synced.
+ */
+int ttak_wal_commit(ttak_wal_t *wal, uint64_t state_size, const ttak_wal_range_t *ranges, size_t count);
+
+/**
+ * @brief Durably writes @p len bytes at @p offset, growing the image if needed.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int ttak_wal_write(ttak_wal_t *wal, uint64_t offset, const void *data, size_t len);
+
+/**
+ * @brief Copies bytes out of the current state image.
+ *
+ * @return Number of bytes copied (short at the end of the image).
+ */
+size_t ttak_wal_read(ttak_wal_t *wal, uint64_t offset, void *buf, size_t len);
+
+/**
+ * @brief Returns the current size of the state image.
+ */
+uint64_t ttak_wal_size(ttak_wal_t *wal);
+
+/**
+ * @brief Folds all closed segments into a fresh snapshot and deletes them.
+ *
+ * Runs automatically once TTAK_WAL_COMPACT_SEGMENTS segments have been
+ * closed. The snapshot holds only durable records: commits wait while the
+ * queue is flushed and the image copied. It is written to a temporary file,
+ * synced and renamed over @p path, so a crash at any point leaves a
+ * recoverable state.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int ttak_wal_compact(ttak_wal_t *wal);
+
+/**
+ * @brief Copies the log's counters.
+ */
+void ttak_wal_get_stats(ttak_wal_t *wal, ttak_wal_stats_t *out);
+
+/**
+ * @brief Compacts the log into its snapshot, removes the closed segments and frees it.
+ *
+ * Afterwards the snapshot at @p path holds the full state. The last segment
+ * stays on disk; its records are already in the snapshot and the next open
+ * appends to it.
+ */
+void ttak_wal_close(ttak_wal_t *wal);
+
+/**
+ * @brief Persists a state blob through a log keyed by @p filename.
+ *
+ * The first call for a file opens its log; later calls diff @p data against
+ * the last saved image and commit only the changed ranges. Concurrent
+ * callers share fdatasync calls through group commit.
+ *
+ * @p filename is the log's snapshot (see ttak_wal_open for the layout), not
+ * a copy of @p data: it only changes at compaction, and "<filename>.wal.*"
+ * and "<filename>.lock" live next to it. Read the state back with
+ * load_current_progress.
+ */
+void save_current_progress(const char *filename, const void *data, size_t size);
+
+/**
+ * @brief Recovers the state saved with save_current_progress.
+ *
+ * @param filename File passed to save_current_progress.
+ * @param data Destination buffer.
+ * @param size Capacity of @p data.
+ * @return Size of the saved state (may exceed @p size, which truncates the copy).
+ */
+size_t load_current_progress(const char *filename, void *data, size_t size);
+
+/**
+ * @brief Compacts and closes the log of @p filename, leaving the full state in its snapshot.
+ */
+void close_current_progress(const char *filename);
+
+#endif // TTAK_LOG_WAL_H
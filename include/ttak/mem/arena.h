@@ -0,0 +1,128 @@
+#ifndef TTAK_MEM_ARENA_H
+#define TTAK_MEM_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Alignment of every arena allocation.
+ */
+#define TTAK_ARENA_ALIGN 16
+
+/**
+ * @brief Chunk size used when ttak_arena_create is passed 0.
+ */
+#define TTAK_ARENA_DEFAULT_CHUNK (16 * 1024)
+
+/**
+ * @brief Overflow chunk, allocated once the inline region is exhausted.
+ */
+typedef struct ttak_arena_chunk {
+    struct ttak_arena_chunk *next;  /**< Previously filled chunk. */
+    size_t size;                    /**< Usable bytes following the chunk header. */
+} ttak_arena_chunk_t;
+
+/**
+ * @brief Lifetime-scoped bump-pointer arena.
+ *
+ * The arena lives in a single tracked allocation: one header, one registry
+ * entry and one lifetime for every object carved from it. The first chunk is
+ * stored inline behind the arena; later chunks are plain heap blocks owned by
+ * the arena. Objects are never freed individually. ttak_arena_release (or the
+ * registry's cleanup thread and the expiry sweeps, once the lifetime expires)
+ * reclaims the whole arena at once.
+ *
+ * An arena is not thread-safe. An unpinned arena may be reclaimed as soon as
+ * it expires; to guard uses against expiry, pin it with
+ * ttak_mem_access(arena, now) and drop the pin with ttak_mem_unpin.
+ */
+typedef struct ttak_arena {
+    char *cursor;                   /**< Next free byte of the current chunk. */
+    char *limit;                    /**< End of the current chunk. */
+    ttak_arena_chunk_t *chunks;     /**< Overflow chunks, newest first. */
+    char *inline_base;              /**< Start of the inline chunk. */
+    size_t chunk_size;              /**< Size of the inline chunk and minimum overflow chunk. */
+    size_t used;                    /**< Bytes handed out, including alignment padding. */
+} ttak_arena_t;
+
+/**
+ * @brief Creates an arena whose memory expires together.
+ *
+ * @param chunk_size Bytes per chunk (0 for TTAK_ARENA_DEFAULT_CHUNK).
+ * @param lifetime_ticks Lifetime of the whole arena, or __TTAK_UNSAFE_MEM_FOREVER__.
+ * @param now Current tick.
+ * @return The arena, or NULL on allocation failure.
+ */
+ttak_arena_t *ttak_arena_create(size_t chunk_size, uint64_t lifetime_ticks, uint64_t now);
+
+/**
+ * @brief Slow path of ttak_arena_alloc: starts a new chunk.
+ *
+ * @param arena Arena to grow.
+ * @param size Aligned request size.
+ * @return Zeroed memory, or NULL on allocation failure.
+ */
+void *ttak_arena_alloc_slow(ttak_arena_t *arena, size_t size);
+
+/**
+ * @brief Allocates zeroed, 16-byte aligned memory from the arena.
+ *
+ * The fast path is a pointer bump with no header, lock or registry work.
+ *
+ * @param arena Arena to allocate from.
+ * @param size Bytes requested.
+ * @return Pointer valid until the arena is reset or released, or NULL.
+ */
+static inline void *ttak_arena_alloc(ttak_arena_t *arena, size_t size) {
+    if (size > SIZE_MAX - (TTAK_ARENA_ALIGN - 1)) return NULL;
+    size = (size + (TTAK_ARENA_ALIGN - 1)) & ~(size_t)(TTAK_ARENA_ALIGN - 1);
+    if ((size_t)(arena->limit - arena->cursor) < size) {
+        return ttak_arena_alloc_slow(arena, size);
+    }
+    void *ptr = arena->cursor;
+    arena->cursor += size;
+    arena->used += size;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+/**
+ * @brief Drops every object at once, keeping the inline chunk for reuse.
+ *
+ * @param arena Arena to rewind.
+ */
+void ttak_arena_reset(ttak_arena_t *arena);
+
+/**
+ * @brief Releases the arena and every object allocated from it.
+ *
+ * Races with the cleanup thread are settled on the arena's freed bit, so
+ * exactly one of them reclaims it. Releasing past the lifetime is only
+ * safe while the caller holds a pin; the reclaim then waits for the last
+ * ttak_mem_unpin.
+ *
+ * @param arena Arena to release (may be NULL).
+ */
+void ttak_arena_release(ttak_arena_t *arena);
+
+/**
+ * @brief Returns the number of bytes handed out since creation or the last reset.
+ *
+ * @param arena Arena to query.
+ * @return Bytes used, including alignment padding.
+ */
+size_t ttak_arena_used(const ttak_arena_t *arena);
+
+/**
+ * @brief Frees the overflow chunks of an arena.
+ *
+ * Called by the memory subsystem right before the arena's own block is
+ * returned, whichever path (release, cleanup thread, expiry sweep, deferred
+ * unpin) frees it.
+ *
+ * @param arena Arena being reclaimed.
+ */
+void ttak_arena_drop_chunks(ttak_arena_t *arena);
+
+#endif // TTAK_MEM_ARENA_H
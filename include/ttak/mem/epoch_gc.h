@@ -2,54 +2,156 @@
 #define TTAK_MEM_EPOCH_GC_H
 
 #include <ttak/mem_tree/mem_tree.h>
+#include <stdalign.h>
+
+/**
+ * @brief Number of limbo bags kept per thread (epochs e, e-1, e-2).
+ */
+#define TTAK_EPOCH_BAGS 3
+
+/**
+ * @brief Retired blocks per thread before a retire call tries to advance the epoch.
+ */
+#define TTAK_EPOCH_RETIRE_THRESHOLD 64
+
+/**
+ * @brief Cleanup callback invoked once a retired pointer is safe to reclaim.
+ */
+typedef void (*ttak_epoch_cleanup_t)(void *ptr);
+
+/**
+ * @brief A pointer waiting in a limbo bag for its grace period to end.
+ */
+typedef struct ttak_epoch_retired {
+    void *ptr;                          /**< Retired block. */
+    ttak_epoch_cleanup_t cleanup;       /**< Reclaims the block. */
+    uint64_t epoch;                     /**< Global epoch observed at retire time. */
+    struct ttak_epoch_retired *next;    /**< Next entry in the same bag. */
+} ttak_epoch_retired_t;
+
+/**
+ * @brief Per-thread participant record.
+ *
+ * Only the owning thread touches the limbo bags; other threads only read
+ * the announcement word when deciding whether the epoch may advance.
+ */
+typedef struct ttak_epoch_record {
+    alignas(64) _Atomic uint64_t state;             /**< Announced epoch << 1 | active bit. */
+    uint32_t nesting;                               /**< Depth of nested critical sections. */
+    _Bool owned;                                    /**< True while a thread is bound to the record. */
+    pthread_t owner;                                /**< Thread bound to the record. */
+    ttak_epoch_retired_t *limbo[TTAK_EPOCH_BAGS];   /**< Retired blocks bucketed by epoch % 3. */
+    uint64_t limbo_epoch[TTAK_EPOCH_BAGS];          /**< Epoch whose blocks each bag holds. */
+    size_t retired_count;                           /**< Blocks retired since the last advance attempt. */
+    struct ttak_epoch_record *next;                 /**< Next record of the same GC. */
+} ttak_epoch_record_t;
 
 /**
  * @brief Epoch-based garbage collection context.
- * 
- * Manages memory lifecycle using generational epochs.
- * Designed for periodic, non-blocking cleanup where the user triggers the cycle.
- * Traverses the heap tree to identify and free expired blocks without a global stop-the-world pause.
+ *
+ * Readers bracket accesses to shared nodes with ttak_epoch_gc_enter and
+ * ttak_epoch_gc_exit, which only publish the observed epoch in the thread's
+ * record. Writers unlink a node and hand it to ttak_epoch_gc_retire; the node
+ * sits in the retiring thread's limbo bag and is reclaimed once the global
+ * epoch has advanced twice, i.e. after every thread that could still see it
+ * has left its critical section. The epoch only advances when every active
+ * thread has announced the current one, so neither readers nor writers take
+ * a global lock or scan a global list.
+ *
+ * Blocks added with ttak_epoch_gc_register keep their previous semantics and
+ * are swept from the underlying mem tree on every rotation.
  */
 typedef struct ttak_epoch_gc {
-    ttak_mem_tree_t tree;       /**< Underlying memory tree tracking allocations. */
-    uint64_t current_epoch;     /**< Current active epoch ID. */
-    uint64_t last_cleanup_ts;   /**< Timestamp of the last cleanup execution. */
+    ttak_mem_tree_t tree;                   /**< Underlying memory tree tracking registered allocations. */
+    _Atomic uint64_t current_epoch;         /**< Global epoch. */
+    uint64_t last_cleanup_ts;               /**< Timestamp of the last cleanup execution. */
+    uint64_t id;                            /**< Process-unique ID used by the per-thread record cache. */
+    pthread_mutex_t records_lock;           /**< Serializes record binding and the orphan list. */
+    ttak_epoch_record_t *_Atomic records;   /**< Participant records, never unlinked before destroy. */
+    ttak_epoch_retired_t *orphans;          /**< Blocks left behind by unregistered threads. */
 } ttak_epoch_gc_t;
 
 typedef ttak_epoch_gc_t tt_epoch_gc_t;
 
 /**
  * @brief Initializes the Epoch GC.
- * 
+ *
  * @param gc Pointer to the GC structure.
  */
 void ttak_epoch_gc_init(ttak_epoch_gc_t *gc);
 
 /**
  * @brief Destroys the GC context and frees tracked resources.
- * 
+ *
+ * Every retired block is reclaimed; no thread may be inside a critical
+ * section.
+ *
  * @param gc Pointer to the GC structure.
  */
 void ttak_epoch_gc_destroy(ttak_epoch_gc_t *gc);
 
 /**
  * @brief Registers a pointer to be managed by the current epoch.
- * 
+ *
  * @param gc Pointer to the GC structure.
  * @param ptr Pointer to the allocated memory.
  * @param size Size of the memory block.
  */
 void ttak_epoch_gc_register(ttak_epoch_gc_t *gc, void *ptr, size_t size);
 
+/**
+ * @brief Enters a read-side critical section.
+ *
+ * Pointers loaded from shared structures stay valid until the matching
+ * ttak_epoch_gc_exit. Sections nest.
+ *
+ * @param gc Pointer to the GC structure.
+ */
+void ttak_epoch_gc_enter(ttak_epoch_gc_t *gc);
+
+/**
+ * @brief Leaves a read-side critical section.
+ *
+ * @param gc Pointer to the GC structure.
+ */
+void ttak_epoch_gc_exit(ttak_epoch_gc_t *gc);
+
+/**
+ * @brief Defers reclamation of an unlinked block until all readers are done with it.
+ *
+ * @param gc Pointer to the GC structure.
+ * @param ptr Block already unreachable from shared structures.
+ * @param cleanup Reclaim callback, or NULL for ttak_mem_free.
+ */
+void ttak_epoch_gc_retire(ttak_epoch_gc_t *gc, void *ptr, ttak_epoch_cleanup_t cleanup);
+
+/**
+ * @brief Advances the global epoch if every active thread has observed it.
+ *
+ * @param gc Pointer to the GC structure.
+ * @return true if the epoch moved forward.
+ */
+_Bool ttak_epoch_gc_try_advance(ttak_epoch_gc_t *gc);
+
+/**
+ * @brief Unbinds the calling thread from the GC.
+ *
+ * Blocks the thread still has in limbo are handed to the GC and reclaimed by
+ * later rotations. Call before a participating thread exits.
+ *
+ * @param gc Pointer to the GC structure.
+ */
+void ttak_epoch_gc_unregister_thread(ttak_epoch_gc_t *gc);
+
 /**
  * @brief Advances the epoch and triggers a non-blocking cleanup pass.
- * 
- * This should be called periodically by the user. It increments the epoch
- * and traverses the heap tree to free blocks associated with expired epochs
- * (based on configured retention or explicit lifetime).
- * 
+ *
+ * This should be called periodically by the user. It tries to advance the
+ * epoch, reclaims the caller's and orphaned limbo blocks whose grace period
+ * has ended, and sweeps expired registered blocks from the heap tree.
+ *
  * @param gc Pointer to the GC structure.
  */
 void ttak_epoch_gc_rotate(ttak_epoch_gc_t *gc);
 
-#endif // TTAK_MEM_EPOCH_GC_H
\ No newline at end of file
+#endif // TTAK_MEM_EPOCH_GC_H
@@ -0,0 +1,137 @@
+#ifndef TTAK_MEM_GENERATION_H
+#define TTAK_MEM_GENERATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Size and alignment of a generation segment.
+ */
+#define TTAK_GEN_SEGMENT_SIZE (2UL * 1024 * 1024)
+
+/**
+ * @brief Largest block carved from a generation; bigger blocks take the regular path.
+ */
+#define TTAK_GEN_MAX_BLOCK (TTAK_GEN_SEGMENT_SIZE / 8)
+
+/**
+ * @brief Segments in the address range reserved for generations.
+ *
+ * Reclaimed segments are reused, so this bounds the generational bytes live
+ * at once (1 TB on 64-bit targets). While every segment is in use,
+ * allocations take the regular path; ttak_gen_stats_t.exhausted counts them
+ * and the first one is reported on stderr.
+ */
+#define TTAK_GEN_MAX_SEGMENTS (sizeof(void *) >= 8 ? (1U << 19) : 64U)
+
+/**
+ * @brief Narrowest generation bucket, in ticks.
+ */
+#define TTAK_GEN_MIN_WIDTH 16
+
+/**
+ * @brief A bucket spans at most 1 / 2^TTAK_GEN_SLACK_SHIFT of the lifetime it serves.
+ */
+#define TTAK_GEN_SLACK_SHIFT 3
+
+/**
+ * @brief Snapshot of the generation manager.
+ */
+typedef struct ttak_gen_stats {
+    size_t generations;                 /**< Generations currently open. */
+    size_t segments;                    /**< Segments mapped for them. */
+    size_t live_blocks;                 /**< Blocks handed out and neither freed nor reclaimed. */
+    uint64_t reclaimed_generations;     /**< Generations dropped at their deadline. */
+    uint64_t reclaimed_segments;        /**< Segments unmapped by those drops. */
+    uint64_t reclaimed_blocks;          /**< Blocks that were still live when their generation was dropped. */
+    uint64_t reused_segments;           /**< Reclaimed segments handed to a later generation. */
+    uint64_t exhausted;                 /**< Segment requests refused because every segment was in use. */
+} ttak_gen_stats_t;
+
+/**
+ * @brief Rounds an expiry up to the deadline of its generation bucket.
+ *
+ * The bucket width is the largest power of two not above
+ * @p lifetime_ticks >> TTAK_GEN_SLACK_SHIFT (at least TTAK_GEN_MIN_WIDTH),
+ * so a block outlives its own expiry by at most about 1/8 of its lifetime
+ * and allocations with similar lifetimes share a generation.
+ *
+ * @param expires_tick Expiry of the block.
+ * @param lifetime_ticks Lifetime the block was allocated with.
+ * @return The generation deadline, or 0 if it would overflow.
+ */
+uint64_t ttak_gen_deadline(uint64_t expires_tick, uint64_t lifetime_ticks);
+
+/**
+ * @brief Bump-allocates a 64-byte aligned block from the generation of @p deadline.
+ *
+ * Generations are carved from TTAK_GEN_SEGMENT_SIZE segments of one address
+ * range reserved up front, so a generation costs one mprotect per segment it
+ * fills and nothing per block.
+ *
+ * The block is returned with its segment pinned; call ttak_gen_unpin once
+ * it is initialized.
+ *
+ * @param size Bytes required (at most TTAK_GEN_MAX_BLOCK).
+ * @param deadline Value from ttak_gen_deadline.
+ * @return Block pointer (zeroed on first use of its pages), or NULL if the
+ *         block is too large or no segment is available.
+ */
+void *ttak_gen_alloc(size_t size, uint64_t deadline);
+
+/**
+ * @brief Drops an individually freed block from its generation's accounting.
+ *
+ * The memory itself is only returned when the whole generation is reclaimed.
+ *
+ * @param ptr Block from ttak_gen_alloc.
+ * @param size The size passed to ttak_gen_alloc.
+ */
+void ttak_gen_release(const void *ptr, size_t size);
+
+/**
+ * @brief Remembers a profiler-sampled block so reclaiming its generation reports the free.
+ */
+void ttak_gen_note_sampled(const void *ptr);
+
+/**
+ * @brief Returns whether @p ptr lies in the generation address range.
+ */
+_Bool ttak_gen_contains(const void *ptr);
+
+/**
+ * @brief Pins the segment holding @p ptr so it cannot be reclaimed.
+ *
+ * Only the segment descriptor is touched, never the segment memory, so this
+ * is safe on pointers into generations that were already reclaimed. Such a
+ * pin fails until the segment is handed to a later generation.
+ *
+ * @return true if the segment belongs to a live generation and is now pinned.
+ */
+_Bool ttak_gen_pin(const void *ptr);
+
+/**
+ * @brief Releases a pin taken by ttak_gen_pin.
+ */
+void ttak_gen_unpin(const void *ptr);
+
+/**
+ * @brief Unmaps every generation whose deadline lies before @p now.
+ *
+ * A generation is only dropped while none of its segments is pinned; each
+ * segment is then released with a single mapping call regardless of how
+ * many blocks it held.
+ *
+ * @param now Current timestamp.
+ * @return Bytes of blocks that were still live (never freed) when dropped.
+ */
+size_t ttak_gen_reclaim(uint64_t now);
+
+/**
+ * @brief Copies the manager's counters.
+ *
+ * @param out Destination.
+ */
+void ttak_gen_get_stats(ttak_gen_stats_t *out);
+
+#endif // TTAK_MEM_GENERATION_H
@@ -0,0 +1,146 @@
+#ifndef TTAK_MEM_HAZARD_H
+#define TTAK_MEM_HAZARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/**
+ * @brief Hazard slots available to each thread.
+ *
+ * Enough for hand-over-hand traversal of a list (previous, current, next)
+ * plus one spare.
+ */
+#define TTAK_HAZARD_SLOTS 4
+
+/**
+ * @brief Minimum number of retired blocks a thread holds before it scans.
+ */
+#define TTAK_HAZARD_MIN_SCAN 32
+
+/**
+ * @brief Cleanup callback invoked once no hazard slot protects a retired pointer.
+ */
+typedef void (*ttak_hazard_cleanup_t)(void *ptr);
+
+/**
+ * @brief A pointer waiting for its last hazard to be cleared.
+ */
+typedef struct ttak_hazard_retired {
+    void *ptr;                          /**< Retired block. */
+    ttak_hazard_cleanup_t cleanup;      /**< Reclaims the block. */
+    struct ttak_hazard_retired *next;   /**< Next retired block of the same thread. */
+} ttak_hazard_retired_t;
+
+/**
+ * @brief Per-thread hazard record.
+ *
+ * The slots are read by every scanning thread; the retired list is private
+ * to the owner.
+ */
+typedef struct ttak_hazard_record {
+    alignas(64) void *_Atomic slots[TTAK_HAZARD_SLOTS]; /**< Published hazard pointers. */
+    _Bool owned;                                        /**< True while a thread is bound to the record. */
+    pthread_t owner;                                    /**< Thread bound to the record. */
+    ttak_hazard_retired_t *retired;                     /**< Blocks retired by the owner. */
+    size_t retired_count;                               /**< Length of the retired list. */
+    struct ttak_hazard_record *next;                    /**< Next record of the same domain. */
+} ttak_hazard_record_t;
+
+/**
+ * @brief Hazard-pointer reclamation domain.
+ *
+ * A reader publishes each shared pointer it is about to dereference in one
+ * of its hazard slots. A writer retires unlinked blocks; once a thread's
+ * retired list reaches twice the number of published slots, it scans all
+ * slots and reclaims every block nobody protects. Unlike epoch GC, a stalled
+ * reader only pins the few blocks in its own slots, so unreclaimed memory
+ * per thread stays bounded by O(threads * TTAK_HAZARD_SLOTS).
+ */
+typedef struct ttak_hazard_domain {
+    uint64_t id;                            /**< Process-unique ID used by the per-thread record cache. */
+    pthread_mutex_t records_lock;           /**< Serializes record binding and the orphan list. */
+    ttak_hazard_record_t *_Atomic records;  /**< Hazard records, never unlinked before destroy. */
+    _Atomic size_t record_count;            /**< Number of records ever created. */
+    ttak_hazard_retired_t *orphans;         /**< Blocks left behind by unregistered threads. */
+} ttak_hazard_domain_t;
+
+/**
+ * @brief Initializes a hazard-pointer domain.
+ *
+ * @param dom Pointer to the domain.
+ */
+void ttak_hazard_domain_init(ttak_hazard_domain_t *dom);
+
+/**
+ * @brief Destroys the domain, reclaiming every retired block.
+ *
+ * No thread may still hold hazards in the domain.
+ *
+ * @param dom Pointer to the domain.
+ */
+void ttak_hazard_domain_destroy(ttak_hazard_domain_t *dom);
+
+/**
+ * @brief Loads a shared pointer and protects it in a hazard slot.
+ *
+ * Re-reads @p src after publishing until the value is stable, so the
+ * returned pointer cannot have been retired and reclaimed in between.
+ *
+ * @param dom Pointer to the domain.
+ * @param slot Hazard slot index (0 .. TTAK_HAZARD_SLOTS - 1).
+ * @param src Shared location holding the pointer.
+ * @return The protected pointer (may be NULL).
+ */
+void *ttak_hazard_protect(ttak_hazard_domain_t *dom, int slot, void *_Atomic *src);
+
+/**
+ * @brief Publishes a pointer the caller already knows to be live.
+ *
+ * @param dom Pointer to the domain.
+ * @param slot Hazard slot index.
+ * @param ptr Pointer to protect, or NULL to clear the slot.
+ */
+void ttak_hazard_set(ttak_hazard_domain_t *dom, int slot, void *ptr);
+
+/**
+ * @brief Clears a hazard slot.
+ *
+ * @param dom Pointer to the domain.
+ * @param slot Hazard slot index.
+ */
+void ttak_hazard_clear(ttak_hazard_domain_t *dom, int slot);
+
+/**
+ * @brief Defers reclamation of an unlinked block until no hazard protects it.
+ *
+ * @param dom Pointer to the domain.
+ * @param ptr Block already unreachable from shared structures.
+ * @param cleanup Reclaim callback, or NULL for ttak_mem_free.
+ */
+void ttak_hazard_retire(ttak_hazard_domain_t *dom, void *ptr, ttak_hazard_cleanup_t cleanup);
+
+/**
+ * @brief Reclaims the caller's retired blocks that no hazard slot protects.
+ *
+ * Also adopts blocks orphaned by unregistered threads.
+ *
+ * @param dom Pointer to the domain.
+ * @return Number of blocks reclaimed.
+ */
+size_t ttak_hazard_scan(ttak_hazard_domain_t *dom);
+
+/**
+ * @brief Clears the caller's slots and unbinds it from the domain.
+ *
+ * Retired blocks that are still protected are handed to the domain and
+ * reclaimed by a later scan. Call before a participating thread exits.
+ *
+ * @param dom Pointer to the domain.
+ */
+void ttak_hazard_unregister_thread(ttak_hazard_domain_t *dom);
+
+#endif // TTAK_MEM_HAZARD_H
@@ -0,0 +1,97 @@
+#ifndef TTAK_MEM_HUGE_H
+#define TTAK_MEM_HUGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Size and alignment of a shared huge-page region (one 2 MB page).
+ */
+#define TTAK_HUGE_REGION_SIZE (2UL * 1024 * 1024)
+
+/**
+ * @brief Largest block carved from a shared region; bigger blocks get their own mapping.
+ */
+#define TTAK_HUGE_MAX_CARVE (TTAK_HUGE_REGION_SIZE / 4)
+
+/**
+ * @brief Allocation size from which callers should ask for TTAK_MEM_HUGE_PAGES.
+ */
+#define TTAK_HUGE_HINT_MIN (64 * 1024)
+
+/**
+ * @brief Page backing obtained for a region or dedicated mapping.
+ */
+typedef enum {
+    TTAK_HUGE_BACKING_NONE = 0,     /** Regular pages (THP advice was rejected) */
+    TTAK_HUGE_BACKING_HUGETLB = 1,  /** Reserved hugetlbfs pages via MAP_HUGETLB */
+    TTAK_HUGE_BACKING_THP = 2       /** Transparent huge pages via MADV_HUGEPAGE */
+} ttak_huge_backing_t;
+
+/**
+ * @brief Snapshot of the huge-page manager.
+ */
+typedef struct ttak_huge_stats {
+    size_t regions[3];      /**< Mapped shared regions, indexed by ttak_huge_backing_t. */
+    size_t dedicated[3];    /**< Dedicated large mappings, indexed by ttak_huge_backing_t. */
+    size_t live_blocks;     /**< Blocks currently handed out. */
+    size_t mapped_bytes;    /**< Bytes mapped for regions and dedicated blocks. */
+} ttak_huge_stats_t;
+
+/**
+ * @brief Allocates a 64-byte aligned block backed by huge pages.
+ *
+ * Blocks up to TTAK_HUGE_MAX_CARVE are carved from shared 2 MB regions, so
+ * only the first block of a region costs a syscall. Each region tries
+ * MAP_HUGETLB first and falls back to a 2 MB aligned anonymous mapping
+ * advised with MADV_HUGEPAGE. Larger blocks get a dedicated mapping with the
+ * same fallback.
+ *
+ * @param size Bytes required.
+ * @return Block pointer (not zeroed), or NULL if no mapping could be created.
+ */
+void *ttak_huge_alloc(size_t size);
+
+/**
+ * @brief Returns a block to the manager.
+ *
+ * A region is recycled once its last block is freed.
+ *
+ * @param ptr Block from ttak_huge_alloc.
+ * @param size The size passed to ttak_huge_alloc.
+ */
+void ttak_huge_free(void *ptr, size_t size);
+
+/**
+ * @brief Resizes a block without moving it.
+ *
+ * A carved block grows only while it is the last block of the active region
+ * (and gives back its tail when it shrinks there); any carved block can
+ * shrink or use its 64-byte rounding slack. A dedicated mapping uses its
+ * 2 MB rounding slack, and otherwise grows with mremap without
+ * MREMAP_MAYMOVE. Blocks never switch between carved and dedicated.
+ *
+ * @param ptr Block from ttak_huge_alloc.
+ * @param old_size The size the block currently has.
+ * @param new_size Requested size.
+ * @return true if the block now holds @p new_size bytes at the same address.
+ */
+_Bool ttak_huge_resize(void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Reports the backing of the region or mapping holding a block.
+ *
+ * @param ptr Block from ttak_huge_alloc.
+ * @param size The size passed to ttak_huge_alloc.
+ * @return The backing kind.
+ */
+ttak_huge_backing_t ttak_huge_backing_of(const void *ptr, size_t size);
+
+/**
+ * @brief Copies the manager's counters.
+ *
+ * @param out Destination.
+ */
+void ttak_huge_get_stats(ttak_huge_stats_t *out);
+
+#endif // TTAK_MEM_HUGE_H
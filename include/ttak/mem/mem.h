@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <ttak/mem_tree/mem_tree.h>
 
 /**
  * @brief Alignment for cache-line optimization (64-byte).
@@ -22,9 +23,19 @@ typedef enum {
     TTAK_MEM_DEFAULT = 0,
     TTAK_MEM_HUGE_PAGES = (1 << 0), /** Try to use 2MB/1GB pages */
     TTAK_MEM_CACHE_ALIGNED = (1 << 1), /** Force 64-byte alignment */
-    TTAK_MEM_STRICT_CHECK = (1 << 2) /** Enable strict memory boundary checks */
+    TTAK_MEM_STRICT_CHECK = (1 << 2), /** Enable strict memory boundary checks */
+    TTAK_MEM_GENERATIONAL = (1 << 3), /** Carve from the lifetime generation of the block's expiry */
+    TTAK_MEM_NO_GENERATION = (1 << 4) /** Never carve from a generation (blocks that own other memory) */
 } ttak_mem_flags_t;
 
+/**
+ * @brief Validation strategy used by ttak_mem_access.
+ */
+typedef enum {
+    TTAK_MEM_ACCESS_ATOMIC = 0, /** Validate and pin with one acquire load and CAS on the header state word */
+    TTAK_MEM_ACCESS_LOCKED = 1  /** Validate and pin under the per-header mutex */
+} ttak_mem_access_mode_t;
+
 /**
  * @brief Unified memory allocation with lifecycle management and hardware optimization.
  */
@@ -37,14 +48,93 @@ void *ttak_mem_realloc_safe(void *ptr, size_t new_size, uint64_t lifetime_ticks,
 
 /**
  * @brief Accesses the memory block, verifying its lifecycle and security.
+ *
+ * On success the block is pinned; release it with ttak_mem_unpin.
  */
 void *ttak_mem_access(void *ptr, uint64_t now);
 
+/**
+ * @brief Releases a pin taken by ttak_mem_access.
+ *
+ * If the block was freed while pinned, the last unpin reclaims it.
+ */
+void ttak_mem_unpin(void *ptr);
+
+/**
+ * @brief Returns the number of freed blocks still waiting for readers to unpin.
+ */
+size_t ttak_mem_deferred_count(void);
+
+/**
+ * @brief Selects how ttak_mem_access validates allocations.
+ *
+ * Both modes apply the same freed/expiry/pin rules to the same state word;
+ * TTAK_MEM_ACCESS_LOCKED additionally serializes accesses per header.
+ */
+void ttak_mem_set_access_mode(ttak_mem_access_mode_t mode);
+
+/**
+ * @brief Returns the current ttak_mem_access validation mode.
+ */
+ttak_mem_access_mode_t ttak_mem_get_access_mode(void);
+
+/**
+ * @brief Routes every finite-lifetime allocation into lifetime generations.
+ *
+ * With the mode on, blocks up to TTAK_GEN_MAX_BLOCK that do not ask for
+ * TTAK_MEM_HUGE_PAGES or TTAK_MEM_NO_GENERATION behave as if they passed
+ * TTAK_MEM_GENERATIONAL: they are bump-carved from the generation whose
+ * bucket covers their expiry, stay out of the global registry, and are
+ * unmapped together once the generation's deadline has passed and no reader
+ * pins it (see ttak/mem/generation.h). ttak_mem_free still works on them but
+ * only updates the accounting.
+ */
+void ttak_mem_set_generational(int enable);
+
+/**
+ * @brief Returns whether generational routing is on.
+ */
+int ttak_mem_is_generational(void);
+
 /**
  * @brief Frees the memory block and removes it from the global shadow map.
  */
 void ttak_mem_free(void *ptr);
 
+/**
+ * @brief Allocates several tracked blocks, registering them with one registry splice.
+ *
+ * Blocks are allocated like ttak_mem_alloc_with_flags and share one lifetime.
+ * Either every block is allocated or none is.
+ *
+ * @return true on success, false (with @p out cleared) on failure.
+ */
+bool ttak_mem_alloc_batch(void **out, const size_t *sizes, size_t count, uint64_t lifetime_ticks, uint64_t now, ttak_mem_flags_t flags);
+
+/**
+ * @brief Frees several blocks, unregistering them with one registry splice.
+ *
+ * Each block follows the ttak_mem_free rules; NULL entries are skipped.
+ */
+void ttak_mem_free_batch(void *const *ptrs, size_t count);
+
+/**
+ * @brief Claims an expired, unreferenced block for the registry's cleanup pass.
+ *
+ * Sets the block's freed bit only if it is neither freed nor pinned, so a
+ * concurrent ttak_mem_free or a reader's pin keeps it out of the pass.
+ * Called with the block's registry shard locked.
+ *
+ * @return true if the caller owns the block and must unlink its node and
+ *         pass it to ttak_mem_reap.
+ */
+_Bool ttak_mem_try_claim(void *ptr);
+
+/**
+ * @brief Releases a block claimed by ttak_mem_try_claim whose registry node is unlinked.
+ */
+void ttak_mem_reap(void *ptr);
+
 /**
  * @brief Inspects and returns pointers that are expired or have abnormal access counts.
  */
@@ -52,9 +142,45 @@ void **tt_inspect_dirty_pointers(uint64_t now, size_t *count_out);
 
 /**
  * @brief Automatically cleans up expired memory blocks with adaptive scheduling.
+ *
+ * Generations whose deadline lies before @p now are unmapped first.
  */
 void tt_autoclean_dirty_pointers(uint64_t now);
 
+/**
+ * @brief Resumable position of an incremental dirty-pointer sweep.
+ */
+typedef ttak_mem_tree_cursor_t ttak_mem_sweep_cursor_t;
+
+/**
+ * @brief Frees dirty roots incrementally within a node and time budget.
+ *
+ * Each call resumes at @p cursor, examines at most @p max_nodes due nodes
+ * (locking one registry shard per slice) and stops early once @p max_ns has
+ * elapsed or every shard has been visited. Zero disables a budget.
+ *
+ * @return Number of allocations freed.
+ */
+size_t tt_sweep_dirty_pointers(ttak_mem_sweep_cursor_t *cursor, uint64_t now, size_t max_nodes, uint64_t max_ns);
+
+/**
+ * @brief Starts or shares the background thread that runs tt_sweep_dirty_pointers.
+ *
+ * Reference counted: pair every successful call with ttak_mem_sweeper_stop.
+ * A later call replaces the budget of the running sweeper.
+ *
+ * @param interval_ns Pause between steps (0 for the 10 ms default).
+ * @param max_nodes Due nodes examined per step (0 for no limit).
+ * @param max_ns Time budget per step (0 for no limit).
+ * @return true if the sweeper is running.
+ */
+bool ttak_mem_sweeper_start(uint64_t interval_ns, size_t max_nodes, uint64_t max_ns);
+
+/**
+ * @brief Releases one sweeper reference; the last release joins the thread.
+ */
+void ttak_mem_sweeper_stop(void);
+
 /**
  * @brief Configures the global background GC (mem_tree) parameters.
  */
@@ -67,6 +193,9 @@ void **tt_autoclean_and_inspect(uint64_t now, size_t *count_out);
 
 /**
  * @brief Sets the global memory tracing flag.
+ *
+ * Events are recorded in per-thread binary rings and drained by a background
+ * thread (see ttak/mem/trace.h for the output and decoder).
  */
 void ttak_mem_set_trace(int enable);
 
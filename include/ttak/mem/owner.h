@@ -3,8 +3,10 @@
 
 #include <ttak/ht/map.h>
 #include <ttak/sync/sync.h>
+#include <ttak/mem/arena.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdatomic.h>
 
 /**
  * @brief Function pointer type for tasks executed within the owner's context.
@@ -14,6 +16,18 @@
  */
 typedef void (*ttak_owner_func_t)(void *ctx, void *args);
 
+/**
+ * @brief Destructor hook run for a resource when its owner is destroyed.
+ *
+ * @param data The registered resource pointer.
+ */
+typedef void (*ttak_owner_dtor_t)(void *data);
+
+/**
+ * @brief Arena chunk size of owners made by ttak_owner_create.
+ */
+#define TTAK_OWNER_DEFAULT_ARENA_CHUNK 4096
+
 /**
  * @brief Configuration flags for the owner's safety policy.
  */
@@ -24,18 +38,68 @@ typedef enum {
     TTAK_OWNER_STRICT_ISOLATION = (1 << 2)    /**< Enforce strict data isolation (no external pointer access). */
 } ttak_owner_policy_t;
 
+/**
+ * @brief Stable index of a registered function or resource.
+ *
+ * Handles are per owner and per kind. A name keeps its handle for the
+ * lifetime of the owner, even if its resource is transferred away and back.
+ */
+typedef uint32_t ttak_owner_handle_t;
+
+/**
+ * @brief Handle value that never names an entry.
+ */
+#define TTAK_OWNER_INVALID_HANDLE 0
+
+/**
+ * @brief Entries per slot chunk, and the chunk limit of one table.
+ */
+#define TTAK_OWNER_CHUNK_SLOTS 64
+#define TTAK_OWNER_MAX_CHUNKS 64
+
+/**
+ * @brief One named entry. Slots never move once published.
+ */
+typedef struct ttak_owner_slot {
+    _Atomic uintptr_t value;    /**< Function pointer or resource data. */
+    _Atomic _Bool live;         /**< Cleared when a resource is transferred away. */
+    char *name;                 /**< Copy of the registered name, in the owner's arena. */
+    ttak_owner_handle_t next;   /**< Next handle whose name has the same hash. */
+    ttak_owner_dtor_t dtor;     /**< Resource destructor, or NULL. */
+    size_t arena_size;          /**< Bytes if the resource lives in the owner's arena, else 0. */
+} ttak_owner_slot_t;
+
+/**
+ * @brief Name-indexed table of slots.
+ *
+ * Registration happens under the owner's write lock. Lookups by handle only
+ * read the published chunk pointers and the slot count, so they need no lock.
+ */
+typedef struct ttak_owner_table {
+    ttak_map_t *index;          /**< Name hash -> most recent handle with that hash. */
+    ttak_owner_slot_t *_Atomic chunks[TTAK_OWNER_MAX_CHUNKS];
+    _Atomic uint32_t count;     /**< Published slots; handles are 1..count. */
+} ttak_owner_table_t;
+
 /**
  * @brief The Owner structure.
  * 
  * Acts as a sandbox/container for resources and functions.
  * Ensures isolation and enforces safety policies.
+ *
+ * Everything the owner allocates (names, slot tables and memory from
+ * ttak_owner_alloc) is carved from one arena, so destroying the owner
+ * releases it in a single step instead of object by object.
  */
 typedef struct ttak_owner {
-    ttak_map_t *resources;      /**< Map storing owned resources (isolated variables). */
-    ttak_map_t *functions;      /**< Map storing registered functions. */
+    ttak_owner_table_t resources;   /**< Owned resources (isolated variables). */
+    ttak_owner_table_t functions;   /**< Registered functions. */
     ttak_rwlock_t lock;         /**< RWLock for thread-safe access to the owner's state. */
     uint64_t creation_ts;       /**< Timestamp when this owner was created. */
     uint32_t policy_flags;      /**< Safety policy bitmask. */
+    ttak_arena_t *arena;        /**< Backing memory of the owner. */
+    ttak_mutex_t arena_lock;    /**< Serializes bumps of the (single-threaded) arena. */
+    uint32_t dtor_count;        /**< Live resources with a destructor. */
 } ttak_owner_t;
 
 typedef ttak_owner_t tt_owner_t;
@@ -48,8 +112,22 @@ typedef ttak_owner_t tt_owner_t;
  */
 ttak_owner_t *ttak_owner_create(uint32_t policy);
 
+/**
+ * @brief Creates a new Owner context with a sized arena.
+ *
+ * @param policy Safety policy flags.
+ * @param arena_chunk Bytes per arena chunk (0 for TTAK_OWNER_DEFAULT_ARENA_CHUNK).
+ * @return Pointer to the initialized owner, or NULL on failure.
+ */
+ttak_owner_t *ttak_owner_create_sized(uint32_t policy, size_t arena_chunk);
+
 /**
  * @brief Destroys the Owner and releases all registered resources.
+ *
+ * Destructor hooks run first, newest resource first; they must not call back
+ * into @p owner. The arena, and with it every allocation made through the
+ * owner, is then released at once. Only resources with a hook cost anything
+ * per object.
  * 
  * @param owner The owner to destroy.
  */
@@ -77,13 +155,68 @@ bool ttak_owner_register_func(ttak_owner_t *owner, const char *name, ttak_owner_
  */
 bool ttak_owner_register_resource(ttak_owner_t *owner, const char *name, void *data);
 
+/**
+ * @brief Registers a resource together with a destructor hook.
+ *
+ * @param owner The owner context.
+ * @param name Unique name for the resource.
+ * @param data Pointer to the data.
+ * @param dtor Called with @p data when the owner is destroyed (may be NULL).
+ * @return true if registered successfully.
+ */
+bool ttak_owner_register_resource_dtor(ttak_owner_t *owner, const char *name, void *data, ttak_owner_dtor_t dtor);
+
+/**
+ * @brief Allocates zeroed memory from the owner's arena.
+ *
+ * The memory lives exactly as long as the owner; it is never freed on its own.
+ *
+ * @param owner The owner context.
+ * @param size Bytes requested.
+ * @return 16-byte aligned memory, or NULL.
+ */
+void *ttak_owner_alloc(ttak_owner_t *owner, size_t size);
+
+/**
+ * @brief Allocates a resource in the owner's arena and registers it.
+ *
+ * @param owner The owner context.
+ * @param name Unique name for the resource.
+ * @param size Bytes requested.
+ * @param dtor Optional destructor hook (for handles the object holds; the memory itself goes with the arena).
+ * @return The zeroed resource, or NULL.
+ */
+void *ttak_owner_alloc_resource(ttak_owner_t *owner, const char *name, size_t size, ttak_owner_dtor_t dtor);
+
+/**
+ * @brief Registers @p child as a resource of @p parent.
+ *
+ * The parent destroys the child when it is destroyed, and transferring the
+ * child's name to another owner moves the whole child owner, all of its
+ * resources and arena included, in O(1).
+ *
+ * @return true if registered successfully.
+ */
+bool ttak_owner_adopt(ttak_owner_t *parent, const char *name, ttak_owner_t *child);
+
 /**
  * @brief Transfers a resource from one owner to another.
+ *
+ * The destructor hook moves with the resource. Resources that live in the
+ * source owner's arena (ttak_owner_alloc_resource) cannot be transferred and
+ * are refused; to hand over arena-resident state, allocate it in a child
+ * owner, ttak_owner_adopt that owner and transfer the child's name instead.
+ *
+ * @return true if the resource now belongs to @p to.
  */
 bool ttak_owner_transfer_resource(ttak_owner_t *from, ttak_owner_t *to, const char *name);
 
 /**
  * @brief Executes a registered function within the owner's safety context.
+ *
+ * Resolves both names on every call; hot paths should resolve handles once
+ * with ttak_owner_resolve_func / ttak_owner_resolve_resource and call
+ * ttak_owner_execute_handle instead.
  * 
  * @param owner The owner context.
  * @param func_name Name of the function to execute.
@@ -93,4 +226,38 @@ bool ttak_owner_transfer_resource(ttak_owner_t *from, ttak_owner_t *to, const ch
  */
 bool ttak_owner_execute(ttak_owner_t *owner, const char *func_name, const char *resource_name, void *args);
 
+/**
+ * @brief Looks up the handle of a registered function.
+ *
+ * @param owner The owner context.
+ * @param name Name passed to ttak_owner_register_func.
+ * @return The handle, or TTAK_OWNER_INVALID_HANDLE if the name is unknown.
+ */
+ttak_owner_handle_t ttak_owner_resolve_func(ttak_owner_t *owner, const char *name);
+
+/**
+ * @brief Looks up the handle of a resource name that was registered with this owner.
+ *
+ * @param owner The owner context.
+ * @param name Name passed to ttak_owner_register_resource.
+ * @return The handle, or TTAK_OWNER_INVALID_HANDLE if the name is unknown.
+ */
+ttak_owner_handle_t ttak_owner_resolve_resource(ttak_owner_t *owner, const char *name);
+
+/**
+ * @brief Executes a function by handle.
+ *
+ * Costs a bounds check and an indirect call; no lock is held while the
+ * function runs, so it may call back into the same owner.
+ *
+ * @param owner The owner context.
+ * @param func Handle from ttak_owner_resolve_func.
+ * @param resource Handle from ttak_owner_resolve_resource, or TTAK_OWNER_INVALID_HANDLE
+ *                 for no context. A resource that was transferred away is passed as NULL.
+ * @param args Runtime arguments to pass to the function.
+ * @return true if the function was found and executed.
+ */
+bool ttak_owner_execute_handle(ttak_owner_t *owner, ttak_owner_handle_t func,
+                               ttak_owner_handle_t resource, void *args);
+
 #endif // TTAK_MEM_OWNER_H
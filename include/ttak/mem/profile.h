@@ -0,0 +1,122 @@
+#ifndef TTAK_MEM_PROFILE_H
+#define TTAK_MEM_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Default mean distance between samples, in allocated bytes.
+ */
+#define TTAK_PROFILE_DEFAULT_INTERVAL (512 * 1024)
+
+/**
+ * @brief Return addresses kept per sampled call site.
+ */
+#define TTAK_PROFILE_MAX_DEPTH 16
+
+/**
+ * @brief Lifetime hint buckets used to split live bytes.
+ */
+typedef enum {
+    TTAK_PROFILE_LIFETIME_SHORT = 0,    /** Up to 100 ticks */
+    TTAK_PROFILE_LIFETIME_MEDIUM = 1,   /** Up to 10000 ticks */
+    TTAK_PROFILE_LIFETIME_LONG = 2,     /** Longer, but finite */
+    TTAK_PROFILE_LIFETIME_FOREVER = 3,  /** __TTAK_UNSAFE_MEM_FOREVER__ */
+    TTAK_PROFILE_LIFETIME_BUCKETS = 4
+} ttak_profile_lifetime_t;
+
+/**
+ * @brief Aggregate view of the profile.
+ */
+typedef struct ttak_profile_stats {
+    uint64_t live_bytes[TTAK_PROFILE_LIFETIME_BUCKETS];    /**< Estimated live bytes per lifetime bucket. */
+    uint64_t live_samples;      /**< Sampled blocks not yet freed. */
+    uint64_t total_samples;     /**< Samples taken since the last reset. */
+    size_t sites;               /**< Distinct call sites seen. */
+} ttak_profile_stats_t;
+
+/**
+ * @brief Starts sampling tracked allocations.
+ *
+ * Each thread counts allocated bytes down from an exponentially distributed
+ * interval with mean @p sample_interval; the allocation that crosses zero is
+ * sampled. A sample records a short backtrace and the lifetime hint, and is
+ * weighted so that the summed weights estimate the real live bytes (the same
+ * scheme as tcmalloc's heap profiler).
+ *
+ * @param sample_interval Mean bytes between samples (0 for the default).
+ */
+void ttak_profile_start(size_t sample_interval);
+
+/**
+ * @brief Stops taking new samples. Already sampled blocks are still tracked until freed.
+ */
+void ttak_profile_stop(void);
+
+/**
+ * @brief Returns whether sampling is on.
+ */
+int ttak_profile_is_enabled(void);
+
+/**
+ * @brief Drops every call site and sample.
+ */
+void ttak_profile_reset(void);
+
+/**
+ * @brief Copies the aggregate counters.
+ *
+ * @param out Destination.
+ */
+void ttak_profile_get_stats(ttak_profile_stats_t *out);
+
+/**
+ * @brief Writes live bytes per call site as folded stacks.
+ *
+ * One line per call site and lifetime bucket, root frame first:
+ * "lifetime=forever;main;build_index;0x4011a3 1048576". The output feeds
+ * flamegraph.pl, speedscope or `pprof -raw`-style tooling directly. Frames
+ * are symbol names where the dynamic symbol table has them, and
+ * "module+0xoffset" otherwise (resolve with addr2line).
+ *
+ * @param out Text output.
+ * @return Number of lines written.
+ */
+long ttak_profile_dump_folded(FILE *out);
+
+/**
+ * @brief Allocation hook: advances the calling thread's byte countdown.
+ *
+ * @param size Bytes being allocated.
+ * @return Non-zero if this allocation should be recorded.
+ */
+int ttak_profile_should_sample(size_t size);
+
+/**
+ * @brief Allocation hook: records a sampled block.
+ *
+ * @param ptr User pointer of the block.
+ * @param size Requested bytes.
+ * @param lifetime_ticks Lifetime hint of the allocation.
+ * @return Non-zero if the sample was stored.
+ */
+int ttak_profile_record_alloc(const void *ptr, size_t size, uint64_t lifetime_ticks);
+
+/**
+ * @brief Free hook: removes a sampled block from its call site's live bytes.
+ *
+ * @param ptr User pointer of the block.
+ */
+void ttak_profile_record_free(const void *ptr);
+
+/**
+ * @brief Resize hook: re-weights a sampled block resized in place.
+ *
+ * @param ptr User pointer of the block.
+ * @param new_size New requested bytes.
+ * @param lifetime_ticks New lifetime hint of the block.
+ */
+void ttak_profile_record_resize(const void *ptr, size_t new_size, uint64_t lifetime_ticks);
+
+#endif // TTAK_MEM_PROFILE_H
@@ -0,0 +1,60 @@
+#ifndef TTAK_MEM_SLAB_H
+#define TTAK_MEM_SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Size of a slab span.
+ *
+ * Spans are aligned to their own size, so the span owning any block can be
+ * recovered by masking the block address.
+ */
+#define TTAK_SLAB_SPAN_SIZE (64 * 1024)
+
+/**
+ * @brief Largest block (header + payload + canary) served by the slab backend.
+ */
+#define TTAK_SLAB_MAX_BLOCK 4096
+
+/**
+ * @brief Number of block size classes.
+ *
+ * Classes below 192 bytes only serve allocations made with the compact
+ * 32-byte header (TTAK_MEM_COMPACT_HEADER).
+ */
+#define TTAK_SLAB_NUM_CLASSES 17
+
+/**
+ * @brief Allocates a raw block from the calling thread's cache.
+ *
+ * Small tracked allocations issued by ttak_mem_alloc_safe are served from here.
+ * The fast path pops a per-thread, per-class free list and never touches a
+ * global lock. Memory is not zeroed. Blocks are 16-byte aligned, and blocks
+ * of 192 bytes and up are 64-byte aligned.
+ *
+ * @param block_size Total bytes required (<= TTAK_SLAB_MAX_BLOCK).
+ * @return Block pointer, or NULL if the size is not slab-eligible or memory is exhausted.
+ */
+void *ttak_slab_alloc(size_t block_size);
+
+/**
+ * @brief Returns a block to its owning thread cache.
+ *
+ * Blocks freed by the owning thread go straight back to its free list.
+ * Blocks freed by any other thread are pushed onto the owner's lock-free
+ * remote-free list and recycled on the owner's next refill.
+ *
+ * @param block Pointer previously returned by ttak_slab_alloc.
+ */
+void ttak_slab_free(void *block);
+
+/**
+ * @brief Returns the usable capacity of a slab block (its size class).
+ *
+ * @param block Pointer previously returned by ttak_slab_alloc.
+ * @return Class size in bytes.
+ */
+size_t ttak_slab_block_size(const void *block);
+
+#endif // TTAK_MEM_SLAB_H
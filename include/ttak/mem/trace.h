@@ -0,0 +1,126 @@
+#ifndef TTAK_MEM_TRACE_H
+#define TTAK_MEM_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Records per thread ring (power of two).
+ */
+#define TTAK_TRACE_RING_SIZE 4096
+
+/**
+ * @brief Bytes of an owner resource name kept in a record (including the terminator).
+ */
+#define TTAK_TRACE_NAME_LEN 24
+
+/**
+ * @brief File magic written at the start of a binary trace.
+ */
+#define TTAK_TRACE_MAGIC "TTAKTRC1"
+
+/**
+ * @brief Binary trace format version.
+ */
+#define TTAK_TRACE_VERSION 1
+
+/**
+ * @brief Trace event kinds.
+ */
+typedef enum {
+    TTAK_TRACE_ALLOC = 1,       /** a = size, b = is_root */
+    TTAK_TRACE_ACCESS = 2,      /** a = access count */
+    TTAK_TRACE_FREE = 3,
+    TTAK_TRACE_ENABLED = 4,
+    TTAK_TRACE_REGISTER = 5,    /** a = owner, name = resource */
+    TTAK_TRACE_TRANSFER = 6     /** a = from, b = to, name = resource */
+} ttak_trace_event_t;
+
+/**
+ * @brief Fixed-size binary trace record (one cache line).
+ */
+typedef struct ttak_trace_record {
+    uint64_t ts;                        /**< Caller-supplied tick. */
+    uint64_t ptr;                       /**< Subject allocation. */
+    uint64_t a;                         /**< First event argument. */
+    uint64_t b;                         /**< Second event argument. */
+    uint32_t event;                     /**< ttak_trace_event_t. */
+    uint32_t tid;                       /**< Small ID of the emitting thread. */
+    char name[TTAK_TRACE_NAME_LEN];     /**< Owner resource name, truncated. */
+} ttak_trace_record_t;
+
+/**
+ * @brief Header at the start of a binary trace file.
+ */
+typedef struct ttak_trace_file_header {
+    char magic[8];              /**< TTAK_TRACE_MAGIC. */
+    uint32_t version;           /**< TTAK_TRACE_VERSION. */
+    uint32_t record_size;       /**< sizeof(ttak_trace_record_t). */
+} ttak_trace_file_header_t;
+
+/**
+ * @brief Selects where the drain thread writes trace records.
+ *
+ * With a path, records are appended in binary form to that file and can be
+ * turned into JSON later with ttak_trace_decode. With NULL (the default) the
+ * drain thread decodes records itself and writes the JSON lines to stderr.
+ * Takes effect the next time tracing is enabled.
+ *
+ * @param path Output file, or NULL for stderr JSON.
+ * @return 0 on success, -1 if tracing is currently running.
+ */
+int ttak_trace_set_output(const char *path);
+
+/**
+ * @brief Starts the drain thread and opens the output.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int ttak_trace_start(void);
+
+/**
+ * @brief Stops the drain thread after flushing every ring, and closes the output.
+ */
+void ttak_trace_stop(void);
+
+/**
+ * @brief Appends one event to the calling thread's ring.
+ *
+ * Lock-free and allocation-free after the thread's first event. If the ring
+ * is full the event is dropped and counted rather than blocking the caller.
+ *
+ * @param event Event kind.
+ * @param ptr Subject allocation.
+ * @param a First argument.
+ * @param b Second argument.
+ * @param ts Tick of the event.
+ * @param name Resource name or NULL.
+ */
+void ttak_trace_emit(ttak_trace_event_t event, const void *ptr, uint64_t a, uint64_t b, uint64_t ts, const char *name);
+
+/**
+ * @brief Returns the number of events dropped because a ring was full.
+ */
+uint64_t ttak_trace_dropped(void);
+
+/**
+ * @brief Formats one record as the JSON object used by the text trace.
+ *
+ * @param rec Record to format.
+ * @param buf Output buffer.
+ * @param len Size of @p buf.
+ * @return Characters written (as snprintf), or -1 for unknown events.
+ */
+int ttak_trace_format(const ttak_trace_record_t *rec, char *buf, size_t len);
+
+/**
+ * @brief Offline decoder: converts a binary trace into "[MEM_TRACK] {json}" lines.
+ *
+ * @param in Binary trace opened for reading.
+ * @param out Text output.
+ * @return Number of records decoded, or -1 if the header is invalid.
+ */
+long ttak_trace_decode(FILE *in, FILE *out);
+
+#endif // TTAK_MEM_TRACE_H
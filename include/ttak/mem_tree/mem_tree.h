@@ -9,6 +9,21 @@
 
 typedef struct ttak_mem_tree ttak_mem_tree_t;
 
+/**
+ * @brief Number of independently locked shards in a mem tree (power of two).
+ */
+#define TTAK_MEM_TREE_SHARDS 16
+
+/**
+ * @brief Timer wheel geometry: 4 levels of 64 slots, 1 tick per level-0 slot.
+ *
+ * Level l slots span 64^l ticks, so the wheel covers 2^24 ticks (about 4.6
+ * hours of millisecond ticks); later expiries wait on an overflow list.
+ */
+#define TTAK_MEM_TREE_WHEEL_BITS   6
+#define TTAK_MEM_TREE_WHEEL_SLOTS  (1U << TTAK_MEM_TREE_WHEEL_BITS)
+#define TTAK_MEM_TREE_WHEEL_LEVELS 4
+
 /**
  * @brief Represents a node in the generic heap tree, tracking a dynamically allocated memory block.
  *
@@ -25,9 +40,43 @@ typedef struct ttak_mem_node {
     pthread_mutex_t lock;           /**< Mutex for thread-safe access to this node's metadata. */
     struct ttak_mem_node *next;    /**< Pointer to the next node in the mem tree's internal list. */
     struct ttak_mem_node *prev;    /**< Pointer to the previous node in the mem tree's internal list. */
-    ttak_mem_tree_t *tree;         /**< Pointer back to the parent mem tree. */
+    struct ttak_mem_node *hash_next; /**< Next node in the same pointer-index bucket. */
+    uint32_t shard;                 /**< Index of the shard tracking this node. */
+    struct ttak_mem_node *timer_next;  /**< Next node on the same timer list (wheel slot, due or parked). */
+    struct ttak_mem_node **timer_pprev; /**< Link pointing at this node, NULL if on no timer list. */
+    ttak_mem_tree_t *tree;         /**< Pointer back to the parent mem tree (NULL once detached for cleanup). */
 } ttak_mem_node_t;
 
+/**
+ * @brief One lock domain of a mem tree.
+ *
+ * Nodes are assigned to shards by pointer hash, so adds, lookups and removals
+ * for different shards never contend. Each shard keeps its own chained
+ * pointer index, making ttak_mem_tree_find_node O(1), and its own
+ * hierarchical timer wheel keyed by expires_tick. Advancing the wheel only
+ * touches the slots whose time has come; expired nodes move to the due list,
+ * and due nodes that are still referenced are parked until pressure is
+ * reported. Unreferenced nodes stay due until a cleanup pass frees them.
+ */
+typedef struct ttak_mem_tree_shard {
+    pthread_mutex_t lock;           /**< Protects the shard's list and index. */
+    ttak_mem_node_t *head;          /**< Head of the shard's node list. */
+    ttak_mem_node_t **buckets;      /**< Pointer-keyed index buckets. */
+    size_t bucket_count;            /**< Number of index buckets (power of two). */
+    size_t count;                   /**< Number of nodes tracked by the shard. */
+    ttak_mem_node_t *wheel[TTAK_MEM_TREE_WHEEL_LEVELS][TTAK_MEM_TREE_WHEEL_SLOTS]; /**< Timer wheel slots. */
+    ttak_mem_node_t *overflow;      /**< Nodes expiring beyond the wheel's horizon. */
+    uint64_t overflow_min;          /**< Earliest expiry on the overflow list. */
+    ttak_mem_node_t *due;           /**< Expired nodes not yet examined by a cleanup pass. */
+    ttak_mem_node_t *parked;        /**< Expired nodes that were still referenced when examined. */
+    uint64_t wheel_base;            /**< Tick the wheel has been advanced to. */
+} ttak_mem_tree_shard_t;
+
+/**
+ * @brief Visitor callback for ttak_mem_tree_for_each.
+ */
+typedef void (*ttak_mem_tree_visit_t)(ttak_mem_node_t *node, void *arg);
+
 /**
  * @brief Manages the collection of dynamically allocated memory blocks as a mem tree.
  *
@@ -37,8 +86,8 @@ typedef struct ttak_mem_node {
  * over the cleanup process.
  */
 struct ttak_mem_tree {
-    ttak_mem_node_t *head;             /**< Head of the linked list of all tracked mem nodes. */
-    pthread_mutex_t lock;               /**< Mutex for thread-safe access to the mem tree structure. */
+    ttak_mem_tree_shard_t shards[TTAK_MEM_TREE_SHARDS]; /**< Sharded node lists and pointer index. */
+    pthread_mutex_t lock;               /**< Mutex guarding the cleanup thread's condition variable. */
     pthread_cond_t cond;                /**< Condition variable for immediate cleanup wakeup. */
     _Atomic uint64_t max_cleanup_interval_ns; /**< Maximum interval in nanoseconds for automatic cleanup (default 120s). */
     _Atomic uint64_t min_cleanup_interval_ns; /**< Minimum interval in nanoseconds for automatic cleanup (default 10s). */
@@ -76,16 +125,53 @@ void ttak_mem_tree_destroy(ttak_mem_tree_t *tree);
 ttak_mem_node_t *ttak_mem_tree_add(ttak_mem_tree_t *tree, void *ptr, size_t size, uint64_t expires_tick, _Bool is_root);
 
 /**
- * @brief Removes a memory block from the mem tree bookkeeping.
+ * @brief Adds several memory blocks, locking each touched shard once.
  *
- * Callers are responsible for freeing the actual allocation once the node has
- * been detached from the tree.
+ * @param tree Pointer to the mem tree.
+ * @param ptrs Blocks to track; NULL entries are skipped.
+ * @param sizes Size of each block.
+ * @param count Number of entries in @p ptrs, @p sizes and @p nodes_out.
+ * @param expires_tick Monotonic tick when the blocks expire.
+ * @param is_root True if the blocks are root nodes.
+ * @param nodes_out Receives each entry's node, or NULL if it was skipped or could not be tracked.
+ * @return Number of blocks added.
+ */
+size_t ttak_mem_tree_add_batch(ttak_mem_tree_t *tree, void *const *ptrs, const size_t *sizes, size_t count,
+                               uint64_t expires_tick, _Bool is_root, ttak_mem_node_t **nodes_out);
+
+/**
+ * @brief Removes a memory block from the mem tree bookkeeping in O(1).
+ *
+ * Only the node's shard is locked. Callers are responsible for freeing the
+ * actual allocation once the node has been detached from the tree. Nodes that
+ * a cleanup pass has already detached are left to that pass.
  *
  * @param tree Pointer to the mem tree.
  * @param node Pointer to the mem node to remove.
  */
 void ttak_mem_tree_remove(ttak_mem_tree_t *tree, ttak_mem_node_t *node);
 
+/**
+ * @brief Removes several memory blocks, locking each touched shard once.
+ *
+ * Each entry follows the ttak_mem_tree_remove contract.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param nodes Nodes to remove; NULL entries are skipped. Every entry is cleared.
+ * @param count Number of entries.
+ */
+void ttak_mem_tree_remove_batch(ttak_mem_tree_t *tree, ttak_mem_node_t **nodes, size_t count);
+
+/**
+ * @brief Updates the recorded size and expiry of a block resized in place.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param node Node of the block.
+ * @param size New size of the block.
+ * @param expires_tick New expiry of the block; the node is re-filed on the timer wheel if it changed.
+ */
+void ttak_mem_tree_resize(ttak_mem_tree_t *tree, ttak_mem_node_t *node, size_t size, uint64_t expires_tick);
+
 /**
  * @brief Increments the reference count for a given mem node.
  *
@@ -148,7 +234,10 @@ void ttak_mem_tree_set_manual_cleanup(ttak_mem_tree_t *tree, _Bool manual_cleanu
  * @brief Performs a manual cleanup pass, freeing expired and unreferenced memory blocks.
  *
  * This function is typically called when automatic cleanup is disabled or when
- * an immediate cleanup is desired.
+ * an immediate cleanup is desired. Only nodes whose timer has fired are
+ * examined, so the cost follows the amount of garbage rather than the number
+ * of live nodes. Parked (still referenced) nodes are re-examined only when
+ * pressure has been reported or manual cleanup is enabled.
  *
  * @param tree Pointer to the mem tree.
  * @param now Current monotonic tick.
@@ -158,10 +247,79 @@ void ttak_mem_tree_perform_cleanup(ttak_mem_tree_t *tree, uint64_t now);
 /**
  * @brief Finds a mem node associated with a given memory pointer.
  *
+ * Runs in O(1) through the owning shard's pointer index.
+ *
  * @param tree Pointer to the mem tree.
  * @param ptr The memory pointer to search for.
  * @return A pointer to the found mem node, or NULL if not found.
  */
 ttak_mem_node_t *ttak_mem_tree_find_node(ttak_mem_tree_t *tree, void *ptr);
 
+/**
+ * @brief Visits every tracked node, one shard at a time.
+ *
+ * The visitor runs with the node's shard locked and must not add or remove
+ * nodes of the same tree.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param visit Callback invoked for each node.
+ * @param arg User argument forwarded to the callback.
+ */
+void ttak_mem_tree_for_each(ttak_mem_tree_t *tree, ttak_mem_tree_visit_t visit, void *arg);
+
+/**
+ * @brief Advances the timer wheels to @p now and visits every due or parked node.
+ *
+ * Nodes that have not expired by the wheel's clock are never visited, so the
+ * walk costs O(expired). The visitor runs with the node's shard locked and
+ * must not add or remove nodes of the same tree.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param now Current monotonic tick.
+ * @param visit Callback invoked for each due node.
+ * @param arg User argument forwarded to the callback.
+ */
+void ttak_mem_tree_for_each_due(ttak_mem_tree_t *tree, uint64_t now, ttak_mem_tree_visit_t visit, void *arg);
+
+/**
+ * @brief Resumable position of an incremental due-node sweep.
+ *
+ * Zero-initialize before the first call. The offset is a hint: nodes added
+ * to or removed from the shard between calls can shift it, in which case a
+ * node is visited twice or picked up on the next round.
+ */
+typedef struct ttak_mem_tree_cursor {
+    uint32_t shard;     /**< Shard the next call resumes in. */
+    size_t offset;      /**< Due/parked nodes of that shard already visited. */
+} ttak_mem_tree_cursor_t;
+
+/**
+ * @brief Visits at most @p max_nodes due or parked nodes of one shard, resuming at @p cursor.
+ *
+ * Only the cursor's shard is locked, once, and its timer wheel is advanced
+ * when the sweep enters it. The cursor moves to the next shard once the
+ * current one has been fully visited. Same visitor rules as
+ * ttak_mem_tree_for_each_due.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param cursor Sweep position, updated in place.
+ * @param now Current monotonic tick.
+ * @param max_nodes Upper bound on visited nodes.
+ * @param visit Callback invoked for each node.
+ * @param arg User argument forwarded to the callback.
+ * @return Number of nodes visited.
+ */
+size_t ttak_mem_tree_sweep_due(ttak_mem_tree_t *tree, ttak_mem_tree_cursor_t *cursor, uint64_t now, size_t max_nodes,
+                               ttak_mem_tree_visit_t visit, void *arg);
+
+/**
+ * @brief Moves a node onto its shard's due list ahead of its expiry.
+ *
+ * Used to surface nodes that became dirty for reasons other than time.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param node Pointer to the mem node.
+ */
+void ttak_mem_tree_mark_due(ttak_mem_tree_t *tree, ttak_mem_node_t *node);
+
 #endif // TTAK_HEAP_TREE_H
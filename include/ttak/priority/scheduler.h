@@ -41,4 +41,12 @@ void ttak_scheduler_record_execution(ttak_task_t *task, uint64_t duration_ms);
  */
 int ttak_scheduler_get_adjusted_priority(ttak_task_t *task, int base_priority);
 
+/**
+ * @brief Release the calling thread's hold on the history map.
+ *
+ * Hands the thread's hazard record, and any history tables it retired,
+ * back to the map. Call before a thread that recorded executions exits.
+ */
+void ttak_scheduler_unregister_thread(void);
+
 #endif // TTAK_PRIORITY_SCHEDULER_H
@@ -19,6 +19,7 @@ struct ttak_thread_pool {
     pthread_cond_t      task_cond;
     uint64_t            creation_ts;
     _Bool               is_shutdown;
+    _Bool               sweeping;       /**< Holds a reference on the background dirty-pointer sweeper. */
 
     /**
      * @brief Kills all sub-threads.
@@ -0,0 +1,85 @@
+#ifndef TTAK_UNSAFE_CHANNEL_H
+#define TTAK_UNSAFE_CHANNEL_H
+
+#include <ttak/unsafe/region.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+
+/**
+ * @brief Bounded single-producer/single-consumer queue of region ownership.
+ *
+ * Only the region descriptors travel through the ring; the payload never
+ * moves. The producer side is bound to one ctx/allocator pair and the
+ * consumer side to another, and every transfer goes through
+ * ttak_unsafe_region_move (in) and ttak_unsafe_region_move_cross_ctx (out),
+ * so pinned regions, foreign contexts and occupied destinations are refused
+ * at the boundary. Each index sits on its own cache line next to a private
+ * copy of the other side's index, so a side only reads the shared line of
+ * its peer when its cached view says the ring is full or empty.
+ */
+typedef struct ttak_region_channel {
+    alignas(64) _Atomic size_t head;    /**< Next slot the consumer takes. */
+    size_t tail_cache;                  /**< Consumer's last view of tail. */
+    alignas(64) _Atomic size_t tail;    /**< Next slot the producer fills. */
+    size_t head_cache;                  /**< Producer's last view of head. */
+    alignas(64) ttak_unsafe_region_t *slots; /**< Ring storage, mask + 1 entries. */
+    size_t mask;                        /**< Capacity - 1 (capacity is a power of two). */
+    uint32_t send_ctx;                  /**< Context regions must belong to when sent. */
+    uint32_t recv_ctx;                  /**< Context regions are rebound to when received. */
+    const char *send_tag;               /**< Allocator tag required on send. */
+    const char *recv_tag;               /**< Allocator tag set on receive. */
+} ttak_region_channel_t;
+
+/**
+ * @brief Initializes a channel from the sending ctx/allocator to the receiving one.
+ *
+ * @param capacity Slots, rounded up to a power of two (at least 2).
+ * @return false if the ring could not be allocated.
+ */
+bool ttak_region_channel_init(ttak_region_channel_t *ch, size_t capacity,
+                              uint32_t send_ctx, const char *send_tag,
+                              uint32_t recv_ctx, const char *recv_tag);
+
+/**
+ * @brief Frees the ring. Regions still queued are forgotten, not freed.
+ */
+void ttak_region_channel_destroy(ttak_region_channel_t *ch);
+
+/**
+ * @brief Producer: moves @p src into the channel, leaving it empty.
+ *
+ * @return false if the channel is full, or if @p src is empty, pinned, or
+ *         not owned by the sending ctx/allocator; @p src is untouched then.
+ */
+bool ttak_region_channel_send(ttak_region_channel_t *ch, ttak_unsafe_region_t *src);
+
+/**
+ * @brief Consumer: moves the oldest queued region into @p dst.
+ *
+ * @p dst must be empty, unpinned and bound to the receiving ctx; it is
+ * rebound to the receiving allocator tag.
+ *
+ * @return false if the channel is empty or @p dst cannot accept a region.
+ */
+bool ttak_region_channel_recv(ttak_region_channel_t *ch, ttak_unsafe_region_t *dst);
+
+/**
+ * @brief Consumer: moves up to @p max queued regions into @p dst[0..].
+ *
+ * The producer's index is read once and the consumer's index published once
+ * for the whole batch. Stops early at the first destination that cannot
+ * accept a region.
+ *
+ * @return Number of regions received.
+ */
+size_t ttak_region_channel_recv_batch(ttak_region_channel_t *ch, ttak_unsafe_region_t *dst, size_t max);
+
+/**
+ * @brief Returns the number of queued regions (exact only from one of the two sides).
+ */
+size_t ttak_region_channel_count(ttak_region_channel_t *ch);
+
+#endif // TTAK_UNSAFE_CHANNEL_H
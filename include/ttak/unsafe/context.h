@@ -5,6 +5,7 @@
 #include <ttak/sync/sync.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 
 #define __TTAK_CTX_USE_FIRST__  0
 #define __TTAK_CTX_USE_SECOND__ 1
@@ -13,14 +14,43 @@ typedef int ttak_context_inherit_t;
 
 typedef void (*ttak_context_callback_t)(void *shared_mem, size_t shared_size, void *arg);
 
+/**
+ * @brief Callback of a read-only run; it must not modify the shared region.
+ */
+typedef void (*ttak_context_read_callback_t)(const void *shared_mem, size_t shared_size, void *arg);
+
+/**
+ * @brief How a run may touch the shared region.
+ */
+typedef enum {
+    TTAK_CONTEXT_READ = 0,  /** Shared: concurrent with other readers */
+    TTAK_CONTEXT_WRITE = 1  /** Exclusive */
+} ttak_context_access_t;
+
+/**
+ * @brief One callback of a batched run.
+ */
+typedef struct ttak_context_op {
+    ttak_context_callback_t cb;
+    void *arg;
+} ttak_context_op_t;
+
+/**
+ * @brief Two owners bridged over one shared region.
+ *
+ * bridge_lock is taken shared by every run and exclusively by
+ * ttak_context_reassign, so the active side cannot change under a run.
+ * The shared region itself is guarded by the active owner's lock: read
+ * runs take it shared and write runs exclusively.
+ */
 typedef struct ttak_context {
     ttak_owner_t *first;
     ttak_owner_t *second;
     void         *shared_mem;
     size_t        shared_size;
-    ttak_mutex_t  bridge_lock;
+    ttak_rwlock_t bridge_lock;
     ttak_context_inherit_t ownership_side;
-    ttak_context_inherit_t last_request;
+    _Atomic ttak_context_inherit_t last_request;
     bool initialized;
 } ttak_context_t;
 
@@ -33,11 +63,46 @@ bool ttak_context_init(ttak_context_t *ctx,
 
 void ttak_context_destroy(ttak_context_t *ctx);
 
+/**
+ * @brief Runs @p cb with exclusive access to the shared region.
+ *
+ * Same as ttak_context_run_write.
+ */
 bool ttak_context_run(ttak_context_t *ctx,
                       ttak_context_inherit_t side,
                       ttak_context_callback_t cb,
                       void *arg);
 
+/**
+ * @brief Runs @p cb with exclusive access to the shared region.
+ */
+bool ttak_context_run_write(ttak_context_t *ctx,
+                            ttak_context_inherit_t side,
+                            ttak_context_callback_t cb,
+                            void *arg);
+
+/**
+ * @brief Runs @p cb with shared access; read runs on one context proceed in parallel.
+ */
+bool ttak_context_run_read(ttak_context_t *ctx,
+                           ttak_context_inherit_t side,
+                           ttak_context_read_callback_t cb,
+                           void *arg);
+
+/**
+ * @brief Runs @p count callbacks in order under one lock acquisition.
+ *
+ * With TTAK_CONTEXT_READ the callbacks must not modify the shared region.
+ *
+ * @return false if the context is not initialized or an entry has no callback
+ *         (nothing runs then).
+ */
+bool ttak_context_run_batch(ttak_context_t *ctx,
+                            ttak_context_inherit_t side,
+                            ttak_context_access_t access,
+                            const ttak_context_op_t *ops,
+                            size_t count);
+
 bool ttak_context_reassign(ttak_context_t *ctx, ttak_context_inherit_t side);
 
 ttak_owner_t *ttak_context_owner(const ttak_context_t *ctx, ttak_context_inherit_t side);
@@ -32,9 +32,22 @@
 #if defined(__GNUC__) || defined(__clang__)
 #define TTAK_HOT_PATH __attribute__((hot))
 #define TTAK_COLD_PATH __attribute__((cold))
+#define TTAK_NOINLINE __attribute__((noinline))
 #else
 #define TTAK_HOT_PATH
 #define TTAK_COLD_PATH
+#define TTAK_NOINLINE
+#endif
+
+/**
+ * @brief Thread-local storage qualifier (TCC builds fall back to shared storage).
+ */
+#ifndef TTAK_THREAD_LOCAL
+#if defined(__TINYC__)
+#define TTAK_THREAD_LOCAL
+#else
+#define TTAK_THREAD_LOCAL _Thread_local
+#endif
 #endif
 
 /**
@@ -52,6 +65,31 @@
  */
 #define SAFE_NULL NULL
 
+struct ttak_mem_node;
+
+/**
+ * @brief Layout of the packed allocation state word.
+ *
+ * bit 63      : freed
+ * bits 48..62 : pin count (saturates at TTAK_MEM_STATE_PIN_MAX and then sticks)
+ * bits 0..47  : expiry tick (TTAK_MEM_STATE_EXP_MASK means "never expires")
+ */
+#define TTAK_MEM_STATE_FREED     (1ULL << 63)
+#define TTAK_MEM_STATE_PIN_SHIFT 48
+#define TTAK_MEM_STATE_PIN_ONE   (1ULL << TTAK_MEM_STATE_PIN_SHIFT)
+#define TTAK_MEM_STATE_PIN_MAX   0x7FFFULL
+#define TTAK_MEM_STATE_EXP_MASK  (TTAK_MEM_STATE_PIN_ONE - 1)
+
+#define TTAK_MEM_STATE_PINS(s)   (((s) >> TTAK_MEM_STATE_PIN_SHIFT) & TTAK_MEM_STATE_PIN_MAX)
+#define TTAK_MEM_STATE_EXPIRY(s) ((s) & TTAK_MEM_STATE_EXP_MASK)
+
+/**
+ * @brief Encodes an expiry tick into the 48-bit field (far expiries clamp to "never").
+ */
+static inline uint64_t ttak_mem_state_encode_expiry(uint64_t expires_tick) {
+    return expires_tick >= TTAK_MEM_STATE_EXP_MASK ? TTAK_MEM_STATE_EXP_MASK : expires_tick;
+}
+
 /**
  * @brief Recommended pattern for resource-managing structures:
  * All structures that manage dynamic resources (e.g., memory, threads, file handles)
@@ -63,10 +101,63 @@
  * This ensures strict lifetime management and proper cleanup.
  */
 
+#if defined(TTAK_MEM_COMPACT_HEADER)
+
+/**
+ * @brief Compact "Fortress" Memory Header (build with -DTTAK_MEM_COMPACT_HEADER).
+ * 32 bytes, user data is 16-byte aligned. Expiry lives only in the packed
+ * state word, flags are single bits, the audit counter shrinks to 16
+ * saturating bits, and the mutex and canary_start are dropped: header
+ * locking uses striped locks. Allocations are limited to 4 GiB.
+ */
+typedef struct {
+    uint32_t magic;         /**< 0x5454414B */
+    uint32_t checksum;      /**< Metadata checksum */
+    uint64_t state;         /**< Atomic packed freed/pin/expiry word (TTAK_MEM_STATE_*) */
+    uint32_t size;          /**< User-requested size */
+    _Bool    is_const : 1;            /**< Immutability hint */
+    _Bool    is_volatile : 1;         /**< Volatility hint */
+    _Bool    allow_direct_access : 1; /**< Safety bypass flag */
+    _Bool    is_huge : 1;             /**< Mapped via hugepages */
+    _Bool    should_join : 1;         /**< Indicates if associated resource needs joining */
+    _Bool    strict_check : 1;        /**< Enable strict memory boundary checks (end canary only) */
+    _Bool    is_root : 1;             /**< Externally referenced */
+    _Bool    is_slab : 1;             /**< Carved from a per-thread slab span */
+    _Bool    is_arena : 1;            /**< Holds a ttak_arena_t with overflow chunks */
+    _Bool    is_sampled : 1;          /**< Recorded by the allocation profiler */
+    _Bool    is_gen : 1;              /**< Carved from a lifetime generation */
+    uint16_t access_count;  /**< Atomic access audit counter, saturating at UINT16_MAX */
+    struct ttak_mem_node *tree_node; /**< Registry node, NULL if untracked */
+} ttak_mem_header_t;
+
+_Static_assert(sizeof(ttak_mem_header_t) == 32, "compact header must stay 32 bytes");
+
+/**
+ * @brief Calculates a 32-bit checksum for the compact memory header.
+ *
+ * Only immutable fields are covered; the pin and freed bits of the state
+ * word change during the block's life and are masked out.
+ *
+ * @param h Pointer to the memory header to be checksummed.
+ * @return uint32_t The resulting 32-bit checksum.
+ */
+static inline uint32_t ttak_calc_header_checksum(const ttak_mem_header_t *h) {
+    uint64_t expiry = h->state & TTAK_MEM_STATE_EXP_MASK;
+    uint32_t sum1 = h->magic ^ (uint32_t)expiry;
+    uint32_t sum2 = h->size ^ (uint32_t)(expiry >> 32);
+
+    sum1 ^= (uint32_t)h->should_join | ((uint32_t)h->strict_check << 1) | ((uint32_t)h->is_root << 2);
+    sum2 ^= (uint32_t)h->is_huge | ((uint32_t)h->is_slab << 1) | ((uint32_t)h->allow_direct_access << 2);
+
+    return sum1 ^ (sum2 * 0x9E3779B1U);
+}
+
+#else
+
 /**
  * @brief "Fortress" Memory Header.
  * 64-byte aligned to prevent False Sharing and ensure user pointer alignment.
- * Total size is 128 bytes to maintain 64-byte alignment for user data.
+ * Total size is a multiple of 64 bytes to maintain 64-byte alignment for user data.
  */
 typedef struct {
     alignas(64) uint32_t magic;         /**< 0x5454414B */
@@ -74,20 +165,23 @@ typedef struct {
     uint64_t created_tick;  /**< Creation timestamp */
     uint64_t expires_tick;  /**< Expiration timestamp */
     uint64_t access_count;  /**< Atomic access audit counter */
-    uint64_t pin_count;     /**< Atomic reference count for pinning */
+    uint64_t state;         /**< Atomic packed freed/pin/expiry word (TTAK_MEM_STATE_*) */
     size_t   size;          /**< User-requested size */
     pthread_mutex_t lock;   /**< Per-header synchronization */
-    _Bool    freed;         /**< Allocation status */
     _Bool    is_const;      /**< Immutability hint */
     _Bool    is_volatile;   /**< Volatility hint */
     _Bool    allow_direct_access; /**< Safety bypass flag */
     _Bool    is_huge;       /**< Mapped via hugepages */
     _Bool    should_join;   /**< Indicates if associated resource needs joining */
     _Bool    strict_check; _Bool    is_root;  /**< Enable strict memory boundary checks */
+    _Bool    is_slab;       /**< Carved from a per-thread slab span */
+    _Bool    is_arena;      /**< Holds a ttak_arena_t with overflow chunks */
+    _Bool    is_sampled;    /**< Recorded by the allocation profiler */
+    _Bool    is_gen;        /**< Carved from a lifetime generation */
     uint64_t canary_start;  /**< Magic number for start of user data */
     uint64_t canary_end;    /**< Magic number for end of user data */
-    char     *tracking_log;  /**< Memory operation tracking log (dynamic) */
-    char     reserved[11];  /**< Explicit padding for header alignment */
+    struct ttak_mem_node *tree_node; /**< Registry node, NULL if untracked */
+    char     reserved[16];   /**< Explicit padding for header alignment */
 } ttak_mem_header_t;
 
 /**
@@ -134,4 +228,6 @@ static inline uint32_t ttak_calc_header_checksum(const ttak_mem_header_t *h) {
     return sum1 ^ sum2;
 }
 
+#endif // TTAK_MEM_COMPACT_HEADER
+
 #endif // TTAK_INTERNAL_APP_TYPES_H
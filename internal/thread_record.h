@@ -0,0 +1,105 @@
+#ifndef TTAK_INTERNAL_THREAD_RECORD_H
+#define TTAK_INTERNAL_THREAD_RECORD_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "app_types.h"
+
+/**
+ * @brief Records each thread caches per reclamation scheme (distinct maps or domains).
+ */
+#define TTAK_THREAD_RECORD_CACHE 4
+
+/**
+ * @brief Defines the per-thread record binding of a reclamation scheme.
+ *
+ * Epoch GC and hazard-pointer domains both keep an append-only list of
+ * 64-byte aligned records, each bound to at most one thread at a time, and
+ * a small thread-local cache of the caller's records, so a thread that
+ * alternates between a few maps or domains does not fall back to the locked
+ * scan on every call. Entries are keyed by the owner's process-unique ID
+ * rather than its address, so an owner re-initialized at the same address
+ * never hands out a stale record; the oldest entry is replaced on a miss.
+ *
+ * Expands to three static functions of the including file:
+ * - find_record(owner): the caller's record, or NULL if it has none.
+ * - local_record(owner): the caller's record, binding a free or new one on
+ *   first use; NULL only if a new record cannot be allocated.
+ * - forget_record(owner): drops the cache entry of @p owner, if any.
+ *
+ * @p owner_t needs the fields id, records_lock and records; @p record_t
+ * needs owned, owner and next. @p on_create(owner, rec) runs under
+ * records_lock on a zeroed record just before it is published.
+ */
+#define TTAK_THREAD_RECORD_IMPL(owner_t, record_t, on_create)                                          \
+    static TTAK_THREAD_LOCAL uint64_t tls_owner_id[TTAK_THREAD_RECORD_CACHE];                          \
+    static TTAK_THREAD_LOCAL record_t *tls_record[TTAK_THREAD_RECORD_CACHE];                           \
+    static TTAK_THREAD_LOCAL unsigned tls_victim = 0;                                                   \
+                                                                                                        \
+    static inline void cache_record(owner_t *own, record_t *rec) {                                      \
+        unsigned slot = tls_victim++ % TTAK_THREAD_RECORD_CACHE;                                        \
+        tls_owner_id[slot] = own->id;                                                                   \
+        tls_record[slot] = rec;                                                                         \
+    }                                                                                                   \
+                                                                                                        \
+    static record_t *find_record(owner_t *own) {                                                        \
+        for (unsigned i = 0; i < TTAK_THREAD_RECORD_CACHE; i++) {                                       \
+            if (tls_owner_id[i] == own->id) return tls_record[i];                                       \
+        }                                                                                               \
+                                                                                                        \
+        /* Cache miss: binding fields are only stable under the lock. */                               \
+        pthread_t self = pthread_self();                                                                \
+        record_t *found = NULL;                                                                         \
+        pthread_mutex_lock(&own->records_lock);                                                         \
+        for (record_t *rec = atomic_load_explicit(&own->records, memory_order_relaxed); rec;            \
+             rec = rec->next) {                                                                         \
+            if (rec->owned && pthread_equal(rec->owner, self)) {                                        \
+                found = rec;                                                                            \
+                break;                                                                                  \
+            }                                                                                           \
+        }                                                                                               \
+        pthread_mutex_unlock(&own->records_lock);                                                       \
+        if (found) cache_record(own, found);                                                            \
+        return found;                                                                                   \
+    }                                                                                                   \
+                                                                                                        \
+    static record_t *local_record(owner_t *own) {                                                       \
+        record_t *rec = find_record(own);                                                               \
+        if (rec) return rec;                                                                            \
+                                                                                                        \
+        pthread_mutex_lock(&own->records_lock);                                                         \
+        for (rec = atomic_load_explicit(&own->records, memory_order_relaxed); rec; rec = rec->next) {   \
+            if (!rec->owned) break;                                                                     \
+        }                                                                                               \
+        if (!rec) {                                                                                     \
+            rec = aligned_alloc(64, (sizeof(record_t) + 63) & ~(size_t)63);                             \
+            if (!rec) {                                                                                 \
+                pthread_mutex_unlock(&own->records_lock);                                               \
+                return NULL;                                                                            \
+            }                                                                                           \
+            memset(rec, 0, sizeof(*rec));                                                               \
+            on_create(own, rec);                                                                        \
+            rec->next = atomic_load_explicit(&own->records, memory_order_relaxed);                      \
+            atomic_store_explicit(&own->records, rec, memory_order_release);                            \
+        }                                                                                               \
+        rec->owned = true;                                                                              \
+        rec->owner = pthread_self();                                                                    \
+        pthread_mutex_unlock(&own->records_lock);                                                       \
+                                                                                                        \
+        cache_record(own, rec);                                                                         \
+        return rec;                                                                                     \
+    }                                                                                                   \
+                                                                                                        \
+    static inline void forget_record(owner_t *own) {                                                    \
+        for (unsigned i = 0; i < TTAK_THREAD_RECORD_CACHE; i++) {                                       \
+            if (tls_owner_id[i] == own->id) {                                                           \
+                tls_owner_id[i] = 0;                                                                    \
+                tls_record[i] = NULL;                                                                   \
+            }                                                                                           \
+        }                                                                                               \
+    }
+
+#endif // TTAK_INTERNAL_THREAD_RECORD_H
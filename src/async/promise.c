@@ -12,15 +12,16 @@
  */
 
 ttak_promise_t *ttak_promise_create(uint64_t now) {
-    ttak_promise_t *promise = (ttak_promise_t *)ttak_mem_alloc(sizeof(ttak_promise_t), __TTAK_UNSAFE_MEM_FOREVER__, now); // A promise structure lives forever unless a developer cleans it.
-    if (!promise) return NULL; // must be handled using TTAK_STRUCT_IS_NULL(ptr);
-
-    promise->future = (ttak_future_t *)ttak_mem_alloc(sizeof(ttak_future_t), __TTAK_UNSAFE_MEM_FOREVER__, now); // same for a future pointer.
-    if (!promise->future) {
-        ttak_mem_free(promise);
+    // Promise and future live forever unless a developer cleans them; both are registered in one batch.
+    const size_t sizes[2] = { sizeof(ttak_promise_t), sizeof(ttak_future_t) };
+    void *blocks[2];
+    if (!ttak_mem_alloc_batch(blocks, sizes, 2, __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT)) {
         return NULL; // must be handled using TTAK_STRUCT_IS_NULL(ptr);
     }
 
+    ttak_promise_t *promise = (ttak_promise_t *)blocks[0];
+    promise->future = (ttak_future_t *)blocks[1];
+
     promise->future->ready = false; // initialize future->ready to false
     promise->future->result = NULL; // initialize future->result to NULL
     pthread_mutex_init(&promise->future->mutex, NULL); // mutex to prevent concurrent memory access issues
@@ -40,12 +41,15 @@ ttak_promise_t *ttak_promise_create(uint64_t now) {
  */
 
 void ttak_promise_set_value(ttak_promise_t *promise, void *val, uint64_t now) {
-    if (!ttak_mem_access(promise, now) || !promise->future) return;
-    pthread_mutex_lock(&promise->future->mutex);
-    promise->future->result = val;
-    promise->future->ready = true;
-    pthread_cond_broadcast(&promise->future->cond);
-    pthread_mutex_unlock(&promise->future->mutex);
+    if (!ttak_mem_access(promise, now)) return;
+    if (promise->future) {
+        pthread_mutex_lock(&promise->future->mutex);
+        promise->future->result = val;
+        promise->future->ready = true;
+        pthread_cond_broadcast(&promise->future->cond);
+        pthread_mutex_unlock(&promise->future->mutex);
+    }
+    ttak_mem_unpin(promise);
 }
 
 /**
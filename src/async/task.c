@@ -78,12 +78,14 @@ uint64_t ttak_task_get_start_ts(const ttak_task_t *task) {
  * @param task Pointer to the task.
  */
 void ttak_task_execute(ttak_task_t *task, uint64_t now) {
-    if (ttak_mem_access(task, now) && task->func) {
+    if (!ttak_mem_access(task, now)) return;
+    if (task->func) {
         void *res = task->func(task->arg);
         if (task->promise) {
             ttak_promise_set_value(task->promise, res, now);
         }
     }
+    ttak_mem_unpin(task);
 }
 
 /**
@@ -95,7 +97,9 @@ void ttak_task_execute(ttak_task_t *task, uint64_t now) {
  */
 ttak_task_t *ttak_task_clone(const ttak_task_t *task, uint64_t now) {
     if (!ttak_mem_access((void *)task, now)) return NULL;
-    return ttak_task_create(task->func, task->arg, task->promise, now);
+    ttak_task_t *clone = ttak_task_create(task->func, task->arg, task->promise, now);
+    ttak_mem_unpin((void *)task);
+    return clone;
 }
 
 /**
@@ -105,6 +109,7 @@ ttak_task_t *ttak_task_clone(const ttak_task_t *task, uint64_t now) {
  */
 void ttak_task_destroy(ttak_task_t *task, uint64_t now) {
     if (ttak_mem_access(task, now)) {
+        ttak_mem_unpin(task);
         ttak_mem_free(task);
     }
 }
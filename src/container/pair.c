@@ -64,6 +64,7 @@ void ttak_pair_destroy(ttak_pair_t *pair, void (*free_elem)(void*), uint64_t now
                     }
                 }
             }
+            ttak_mem_unpin(pair->elements);
             ttak_mem_free(pair->elements);
         }
     }
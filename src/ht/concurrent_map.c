@@ -0,0 +1,494 @@
+/**
+ * @file concurrent_map.c
+ * @brief Sharded hash map with striped writer locks and lock-free readers.
+ *
+ * Each shard is an open-addressing table of eight-slot buckets probed in
+ * triangular order, like ttak_map_t but with the control bytes of a bucket
+ * packed into one word so that they can be read atomically and matched with
+ * plain 64-bit arithmetic. Entries never move within a table: a delete
+ * leaves a tombstone (or EMPTY, if the bucket already had an EMPTY slot and
+ * so never sent a probe onwards) and tombstones are only dropped when the
+ * shard rebuilds its table. A reader therefore only has to validate the
+ * bucket it found a key in, or the bucket whose EMPTY slot ended its probe.
+ */
+
+#include <ttak/ht/concurrent_map.h>
+#include <ttak/ht/hash.h>
+#include <ttak/mem/mem.h>
+#include <ttak/sync/spinlock.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CMAP_LSBS 0x0101010101010101ULL
+#define CMAP_MSBS 0x8080808080808080ULL
+
+/**
+ * @brief Hash bits that pick the shard; the bucket index uses bits from 7 up.
+ */
+#define CMAP_SHARD_SHIFT 40
+
+static inline uint64_t cmap_hash(const ttak_concurrent_map_t *map, uintptr_t key) {
+    return gen_hash_sip24(key, map->hash_k0, map->hash_k1);
+}
+
+/**
+ * @brief High bit set in every control byte equal to @p h2.
+ *
+ * A byte just above a real match may be flagged as well; callers compare
+ * the key anyway.
+ */
+static inline uint64_t cmap_match(uint64_t ctrl, uint8_t h2) {
+    uint64_t x = ctrl ^ (CMAP_LSBS * h2);
+    return (x - CMAP_LSBS) & ~x & CMAP_MSBS;
+}
+
+/**
+ * @brief High bit set in every EMPTY control byte.
+ *
+ * EMPTY (0x80) is the only control value with bit 7 set and bit 1 clear.
+ */
+static inline uint64_t cmap_match_empty(uint64_t ctrl) {
+    return ctrl & ~(ctrl << 6) & CMAP_MSBS;
+}
+
+/**
+ * @brief High bit set in every EMPTY or DELETED control byte.
+ */
+static inline uint64_t cmap_match_free(uint64_t ctrl) {
+    return ctrl & CMAP_MSBS;
+}
+
+static inline unsigned cmap_next(uint64_t *bits) {
+    unsigned slot = (unsigned)__builtin_ctzll(*bits) >> 3;
+    *bits &= *bits - 1;
+    return slot;
+}
+
+static inline uint64_t cmap_set_ctrl(uint64_t ctrl, unsigned slot, uint8_t byte) {
+    unsigned shift = slot * 8;
+    return (ctrl & ~(0xFFULL << shift)) | ((uint64_t)byte << shift);
+}
+
+static inline size_t cmap_growth(size_t buckets) {
+    size_t cap = buckets * TTAK_CMAP_BUCKET_SLOTS;
+    return cap - cap / 8;
+}
+
+static inline ttak_cmap_shard_t *cmap_shard(ttak_concurrent_map_t *map, uint64_t hash, ttak_shard_t **lock) {
+    ttak_shard_t *shard = &map->shards[(size_t)(hash >> CMAP_SHARD_SHIFT) & map->shard_mask];
+    if (lock) *lock = shard;
+    return shard->data;
+}
+
+static size_t next_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+/**
+ * @brief Allocate a table of @p buckets buckets with every slot EMPTY.
+ */
+static ttak_cmap_table_t *cmap_alloc_table(size_t buckets, uint64_t now) {
+    if (buckets > (SIZE_MAX - sizeof(ttak_cmap_table_t)) / sizeof(ttak_cmap_bucket_t)) return NULL;
+    ttak_cmap_table_t *t = ttak_mem_alloc(sizeof(ttak_cmap_table_t) + buckets * sizeof(ttak_cmap_bucket_t),
+                                          __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!t) return NULL;
+    t->bucket_mask = buckets - 1;
+    for (size_t i = 0; i < buckets; i++) {
+        ttak_cmap_bucket_t *b = &t->buckets[i];
+        atomic_init(&b->version, 0);
+        atomic_init(&b->ctrl, CMAP_LSBS * EMPTY);
+        for (unsigned s = 0; s < TTAK_CMAP_BUCKET_SLOTS; s++) {
+            atomic_init(&b->keys[s], 0);
+            atomic_init(&b->values[s], 0);
+        }
+    }
+    return t;
+}
+
+/*
+ * Writer side. Everything below runs under the shard's writer lock, so the
+ * writer's own loads need no ordering; only its stores must be bracketed by
+ * the bucket version for the benefit of readers.
+ */
+
+static inline void bucket_write_begin(ttak_cmap_bucket_t *b) {
+    uint64_t v = atomic_load_explicit(&b->version, memory_order_relaxed);
+    atomic_store_explicit(&b->version, v + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void bucket_write_end(ttak_cmap_bucket_t *b) {
+    uint64_t v = atomic_load_explicit(&b->version, memory_order_relaxed);
+    atomic_store_explicit(&b->version, v + 1, memory_order_release);
+}
+
+/**
+ * @brief Writer-side lookup.
+ *
+ * @return true if found; *bucket and *slot then locate the key.
+ */
+static bool cmap_find(ttak_cmap_table_t *t, uintptr_t key, uint64_t hash, ttak_cmap_bucket_t **bucket, unsigned *slot) {
+    uint8_t h2 = (uint8_t)(hash & 0x7F);
+    size_t mask = t->bucket_mask;
+    size_t i = (size_t)(hash >> 7) & mask;
+    for (size_t step = 1; step <= mask + 1; step++) {
+        ttak_cmap_bucket_t *b = &t->buckets[i];
+        uint64_t ctrl = atomic_load_explicit(&b->ctrl, memory_order_relaxed);
+        uint64_t match = cmap_match(ctrl, h2);
+        while (match) {
+            unsigned s = cmap_next(&match);
+            if (atomic_load_explicit(&b->keys[s], memory_order_relaxed) == key) {
+                *bucket = b;
+                *slot = s;
+                return true;
+            }
+        }
+        if (cmap_match_empty(ctrl)) break;
+        i = (i + step) & mask;
+    }
+    return false;
+}
+
+/**
+ * @brief First EMPTY or DELETED slot on the probe sequence of @p hash.
+ */
+static ttak_cmap_bucket_t *cmap_find_free(ttak_cmap_table_t *t, uint64_t hash, unsigned *slot) {
+    size_t mask = t->bucket_mask;
+    size_t i = (size_t)(hash >> 7) & mask;
+    for (size_t step = 1;; step++) {
+        ttak_cmap_bucket_t *b = &t->buckets[i];
+        uint64_t free_bits = cmap_match_free(atomic_load_explicit(&b->ctrl, memory_order_relaxed));
+        if (free_bits) {
+            *slot = cmap_next(&free_bits);
+            return b;
+        }
+        i = (i + step) & mask;
+    }
+}
+
+/**
+ * @brief Store a key known to be absent.
+ *
+ * @param publish Whether readers may see the table (bracket with the version).
+ * @return Whether an EMPTY slot was consumed.
+ */
+static bool cmap_place(ttak_cmap_table_t *t, uintptr_t key, size_t val, uint64_t hash, bool publish) {
+    unsigned s;
+    ttak_cmap_bucket_t *b = cmap_find_free(t, hash, &s);
+    uint64_t ctrl = atomic_load_explicit(&b->ctrl, memory_order_relaxed);
+    bool was_empty = (uint8_t)(ctrl >> (s * 8)) == EMPTY;
+    if (publish) bucket_write_begin(b);
+    atomic_store_explicit(&b->keys[s], key, memory_order_relaxed);
+    atomic_store_explicit(&b->values[s], val, memory_order_relaxed);
+    atomic_store_explicit(&b->ctrl, cmap_set_ctrl(ctrl, s, (uint8_t)(hash & 0x7F)), memory_order_relaxed);
+    if (publish) bucket_write_end(b);
+    return was_empty;
+}
+
+/**
+ * @brief Replace the shard's table with a rebuilt one.
+ *
+ * Doubles when more than half the growth budget holds live entries and
+ * otherwise rebuilds at the same size to drop tombstones. The new table is
+ * filled privately, published with one release store and the old one
+ * retired; readers still inside it keep a valid, if stale, view. Resizes
+ * are too rare to reach the domain's scan threshold, so the writer scans
+ * right away: tables no reader holds any more are freed now instead of
+ * waiting for a threshold the thread may never reach.
+ *
+ * @return false if the new table could not be allocated.
+ */
+static bool cmap_resize(ttak_concurrent_map_t *map, ttak_cmap_shard_t *sh, uint64_t now) {
+    ttak_cmap_table_t *old = atomic_load_explicit(&sh->table, memory_order_relaxed);
+    size_t buckets = old->bucket_mask + 1;
+    size_t size = atomic_load_explicit(&sh->size, memory_order_relaxed);
+    if (size * 2 > cmap_growth(buckets)) buckets *= 2;
+
+    ttak_cmap_table_t *t = cmap_alloc_table(buckets, now);
+    if (!t) return false;
+    for (size_t i = 0; i <= old->bucket_mask; i++) {
+        ttak_cmap_bucket_t *b = &old->buckets[i];
+        uint64_t ctrl = atomic_load_explicit(&b->ctrl, memory_order_relaxed);
+        uint64_t full = ~ctrl & CMAP_MSBS;
+        while (full) {
+            unsigned s = cmap_next(&full);
+            uintptr_t key = atomic_load_explicit(&b->keys[s], memory_order_relaxed);
+            cmap_place(t, key, atomic_load_explicit(&b->values[s], memory_order_relaxed), cmap_hash(map, key), false);
+        }
+    }
+    sh->growth_left = cmap_growth(buckets) - size;
+    atomic_store_explicit(&sh->table, t, memory_order_release);
+    ttak_hazard_retire(&map->hazard, old, NULL);
+    ttak_hazard_scan(&map->hazard);
+    return true;
+}
+
+/**
+ * @brief Shared body of insert and compute. Caller holds the shard lock.
+ */
+static bool cmap_upsert(ttak_concurrent_map_t *map, ttak_cmap_shard_t *sh, uintptr_t key, uint64_t hash,
+                        ttak_cmap_compute_t fn, void *arg, size_t val, size_t *out, uint64_t now) {
+    ttak_cmap_table_t *t = atomic_load_explicit(&sh->table, memory_order_relaxed);
+    ttak_cmap_bucket_t *b;
+    unsigned s;
+    if (cmap_find(t, key, hash, &b, &s)) {
+        if (fn) val = fn(atomic_load_explicit(&b->values[s], memory_order_relaxed), 1, arg);
+        bucket_write_begin(b);
+        atomic_store_explicit(&b->values[s], val, memory_order_relaxed);
+        bucket_write_end(b);
+        if (out) *out = val;
+        return true;
+    }
+
+    // Only filling an EMPTY slot spends growth; reusing a tombstone is free.
+    if (sh->growth_left == 0) {
+        uint64_t ctrl = atomic_load_explicit(&cmap_find_free(t, hash, &s)->ctrl, memory_order_relaxed);
+        if ((uint8_t)(ctrl >> (s * 8)) == EMPTY) {
+            if (!cmap_resize(map, sh, now)) return false;
+            t = atomic_load_explicit(&sh->table, memory_order_relaxed);
+        }
+    }
+    if (fn) val = fn(0, 0, arg);
+    sh->growth_left -= cmap_place(t, key, val, hash, true);
+    atomic_fetch_add_explicit(&sh->size, 1, memory_order_relaxed);
+    if (out) *out = val;
+    return true;
+}
+
+/**
+ * @brief Allocate a concurrent map with the requested sharding.
+ *
+ * @param shards   Shard count (0 for one per online CPU).
+ * @param init_cap Expected entries across all shards.
+ * @param now      Timestamp for memory tracker integration.
+ * @return Newly created map or NULL on allocation failure.
+ */
+ttak_concurrent_map_t *ttak_concurrent_map_create(size_t shards, size_t init_cap, uint64_t now) {
+    if (shards == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        shards = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (shards > TTAK_CMAP_MAX_SHARDS) shards = TTAK_CMAP_MAX_SHARDS;
+    shards = next_pow2(shards);
+
+    size_t per_shard = init_cap / shards + 1;
+    size_t buckets = next_pow2((per_shard + per_shard / 7 + TTAK_CMAP_BUCKET_SLOTS - 1) / TTAK_CMAP_BUCKET_SLOTS);
+
+    ttak_concurrent_map_t *map = ttak_mem_alloc(sizeof(*map), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!map) return NULL;
+    map->shards = ttak_mem_alloc(shards * sizeof(ttak_shard_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ttak_cmap_shard_t *state = ttak_mem_alloc(shards * sizeof(ttak_cmap_shard_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!map->shards || !state) {
+        ttak_mem_free(state);
+        ttak_mem_free(map->shards);
+        ttak_mem_free(map);
+        return NULL;
+    }
+    map->shard_mask = shards - 1;
+    ttak_hash_process_keys(&map->hash_k0, &map->hash_k1);
+    ttak_hazard_domain_init(&map->hazard);
+
+    for (size_t i = 0; i < shards; i++) {
+        ttak_cmap_table_t *t = cmap_alloc_table(buckets, now);
+        if (!t) {
+            while (i--) {
+                ttak_mem_free(atomic_load_explicit(&state[i].table, memory_order_relaxed));
+                ttak_shard_destroy(&map->shards[i]);
+            }
+            ttak_hazard_domain_destroy(&map->hazard);
+            ttak_mem_free(state);
+            ttak_mem_free(map->shards);
+            ttak_mem_free(map);
+            return NULL;
+        }
+        atomic_init(&state[i].table, t);
+        atomic_init(&state[i].size, 0);
+        state[i].growth_left = cmap_growth(buckets);
+        ttak_shard_init(&map->shards[i], &state[i]);
+    }
+    return map;
+}
+
+/**
+ * @brief Free a concurrent map and all its tables.
+ *
+ * @param map Map to destroy (may be NULL).
+ */
+void ttak_concurrent_map_destroy(ttak_concurrent_map_t *map) {
+    if (!map) return;
+    ttak_cmap_shard_t *state = map->shards[0].data;
+    for (size_t i = 0; i <= map->shard_mask; i++) {
+        ttak_cmap_shard_t *sh = map->shards[i].data;
+        ttak_mem_free(atomic_load_explicit(&sh->table, memory_order_relaxed));
+        ttak_shard_destroy(&map->shards[i]);
+    }
+    ttak_hazard_domain_destroy(&map->hazard);
+    ttak_mem_free(state);
+    ttak_mem_free(map->shards);
+    ttak_mem_free(map);
+}
+
+/**
+ * @brief Insert or update an entry.
+ *
+ * @param map Map to mutate.
+ * @param key Key to associate with the value.
+ * @param val Stored payload.
+ * @param now Timestamp for table allocation.
+ * @return false if the shard could not grow.
+ */
+_Bool ttak_concurrent_map_insert(ttak_concurrent_map_t *map, uintptr_t key, size_t val, uint64_t now) {
+    if (!map) return 0;
+    uint64_t h = cmap_hash(map, key);
+    ttak_shard_t *lock;
+    ttak_cmap_shard_t *sh = cmap_shard(map, h, &lock);
+    ttak_rwlock_wrlock(&lock->lock);
+    bool ok = cmap_upsert(map, sh, key, h, NULL, NULL, val, NULL, now);
+    ttak_rwlock_unlock(&lock->lock);
+    return ok;
+}
+
+/**
+ * @brief Read-modify-write an entry under its shard's writer lock.
+ *
+ * @param map Map to mutate.
+ * @param key Key to update.
+ * @param fn  Computes the new value from the old one.
+ * @param arg Passed to @p fn.
+ * @param out Optional pointer receiving the stored value.
+ * @param now Timestamp for table allocation.
+ * @return false if the shard could not grow.
+ */
+_Bool ttak_concurrent_map_compute(ttak_concurrent_map_t *map, uintptr_t key, ttak_cmap_compute_t fn, void *arg, size_t *out, uint64_t now) {
+    if (!map || !fn) return 0;
+    uint64_t h = cmap_hash(map, key);
+    ttak_shard_t *lock;
+    ttak_cmap_shard_t *sh = cmap_shard(map, h, &lock);
+    ttak_rwlock_wrlock(&lock->lock);
+    bool ok = cmap_upsert(map, sh, key, h, fn, arg, 0, out, now);
+    ttak_rwlock_unlock(&lock->lock);
+    return ok;
+}
+
+/**
+ * @brief Look up a key without locking.
+ *
+ * Each probed bucket is read between two loads of its version; a bucket
+ * that a writer was inside, or changed meanwhile, is read again.
+ *
+ * @param map Map to query.
+ * @param key Key to search for.
+ * @param out Optional pointer receiving the value.
+ * @return true if the key exists.
+ */
+_Bool ttak_concurrent_map_get(ttak_concurrent_map_t *map, uintptr_t key, size_t *out) {
+    if (!map) return 0;
+    uint64_t h = cmap_hash(map, key);
+    ttak_cmap_shard_t *sh = cmap_shard(map, h, NULL);
+    ttak_cmap_table_t *t = ttak_hazard_protect(&map->hazard, 0, &sh->table);
+    if (!t) return 0;
+
+    uint8_t h2 = (uint8_t)(h & 0x7F);
+    size_t mask = t->bucket_mask;
+    size_t i = (size_t)(h >> 7) & mask;
+    bool found = false;
+    for (size_t step = 1; step <= mask + 1; step++) {
+        ttak_cmap_bucket_t *b = &t->buckets[i];
+        bool hit = false, last = false;
+        size_t val = 0;
+        ttak_backoff_t backoff;
+        ttak_backoff_init(&backoff);
+        for (;;) {
+            uint64_t v = atomic_load_explicit(&b->version, memory_order_acquire);
+            if (v & 1) {
+                ttak_backoff_pause(&backoff);
+                continue;
+            }
+            uint64_t ctrl = atomic_load_explicit(&b->ctrl, memory_order_relaxed);
+            uint64_t match = cmap_match(ctrl, h2);
+            hit = false;
+            while (match) {
+                unsigned s = cmap_next(&match);
+                if (atomic_load_explicit(&b->keys[s], memory_order_relaxed) == key) {
+                    val = atomic_load_explicit(&b->values[s], memory_order_relaxed);
+                    hit = true;
+                    break;
+                }
+            }
+            last = cmap_match_empty(ctrl) != 0;
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&b->version, memory_order_relaxed) == v) break;
+        }
+        if (hit) {
+            if (out) *out = val;
+            found = true;
+            break;
+        }
+        if (last) break;
+        i = (i + step) & mask;
+    }
+    ttak_hazard_clear(&map->hazard, 0);
+    return found;
+}
+
+/**
+ * @brief Remove a key.
+ *
+ * The slot returns to EMPTY when its bucket already has an EMPTY slot,
+ * since no probe can then have continued past the bucket; otherwise it
+ * becomes a tombstone that the next rebuild of the shard drops.
+ *
+ * @param map Map to mutate.
+ * @param key Key to remove.
+ * @return true if the key was present.
+ */
+_Bool ttak_concurrent_map_delete(ttak_concurrent_map_t *map, uintptr_t key) {
+    if (!map) return 0;
+    uint64_t h = cmap_hash(map, key);
+    ttak_shard_t *lock;
+    ttak_cmap_shard_t *sh = cmap_shard(map, h, &lock);
+    ttak_rwlock_wrlock(&lock->lock);
+    ttak_cmap_table_t *t = atomic_load_explicit(&sh->table, memory_order_relaxed);
+    ttak_cmap_bucket_t *b;
+    unsigned s;
+    bool found = cmap_find(t, key, h, &b, &s);
+    if (found) {
+        uint64_t ctrl = atomic_load_explicit(&b->ctrl, memory_order_relaxed);
+        bool to_empty = cmap_match_empty(ctrl) != 0;
+        bucket_write_begin(b);
+        atomic_store_explicit(&b->ctrl, cmap_set_ctrl(ctrl, s, to_empty ? EMPTY : DELETED), memory_order_relaxed);
+        bucket_write_end(b);
+        sh->growth_left += to_empty;
+        atomic_fetch_sub_explicit(&sh->size, 1, memory_order_relaxed);
+    }
+    ttak_rwlock_unlock(&lock->lock);
+    return found;
+}
+
+/**
+ * @brief Sum of the shard sizes.
+ *
+ * @param map Map to query.
+ * @return Number of entries.
+ */
+size_t ttak_concurrent_map_size(ttak_concurrent_map_t *map) {
+    if (!map) return 0;
+    size_t total = 0;
+    for (size_t i = 0; i <= map->shard_mask; i++) {
+        ttak_cmap_shard_t *sh = map->shards[i].data;
+        total += atomic_load_explicit(&sh->size, memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Hand the calling thread's hazard record back to the map.
+ *
+ * @param map Map the thread read from.
+ */
+void ttak_concurrent_map_unregister_thread(ttak_concurrent_map_t *map) {
+    if (!map) return;
+    ttak_hazard_unregister_thread(&map->hazard);
+}
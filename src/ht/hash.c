@@ -1,4 +1,9 @@
 #include <ttak/ht/hash.h>
+#include <pthread.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/random.h>
 
 #define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
 
@@ -48,3 +53,188 @@ uint64_t gen_hash_sip24(uintptr_t key, uint64_t k0, uint64_t k1) {
 
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+/**
+ * @brief Mix a machine word with a multiply-xorshift finalizer.
+ *
+ * @param key  Input key to hash.
+ * @param seed Value folded in before mixing.
+ * @return 64-bit hash suitable for table indexing.
+ */
+uint64_t ttak_hash_mix(uint64_t key, uint64_t seed) {
+    uint64_t x = key ^ seed;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    return x;
+}
+
+static const uint64_t wy_secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+/**
+ * @brief Replace @p a and @p b with the low and high halves of their product.
+ */
+static inline void wy_mum(uint64_t *a, uint64_t *b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t wy_mix(uint64_t a, uint64_t b) {
+    wy_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t wy_r8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t wy_r4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint64_t wy_r3(const uint8_t *p, size_t k) {
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+static inline uint64_t wy_finish(uint64_t a, uint64_t b, uint64_t seed, size_t len) {
+    a ^= wy_secret[1];
+    b ^= seed;
+    wy_mum(&a, &b);
+    return wy_mix(a ^ wy_secret[0] ^ len, b ^ wy_secret[1]);
+}
+
+/**
+ * @brief Hash @p len bytes wyhash-style.
+ *
+ * @param data Input bytes.
+ * @param len  Number of bytes.
+ * @param seed Per-table or per-process seed.
+ * @return 64-bit hash suitable for table indexing.
+ */
+uint64_t ttak_hash_wy(const void *data, size_t len, uint64_t seed) {
+    const uint8_t *p = data;
+    uint64_t a, b;
+    seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t off = (len >> 3) << 2;
+            a = (wy_r4(p) << 32) | wy_r4(p + off);
+            b = (wy_r4(p + len - 4) << 32) | wy_r4(p + len - 4 - off);
+        } else if (len > 0) {
+            a = wy_r3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+                see1 = wy_mix(wy_r8(p + 16) ^ wy_secret[2], wy_r8(p + 24) ^ see1);
+                see2 = wy_mix(wy_r8(p + 32) ^ wy_secret[3], wy_r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = wy_r8(p + i - 16);
+        b = wy_r8(p + i - 8);
+    }
+    return wy_finish(a, b, seed, len);
+}
+
+/**
+ * @brief Hash a machine word; equals ttak_hash_wy over its 8 bytes on little-endian hosts.
+ *
+ * @param key  Input key to hash.
+ * @param seed Per-table or per-process seed.
+ * @return 64-bit hash suitable for table indexing.
+ */
+uint64_t ttak_hash_wy_word(uint64_t key, uint64_t seed) {
+    seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+    uint64_t lo = (uint32_t)key, hi = key >> 32;
+    return wy_finish((lo << 32) | hi, (hi << 32) | lo, seed, 8);
+}
+
+static pthread_once_t process_keys_once = PTHREAD_ONCE_INIT;
+static uint64_t process_keys[2];
+
+/**
+ * @brief Fill the process keys from getrandom, falling back to /dev/urandom and then the clock.
+ */
+static void process_keys_init(void) {
+    if (getrandom(process_keys, sizeof(process_keys), 0) == (ssize_t)sizeof(process_keys)) return;
+
+    FILE *f = fopen("/dev/urandom", "rb");
+    if (f) {
+        size_t got = fread(process_keys, 1, sizeof(process_keys), f);
+        fclose(f);
+        if (got == sizeof(process_keys)) return;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t salt = (uint64_t)(uintptr_t)&ts ^ (uint64_t)(uintptr_t)&process_keys;
+    process_keys[0] = ttak_hash_mix((uint64_t)ts.tv_nsec, salt);
+    process_keys[1] = ttak_hash_mix((uint64_t)ts.tv_sec, process_keys[0]);
+}
+
+/**
+ * @brief Return the process-wide random hash keys.
+ *
+ * @param k0 Receives the first key.
+ * @param k1 Receives the second key.
+ */
+void ttak_hash_process_keys(uint64_t *k0, uint64_t *k1) {
+    pthread_once(&process_keys_once, process_keys_init);
+    if (k0) *k0 = process_keys[0];
+    if (k1) *k1 = process_keys[1];
+}
+
+/**
+ * @brief Hash a machine word under @p policy.
+ *
+ * @param policy Hash family.
+ * @param key    Input key to hash.
+ * @param k0     First key (seed of the mixer and wyhash policies).
+ * @param k1     Second key (SipHash only).
+ * @return 64-bit hash suitable for table indexing.
+ */
+uint64_t ttak_hash_word(ttak_hash_policy_t policy, uintptr_t key, uint64_t k0, uint64_t k1) {
+    switch (policy) {
+        case TTAK_HASH_MIX:
+            return ttak_hash_mix((uint64_t)key, k0);
+        case TTAK_HASH_WYHASH:
+            return ttak_hash_wy_word((uint64_t)key, k0);
+        case TTAK_HASH_SIPHASH:
+        default:
+            return gen_hash_sip24(key, k0, k1);
+    }
+}
@@ -1,6 +1,14 @@
 /**
  * @file map.c
- * @brief Implementation of a hash map using open addressing and SipHash-2-4.
+ * @brief Swiss-table hash map with per-map hash policy and group-wise probing.
+ *
+ * A key's hash is split into H1 (the upper 57 bits, which pick the first
+ * group to probe) and H2 (the low 7 bits, stored in the slot's control
+ * byte). Lookups compare H2 against a whole group of 16 control bytes at
+ * once (SSE2 or NEON, with a portable scalar fallback) and only touch the
+ * key array for the matching slots. Probing visits groups in triangular
+ * order, which covers every group of a power-of-two table, and stops at the
+ * first group that still has an EMPTY slot.
  */
 
 #include <ttak/ht/hash.h>
@@ -8,6 +16,100 @@
 #include <ttak/mem/mem.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TTAK_MAP_NEON 1
+#endif
+
+/**
+ * @brief Bitmask with one entry per control byte of a group.
+ *
+ * SSE2 and the scalar path use one bit per byte; NEON narrows a compare to
+ * one nibble per byte, so its entries are four bits apart.
+ */
+#if defined(TTAK_MAP_NEON)
+typedef uint64_t map_bits_t;
+#define MAP_BITS_SHIFT 2
+#else
+typedef uint32_t map_bits_t;
+#define MAP_BITS_SHIFT 0
+#endif
+
+/**
+ * @brief Pops the lowest set entry of @p bits and returns its slot offset.
+ */
+static inline unsigned map_bits_next(map_bits_t *bits) {
+#if defined(TTAK_MAP_NEON)
+    unsigned offset = (unsigned)__builtin_ctzll(*bits) >> MAP_BITS_SHIFT;
+#else
+    unsigned offset = (unsigned)__builtin_ctz(*bits);
+#endif
+    *bits &= *bits - 1;
+    return offset;
+}
+
+#if defined(__SSE2__)
+
+static inline map_bits_t group_match(const uint8_t *group, uint8_t h2) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (map_bits_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+}
+
+static inline map_bits_t group_match_empty(const uint8_t *group) {
+    return group_match(group, EMPTY);
+}
+
+static inline map_bits_t group_match_free(const uint8_t *group) {
+    // EMPTY and DELETED are the only control bytes with the sign bit set.
+    return (map_bits_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+}
+
+#elif defined(TTAK_MAP_NEON)
+
+static inline map_bits_t neon_mask(uint8x16_t eq) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+}
+
+static inline map_bits_t group_match(const uint8_t *group, uint8_t h2) {
+    return neon_mask(vceqq_u8(vld1q_u8(group), vdupq_n_u8(h2)));
+}
+
+static inline map_bits_t group_match_empty(const uint8_t *group) {
+    return group_match(group, EMPTY);
+}
+
+static inline map_bits_t group_match_free(const uint8_t *group) {
+    return neon_mask(vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(group)), vdupq_n_s8(0)));
+}
+
+#else
+
+static inline map_bits_t group_match(const uint8_t *group, uint8_t h2) {
+    map_bits_t bits = 0;
+    for (unsigned i = 0; i < TTAK_MAP_GROUP_WIDTH; i++) {
+        bits |= (map_bits_t)(group[i] == h2) << i;
+    }
+    return bits;
+}
+
+static inline map_bits_t group_match_empty(const uint8_t *group) {
+    return group_match(group, EMPTY);
+}
+
+static inline map_bits_t group_match_free(const uint8_t *group) {
+    map_bits_t bits = 0;
+    for (unsigned i = 0; i < TTAK_MAP_GROUP_WIDTH; i++) {
+        bits |= (map_bits_t)(group[i] >> 7) << i;
+    }
+    return bits;
+}
+
+#endif
 
 /**
  * @brief Round up to the next power-of-two capacity.
@@ -30,55 +132,297 @@ static size_t next_pow2(size_t n) {
     return n;
 }
 
+static inline uint64_t map_hash(const tt_map_t *map, uintptr_t key) {
+    return ttak_hash_word(map->hash_policy, key, map->hash_k0, map->hash_k1);
+}
+
+/**
+ * @brief Entries a table of @p cap slots holds before it is rehashed (7/8 load).
+ */
+static inline size_t map_capacity_to_growth(size_t cap) {
+    return cap - cap / 8;
+}
+
+/**
+ * @brief Groups of the old table moved per update while a shrink drains it.
+ */
+#define MAP_DRAIN_GROUPS 4
+
+static inline uintptr_t *map_table_keys(uint8_t *ctrl, size_t cap) {
+    return (uintptr_t *)(ctrl + cap);
+}
+
+static inline size_t *map_table_values(uint8_t *ctrl, size_t cap) {
+    return (size_t *)(ctrl + cap + cap * sizeof(uintptr_t));
+}
+
+/**
+ * @brief Allocate an all-EMPTY table of @p cap slots into @p map.
+ *
+ * Only the table fields are set; size and any old table are left alone.
+ *
+ * @return false on allocation failure (the map is left untouched).
+ */
+static bool map_alloc_table(tt_map_t *map, size_t cap, uint64_t now) {
+    if (cap > SIZE_MAX / (1 + sizeof(uintptr_t) + sizeof(size_t))) return false;
+    uint8_t *ctrl = ttak_mem_alloc(cap * (1 + sizeof(uintptr_t) + sizeof(size_t)), __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!ctrl) return false;
+    memset(ctrl, EMPTY, cap);
+    map->ctrl = ctrl;
+    map->keys = map_table_keys(ctrl, cap);
+    map->values = map_table_values(ctrl, cap);
+    map->cap = cap;
+    map->growth_left = map_capacity_to_growth(cap);
+    return true;
+}
+
+/**
+ * @brief Find the first EMPTY or DELETED slot on the probe sequence of @p hash.
+ */
+static size_t map_find_free(const uint8_t *ctrl, size_t cap, uint64_t hash) {
+    size_t group_mask = cap / TTAK_MAP_GROUP_WIDTH - 1;
+    size_t group = (size_t)(hash >> 7) & group_mask;
+    for (size_t step = 1;; step++) {
+        size_t base = group * TTAK_MAP_GROUP_WIDTH;
+        map_bits_t free_bits = group_match_free(ctrl + base);
+        if (free_bits) return base + map_bits_next(&free_bits);
+        group = (group + step) & group_mask;
+    }
+}
+
+/**
+ * @brief Locate @p key in the table @p ctrl / @p keys of @p cap slots.
+ *
+ * @return The slot index, or SIZE_MAX if the key is absent.
+ */
+static size_t map_find(const uint8_t *ctrl, const uintptr_t *keys, size_t cap, uintptr_t key, uint64_t hash) {
+    uint8_t h2 = (uint8_t)(hash & 0x7F);
+    size_t groups = cap / TTAK_MAP_GROUP_WIDTH;
+    size_t group = (size_t)(hash >> 7) & (groups - 1);
+    for (size_t step = 1; step <= groups; step++) {
+        size_t base = group * TTAK_MAP_GROUP_WIDTH;
+        const uint8_t *g = ctrl + base;
+        map_bits_t match = group_match(g, h2);
+        while (match) {
+            size_t slot = base + map_bits_next(&match);
+            if (keys[slot] == key) return slot;
+        }
+        if (group_match_empty(g)) break;
+        group = (group + step) & (groups - 1);
+    }
+    return SIZE_MAX;
+}
+
+/**
+ * @brief Locate @p key in the table being drained.
+ *
+ * @return The slot index in old_ctrl, or SIZE_MAX if absent or no shrink is running.
+ */
+static size_t map_find_old(const tt_map_t *map, uintptr_t key, uint64_t hash) {
+    if (!map->old_ctrl) return SIZE_MAX;
+    return map_find(map->old_ctrl, map_table_keys(map->old_ctrl, map->old_cap), map->old_cap, key, hash);
+}
+
 /**
- * @brief Allocate and initialize a hash map.
+ * @brief Store a key known to be absent into the first free slot of its probe sequence.
+ *
+ * The caller accounts for the entry in map->size.
+ */
+static void map_place(tt_map_t *map, uintptr_t key, size_t val, uint64_t hash) {
+    size_t slot = map_find_free(map->ctrl, map->cap, hash);
+    map->growth_left -= (map->ctrl[slot] == EMPTY);
+    map->ctrl[slot] = (uint8_t)(hash & 0x7F);
+    map->keys[slot] = key;
+    map->values[slot] = val;
+}
+
+/**
+ * @brief Move every entry, including any still in the old table, into a fresh table of @p new_cap slots.
+ *
+ * Tombstones are dropped on the way.
+ *
+ * @return false if the new table could not be allocated (the map is unchanged).
+ */
+static bool map_rehash(tt_map_t *map, size_t new_cap, uint64_t now) {
+    tt_map_t old = *map;
+    if (!map_alloc_table(map, new_cap, now)) return false;
+    for (size_t i = 0; i < old.cap; i++) {
+        if (!(old.ctrl[i] & 0x80)) {
+            map_place(map, old.keys[i], old.values[i], map_hash(map, old.keys[i]));
+        }
+    }
+    if (old.old_ctrl) {
+        uintptr_t *keys = map_table_keys(old.old_ctrl, old.old_cap);
+        size_t *values = map_table_values(old.old_ctrl, old.old_cap);
+        for (size_t i = old.old_next; i < old.old_cap; i++) {
+            if (!(old.old_ctrl[i] & 0x80)) {
+                map_place(map, keys[i], values[i], map_hash(map, keys[i]));
+            }
+        }
+        ttak_mem_free(old.old_ctrl);
+        map->old_ctrl = NULL;
+        map->old_cap = 0;
+        map->old_next = 0;
+    }
+    ttak_mem_free(old.ctrl);
+    return true;
+}
+
+/**
+ * @brief Clear tombstones without allocating, by re-placing entries within the table.
+ *
+ * Every full slot is first marked DELETED ("not yet placed") and every
+ * tombstone EMPTY. Each pending entry then goes to the first free slot on
+ * its probe sequence: it stays put if that slot is in its own group, moves
+ * if the slot is EMPTY, and otherwise swaps with the pending entry there,
+ * which is placed next.
+ */
+static void map_drop_tombstones(tt_map_t *map) {
+    for (size_t i = 0; i < map->cap; i++) {
+        map->ctrl[i] = (map->ctrl[i] & 0x80) ? EMPTY : DELETED;
+    }
+    for (size_t i = 0; i < map->cap; i++) {
+        if (map->ctrl[i] != DELETED) continue;
+        uint64_t h = map_hash(map, map->keys[i]);
+        uint8_t h2 = (uint8_t)(h & 0x7F);
+        size_t target = map_find_free(map->ctrl, map->cap, h);
+        if (target / TTAK_MAP_GROUP_WIDTH == i / TTAK_MAP_GROUP_WIDTH) {
+            map->ctrl[i] = h2;
+            continue;
+        }
+        if (map->ctrl[target] == EMPTY) {
+            map->ctrl[target] = h2;
+            map->keys[target] = map->keys[i];
+            map->values[target] = map->values[i];
+            map->ctrl[i] = EMPTY;
+            continue;
+        }
+        uintptr_t key = map->keys[target];
+        size_t val = map->values[target];
+        map->ctrl[target] = h2;
+        map->keys[target] = map->keys[i];
+        map->values[target] = map->values[i];
+        map->keys[i] = key;
+        map->values[i] = val;
+        i--; // The entry swapped in is still pending.
+    }
+    map->growth_left = map_capacity_to_growth(map->cap) - map->size;
+}
+
+/**
+ * @brief Make room for one more EMPTY slot to be filled.
+ *
+ * Doubles the table when it is more than half full of live entries.
+ * Otherwise the growth budget was spent on tombstones, which are cleared
+ * in place. A pending shrink is finished by the same rehash.
+ *
+ * @param map Map to resize.
+ * @param now Timestamp required by the allocator.
+ */
+static void ttak_resize_map(tt_map_t *map, uint64_t now) {
+    if (map->size * 2 > map_capacity_to_growth(map->cap)) {
+        map_rehash(map, map->cap * 2, now);
+    } else if (map->old_ctrl) {
+        map_rehash(map, map->cap, now);
+    } else {
+        map_drop_tombstones(map);
+    }
+}
+
+/**
+ * @brief Move the next MAP_DRAIN_GROUPS groups of a pending shrink into the current table.
+ *
+ * Drained slots become tombstones in the old table so that probes for the
+ * entries still there keep running past them. The old table is freed once
+ * its last group has moved.
+ */
+static void map_drain_step(tt_map_t *map, uint64_t now) {
+    if (!map->old_ctrl) return;
+    uintptr_t *keys = map_table_keys(map->old_ctrl, map->old_cap);
+    size_t *values = map_table_values(map->old_ctrl, map->old_cap);
+    size_t end = map->old_next + MAP_DRAIN_GROUPS * TTAK_MAP_GROUP_WIDTH;
+    if (end > map->old_cap) end = map->old_cap;
+
+    for (size_t i = map->old_next; i < end; i++) {
+        if (map->old_ctrl[i] & 0x80) continue;
+        uint64_t h = map_hash(map, keys[i]);
+        if (map->growth_left == 0 && map->ctrl[map_find_free(map->ctrl, map->cap, h)] == EMPTY) {
+            map->old_next = i;
+            ttak_resize_map(map, now); // Rehashes the rest of the old table as well
+            return;
+        }
+        map_place(map, keys[i], values[i], h);
+        map->old_ctrl[i] = DELETED;
+    }
+    map->old_next = end;
+    if (end == map->old_cap) {
+        ttak_mem_free(map->old_ctrl);
+        map->old_ctrl = NULL;
+        map->old_cap = 0;
+        map->old_next = 0;
+    }
+}
+
+/**
+ * @brief Start draining the table into one of @p new_cap slots.
+ *
+ * @return false if the new table could not be allocated (the map is unchanged).
+ */
+static bool map_begin_shrink(tt_map_t *map, size_t new_cap, uint64_t now) {
+    uint8_t *old_ctrl = map->ctrl;
+    size_t old_cap = map->cap;
+    if (!map_alloc_table(map, new_cap, now)) return false;
+    map->old_ctrl = old_ctrl;
+    map->old_cap = old_cap;
+    map->old_next = 0;
+    return true;
+}
+
+/**
+ * @brief Allocate and initialize a hash map with keyed SipHash.
  *
  * @param init_cap Desired initial capacity.
  * @param now      Timestamp for memory tracker integration.
  * @return Newly created map or NULL on allocation failure.
  */
 tt_map_t *ttak_create_map(size_t init_cap, uint64_t now) {
+    return ttak_create_map_with_hash(init_cap, TTAK_HASH_SIPHASH, now);
+}
+
+/**
+ * @brief Allocate and initialize a hash map that hashes keys with @p policy.
+ *
+ * @param init_cap Desired initial capacity.
+ * @param policy   Key hash; seeded with the per-process random keys.
+ * @param now      Timestamp for memory tracker integration.
+ * @return Newly created map or NULL on allocation failure.
+ */
+tt_map_t *ttak_create_map_with_hash(size_t init_cap, ttak_hash_policy_t policy, uint64_t now) {
     tt_map_t *map = ttak_mem_alloc(sizeof(tt_map_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
     if (!map) return NULL;
-    
-    map->cap = next_pow2(init_cap);
-    map->size = 0;
-    
-    map->tbl = ttak_mem_alloc(map->cap * sizeof(tt_nd_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!map->tbl) {
+
+    size_t cap = next_pow2(init_cap);
+    if (cap < TTAK_MAP_GROUP_WIDTH) cap = TTAK_MAP_GROUP_WIDTH;
+    memset(map, 0, sizeof(*map));
+    map->hash_policy = policy;
+    ttak_hash_process_keys(&map->hash_k0, &map->hash_k1);
+    if (!map_alloc_table(map, cap, now)) {
         ttak_mem_free(map);
         return NULL;
     }
-    memset(map->tbl, 0, map->cap * sizeof(tt_nd_t));
     return map;
 }
 
 /**
- * @brief Grow the map when the load factor becomes high.
+ * @brief Free a map and its table.
  *
- * @param map Map to resize.
- * @param now Timestamp required by the allocator.
+ * @param map Map to destroy (may be NULL).
  */
-static void ttak_resize_map(tt_map_t *map, uint64_t now) {
-    size_t old_cap = map->cap;
-    size_t new_cap = old_cap * 2; // Always maintain power of 2
-    ttak_node_t *old_tbl = map->tbl;
-    
-    ttak_node_t *new_tbl = ttak_mem_alloc(new_cap * sizeof(tt_nd_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!new_tbl) return;
-    memset(new_tbl, 0, new_cap * sizeof(tt_nd_t));
-
-    map->tbl = new_tbl;
-    map->cap = new_cap;
-    map->size = 0; // Re-calculate size during insertions
-
-    for (size_t i = 0; i < old_cap; i++) {
-        if (old_tbl[i].ctrl == OCCUPIED) {
-            ttak_insert_to_map(map, old_tbl[i].key, old_tbl[i].value, now);
-        }
-    }
-    
-    ttak_mem_free(old_tbl);
+void ttak_destroy_map(tt_map_t *map) {
+    if (!map) return;
+    ttak_mem_free(map->old_ctrl);
+    ttak_mem_free(map->ctrl);
+    ttak_mem_free(map);
 }
 
 /**
@@ -91,26 +435,32 @@ static void ttak_resize_map(tt_map_t *map, uint64_t now) {
  */
 void ttak_insert_to_map(tt_map_t *map, uintptr_t key, size_t val, uint64_t now) {
     if (!ttak_mem_access(map, now)) return;
-    if (map->size * 10 >= map->cap * 7) {
-        ttak_resize_map(map, now);
+    map_drain_step(map, now);
+    uint64_t h = map_hash(map, key);
+    size_t slot = map_find(map->ctrl, map->keys, map->cap, key, h);
+    if (slot != SIZE_MAX) {
+        map->values[slot] = val;
+        ttak_mem_unpin(map);
+        return;
+    }
+    slot = map_find_old(map, key, h);
+    if (slot != SIZE_MAX) {
+        map_table_values(map->old_ctrl, map->old_cap)[slot] = val; // Moves with its group
+        ttak_mem_unpin(map);
+        return;
     }
-    uint64_t h   = gen_hash_sip24(key, 0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL);
-    size_t   idx = h & (map->cap - 1);
-    size_t s_idx = idx;
 
-    while(map->tbl[idx].ctrl == OCCUPIED) {
-        if( map->tbl[idx].key == key) {
-            map->tbl[idx].value = val;
+    // Only filling an EMPTY slot spends growth; reusing a tombstone is free.
+    if (map->growth_left == 0 && map->ctrl[map_find_free(map->ctrl, map->cap, h)] == EMPTY) {
+        ttak_resize_map(map, now);
+        if (map->growth_left == 0) {
+            ttak_mem_unpin(map); // Table full and could not grow
             return;
         }
-        idx = (idx + 1) & (map->cap - 1);
-        if (idx == s_idx) return; // Table full
     }
-
-    map->tbl[idx].key   = key;
-    map->tbl[idx].value = val;
-    map->tbl[idx].ctrl  = OCCUPIED;
+    map_place(map, key, val, h);
     map->size++;
+    ttak_mem_unpin(map);
 }
 
 /**
@@ -123,76 +473,64 @@ void ttak_insert_to_map(tt_map_t *map, uintptr_t key, size_t val, uint64_t now)
  * @return true if the key exists, false otherwise.
  */
 _Bool ttak_map_get_key(tt_map_t *map, uintptr_t key, size_t *out, uint64_t now) {
-    if (!ttak_mem_access(map, now) || !map->tbl) return 0;
-    uint64_t h   = gen_hash_sip24(key, 0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL);
-    size_t   idx = h & (map->cap - 1);
-    size_t s_idx = idx;
-
-    while (map->tbl[idx].ctrl != EMPTY) {
-        if(
-           (map->tbl[idx].ctrl == OCCUPIED) &&
-           (map->tbl[idx].key == key      ))
-        {
-            if (out) *out = map->tbl[idx].value;
-            return (_Bool)1;
-        }
-        idx = (idx + 1) & (map->cap - 1);
-        if(idx == s_idx) break;
+    if (!ttak_mem_access(map, now)) return 0;
+    if (!map->ctrl) {
+        ttak_mem_unpin(map);
+        return 0;
+    }
+    uint64_t h = map_hash(map, key);
+    size_t slot = map_find(map->ctrl, map->keys, map->cap, key, h);
+    const size_t *values = map->values;
+    if (slot == SIZE_MAX && (slot = map_find_old(map, key, h)) != SIZE_MAX) {
+        values = map_table_values(map->old_ctrl, map->old_cap);
     }
-    return (_Bool)0;
+    if (slot != SIZE_MAX && out) *out = values[slot];
+    ttak_mem_unpin(map);
+    return slot != SIZE_MAX;
 }
 
 /**
  * @brief Remove an entry from the map and shrink when sparsity is high.
  *
+ * The slot goes straight back to EMPTY when its group still has an EMPTY
+ * slot, because no probe can then have run past that group; only slots in
+ * full groups become tombstones. A shrink allocates the smaller table and
+ * then drains into it a few groups per update instead of all at once.
+ *
  * @param map Map to update.
  * @param key Key to remove.
  * @param now Timestamp for memory tracking.
  */
 void ttak_delete_from_map(tt_map_t *map, uintptr_t key, uint64_t now) {
-    if (!ttak_mem_access(map, now) || !map->tbl) return;
-    uint64_t h   = gen_hash_sip24(key, 0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL);
-    size_t   idx = h & (map->cap - 1);
-    size_t s_idx = idx;
-    _Bool  found = 0;
-
-    while (map->tbl[idx].ctrl != EMPTY) {
-        if(
-           (map->tbl[idx].ctrl == OCCUPIED) &&
-           (map->tbl[idx].key == key      ))
-        {
-            found = 1;
-            break;
+    if (!ttak_mem_access(map, now)) return;
+    if (!map->ctrl) {
+        ttak_mem_unpin(map);
+        return;
+    }
+    map_drain_step(map, now);
+    uint64_t h = map_hash(map, key);
+    size_t slot = map_find(map->ctrl, map->keys, map->cap, key, h);
+    if (slot != SIZE_MAX) {
+        size_t base = slot & ~(size_t)(TTAK_MAP_GROUP_WIDTH - 1);
+        if (group_match_empty(map->ctrl + base)) {
+            map->ctrl[slot] = EMPTY;
+            map->growth_left++;
+        } else {
+            map->ctrl[slot] = DELETED;
         }
-        idx = (idx + 1) & (map->cap - 1);
-        if(idx == s_idx) break;
+    } else if ((slot = map_find_old(map, key, h)) != SIZE_MAX) {
+        map->old_ctrl[slot] = DELETED; // The old table only ever gains tombstones
+    } else {
+        ttak_mem_unpin(map);
+        return;
     }
-    if(!found) return;
-
-    map->tbl[idx].ctrl = DELETED;
     map->size--;
 
-    if (map->size > 0) {
+    if (map->size > 0 && !map->old_ctrl) {
         size_t diff = map->cap / map->size;
-        if(diff > 4 && map->cap > 1024) { // Only shrink if very sparse and large
-             size_t old_cap = map->cap;
-             size_t new_cap = old_cap / 2; 
-             if (new_cap >= 8192) {
-                 ttak_node_t *old_tbl = map->tbl;
-                 ttak_node_t *new_tbl = ttak_mem_alloc(new_cap * sizeof(tt_nd_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-                 if (new_tbl) {
-                     memset(new_tbl, 0, new_cap * sizeof(tt_nd_t));
-                     map->tbl = new_tbl;
-                     map->cap = new_cap;
-                     map->size = 0;
-                     for (size_t i = 0; i < old_cap; i++) {
-                         if (old_tbl[i].ctrl == OCCUPIED) {
-                             ttak_insert_to_map(map, old_tbl[i].key, old_tbl[i].value, now);
-                         }
-                     }
-                     ttak_mem_free(old_tbl);
-                 }
-             }
+        if (diff > 4 && map->cap > 1024 && map->cap / 2 >= 8192) { // Only shrink if very sparse and large
+            map_begin_shrink(map, map->cap / 2, now);
         }
     }
+    ttak_mem_unpin(map);
 }
@@ -1,5 +1,6 @@
 #include <ttak/ht/table.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/huge.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -119,8 +120,8 @@ void ttak_table_init(ttak_table_t *table, size_t capacity,
     table->key_free = key_free;
     table->val_free = val_free;
 
-    // Use huge pages for large tables if possible
-    ttak_mem_flags_t flags = (capacity * sizeof(ttak_table_entry_t *) >= 2 * 1024 * 1024) ? TTAK_MEM_HUGE_PAGES : TTAK_MEM_DEFAULT;
+    // Large bucket arrays are carved from pooled huge-page regions
+    ttak_mem_flags_t flags = (table->capacity * sizeof(ttak_table_entry_t *) >= TTAK_HUGE_HINT_MIN) ? TTAK_MEM_HUGE_PAGES : TTAK_MEM_DEFAULT;
     table->buckets = ttak_mem_alloc_safe(sizeof(ttak_table_entry_t *) * table->capacity, __TTAK_UNSAFE_MEM_FOREVER__, 0, false, false, true, true, flags);
     
     // Explicitly zero out buckets (though mem_alloc usually zeros, safe to ensure)
@@ -154,9 +155,12 @@ void ttak_table_put(ttak_table_t *table, void *key, size_t key_len, void *value,
             // Update value
             if (table->val_free && entry->value) table->val_free(entry->value);
             entry->value = value;
+            ttak_mem_unpin(entry);
             return;
         }
-        entry = entry->next;
+        ttak_table_entry_t *next = entry->next;
+        ttak_mem_unpin(entry);
+        entry = next;
     }
 
     // New entry
@@ -189,9 +193,13 @@ void *ttak_table_get(ttak_table_t *table, const void *key, size_t key_len, uint6
     while (entry) {
         if (!ttak_mem_access(entry, now)) return NULL;
         if (table->key_cmp(entry->key, key) == 0) {
-            return entry->value;
+            void *value = entry->value;
+            ttak_mem_unpin(entry);
+            return value;
         }
-        entry = entry->next;
+        ttak_table_entry_t *next = entry->next;
+        ttak_mem_unpin(entry);
+        entry = next;
     }
     return NULL;
 }
@@ -227,12 +235,14 @@ bool ttak_table_remove(ttak_table_t *table, const void *key, size_t key_len, uin
             if (table->key_free && entry->key) table->key_free(entry->key);
             if (table->val_free && entry->value) table->val_free(entry->value);
             
+            ttak_mem_unpin(entry);
             ttak_mem_free(entry);
             table->size--;
             return true;
         }
         prev = entry;
         entry = entry->next;
+        ttak_mem_unpin(prev);
     }
     return false;
 }
@@ -253,6 +263,7 @@ void ttak_table_destroy(ttak_table_t *table, uint64_t now) {
             if (ttak_mem_access(entry, now)) {
                 if (table->key_free && entry->key) table->key_free(entry->key);
                 if (table->val_free && entry->value) table->val_free(entry->value);
+                ttak_mem_unpin(entry);
                 ttak_mem_free(entry);
             }
             entry = next;
@@ -0,0 +1,1029 @@
+/**
+ * @file wal.c
+ * @brief Group-commit write-ahead log over a flat state image.
+ *
+ * Every commit becomes one CRC-protected record of byte patches. Records are
+ * queued under the log mutex in LSN order; whichever committer finds no flush
+ * in progress becomes the leader and appends the whole queue with writev,
+ * followed by one fdatasync that acknowledges every record in it. Segments
+ * are rotated past a size limit and, once enough of them are closed, folded
+ * into a snapshot written with the usual tmp + fsync + rename + directory
+ * fsync sequence. The snapshot holds the image as of its LSN, so recovery
+ * skips the records it already covers.
+ */
+
+#include <ttak/log/wal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#define WAL_MAGIC 0x314C4157U /* "WAL1" */
+#define WAL_SNAP_MAGIC 0x31504E53U /* "SNP1" */
+#define WAL_INLINE_RANGES 8
+#define WAL_DIFF_BLOCK 64
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/**
+ * @brief On-disk record header; followed by range descriptors, then their bytes.
+ */
+typedef struct wal_record_header {
+    uint32_t magic;             /**< WAL_MAGIC */
+    uint32_t crc;               /**< CRC32C of the payload, then of the fields below. */
+    uint64_t lsn;               /**< Log sequence number, increasing across segments. */
+    uint64_t state_size;        /**< Image size after the record. */
+    uint64_t payload_len;       /**< Descriptor and data bytes that follow. */
+    uint32_t range_count;       /**< Number of descriptors. */
+    uint32_t reserved;
+} wal_record_header_t;
+
+typedef struct wal_range_desc {
+    uint64_t offset;
+    uint64_t len;
+} wal_range_desc_t;
+
+_Static_assert(sizeof(wal_record_header_t) == 40, "record header layout is part of the file format");
+
+/**
+ * @brief On-disk snapshot header; followed by the image bytes.
+ */
+typedef struct wal_snapshot_header {
+    uint32_t magic;             /**< WAL_SNAP_MAGIC */
+    uint32_t crc;               /**< CRC32C of the image, then of the fields below. */
+    uint64_t lsn;               /**< Last record folded into the image. */
+    uint64_t size;              /**< Image bytes that follow. */
+} wal_snapshot_header_t;
+
+_Static_assert(sizeof(wal_snapshot_header_t) == 24, "snapshot header layout is part of the file format");
+
+/**
+ * @brief A commit waiting in the queue; lives on the committer's stack.
+ */
+typedef struct wal_request {
+    struct wal_request *next;
+    wal_record_header_t header;
+    const ttak_wal_range_t *ranges;
+    wal_range_desc_t *descs;
+    size_t count;
+    uint32_t payload_crc;
+    int done;
+    int status;
+} wal_request_t;
+
+struct ttak_wal {
+    char *path;
+    ttak_wal_options_t opts;
+    pthread_mutex_t lock;
+    pthread_cond_t flushed;
+
+    uint8_t *image;             /**< Current state, including queued records. */
+    size_t size;
+    size_t cap;
+
+    wal_request_t *queue;       /**< Records not yet handed to a leader. */
+    wal_request_t **queue_tail;
+    uint64_t next_lsn;
+    int flushing;               /**< A leader owns the segment descriptor. */
+    int compacting;
+    int draining;               /**< New records wait until the image is durable. */
+    int failed;                 /**< Sticky: an append or sync failed. */
+
+    int fd;                     /**< Active segment. */
+    int lock_fd;                /**< "<path>.lock", flocked for the life of the handle. */
+    uint64_t seg_seq;
+    uint64_t seg_bytes;
+    uint64_t first_seq;         /**< Oldest segment still on disk. */
+
+    ttak_wal_stats_t stats;
+};
+
+/* ------------------------------------------------------------------------- */
+/* CRC32C                                                                    */
+/* ------------------------------------------------------------------------- */
+
+#if !defined(__SSE4_2__)
+static uint32_t crc32c_table[256];
+static pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+
+static void crc32c_init_table(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ 0x82F63B78U : c >> 1;
+        }
+        crc32c_table[i] = c;
+    }
+}
+#endif
+
+/**
+ * @brief Extends a CRC32C (Castagnoli) over @p len bytes.
+ */
+static uint32_t crc32c(uint32_t crc, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    crc = ~crc;
+#if defined(__SSE4_2__)
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)c;
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+#else
+    pthread_once(&crc32c_once, crc32c_init_table);
+    while (len--) {
+        crc = crc32c_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+#endif
+    return ~crc;
+}
+
+static uint32_t record_crc(uint32_t payload_crc, const wal_record_header_t *h) {
+    return crc32c(payload_crc, &h->lsn, sizeof(*h) - offsetof(wal_record_header_t, lsn));
+}
+
+static uint32_t snapshot_crc(const uint8_t *image, const wal_snapshot_header_t *h) {
+    uint32_t crc = crc32c(0, image, (size_t)h->size);
+    return crc32c(crc, &h->lsn, sizeof(*h) - offsetof(wal_snapshot_header_t, lsn));
+}
+
+/* ------------------------------------------------------------------------- */
+/* File helpers                                                              */
+/* ------------------------------------------------------------------------- */
+
+static int segment_name(const ttak_wal_t *wal, uint64_t seq, char *buf, size_t cap) {
+    int n = snprintf(buf, cap, "%s.wal.%016" PRIx64, wal->path, seq);
+    return (n > 0 && (size_t)n < cap) ? 0 : -1;
+}
+
+/**
+ * @brief Splits @p path into its directory and the base name prefix of its segments.
+ */
+static void split_path(const char *path, char *dir, size_t dir_cap, const char **base) {
+    const char *slash = strrchr(path, '/');
+    if (!slash) {
+        snprintf(dir, dir_cap, ".");
+        *base = path;
+    } else if (slash == path) {
+        snprintf(dir, dir_cap, "/");
+        *base = slash + 1;
+    } else {
+        snprintf(dir, dir_cap, "%.*s", (int)(slash - path), path);
+        *base = slash + 1;
+    }
+}
+
+/**
+ * @brief Makes a create, rename or unlink in the directory of @p path durable.
+ */
+static void sync_dir(const char *path) {
+    char dir[PATH_MAX];
+    const char *base;
+    split_path(path, dir, sizeof(dir), &base);
+    int dfd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (dfd >= 0) {
+        fsync(dfd);
+        close(dfd);
+    }
+}
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes an iovec array completely, in IOV_MAX sized calls.
+ */
+static int writev_all(int fd, struct iovec *iov, size_t count) {
+    while (count) {
+        int chunk = count > IOV_MAX ? IOV_MAX : (int)count;
+        ssize_t n = writev(fd, iov, chunk);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        size_t left = (size_t)n;
+        while (count && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (left) {
+            iov->iov_base = (char *)iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+    return 0;
+}
+
+static int open_segment(const ttak_wal_t *wal, uint64_t seq) {
+    char name[PATH_MAX];
+    if (segment_name(wal, seq, name, sizeof(name)) != 0) return -1;
+    int fd = open(name, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd >= 0) sync_dir(wal->path);
+    return fd;
+}
+
+/* ------------------------------------------------------------------------- */
+/* State image                                                               */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Resizes the image, zero-filling any growth.
+ */
+static int image_resize(ttak_wal_t *wal, uint64_t new_size) {
+    if (new_size > SIZE_MAX) return -1;
+    if (new_size > wal->cap) {
+        size_t cap = wal->cap ? wal->cap : 4096;
+        while (cap < new_size) {
+            cap = cap > SIZE_MAX / 2 ? (size_t)new_size : cap * 2;
+        }
+        uint8_t *grown = realloc(wal->image, cap);
+        if (!grown) return -1;
+        wal->image = grown;
+        wal->cap = cap;
+    }
+    if (new_size > wal->size) {
+        memset(wal->image + wal->size, 0, (size_t)new_size - wal->size);
+    }
+    wal->size = (size_t)new_size;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Group commit                                                              */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Appends and syncs every queued record. Called with the lock held and
+ *        flushing set; drops the lock around the I/O.
+ */
+static void wal_lead(ttak_wal_t *wal) {
+    while (wal->queue) {
+        wal_request_t *batch = wal->queue;
+        wal->queue = NULL;
+        wal->queue_tail = &wal->queue;
+
+        int fd = wal->fd;
+        uint64_t seq = wal->seg_seq;
+        int rotate = wal->seg_bytes >= wal->opts.segment_bytes;
+        int failed = wal->failed;
+        pthread_mutex_unlock(&wal->lock);
+
+        size_t iov_count = 0;
+        uint64_t bytes = 0;
+        uint64_t last_lsn = 0;
+        for (wal_request_t *r = batch; r; r = r->next) {
+            iov_count += 2 + r->count;
+        }
+        struct iovec *iov = failed ? NULL : malloc(sizeof(*iov) * iov_count);
+        int status = iov ? 0 : -1;
+
+        if (status == 0 && rotate) {
+            int next_fd = open_segment(wal, seq + 1);
+            if (next_fd >= 0) {
+                close(fd);
+                fd = next_fd;
+                seq++;
+            } else {
+                rotate = 0; // Keep appending to the full segment rather than failing.
+            }
+        }
+
+        if (status == 0) {
+            size_t n = 0;
+            for (wal_request_t *r = batch; r; r = r->next) {
+                iov[n].iov_base = &r->header;
+                iov[n++].iov_len = sizeof(r->header);
+                iov[n].iov_base = r->descs;
+                iov[n++].iov_len = sizeof(wal_range_desc_t) * r->count;
+                for (size_t i = 0; i < r->count; i++) {
+                    iov[n].iov_base = (void *)r->ranges[i].data;
+                    iov[n++].iov_len = r->ranges[i].len;
+                }
+                bytes += sizeof(r->header) + r->header.payload_len;
+                last_lsn = r->header.lsn;
+            }
+            if (writev_all(fd, iov, n) != 0 || fdatasync(fd) != 0) {
+                status = -1;
+            }
+        }
+        free(iov);
+
+        pthread_mutex_lock(&wal->lock);
+        if (rotate) {
+            wal->fd = fd;
+            wal->seg_seq = seq;
+            wal->seg_bytes = 0;
+        }
+        if (status == 0) {
+            wal->seg_bytes += bytes;
+            wal->stats.bytes_logged += bytes;
+            wal->stats.syncs++;
+            wal->stats.durable_lsn = last_lsn;
+        } else {
+            wal->failed = 1;
+        }
+        for (wal_request_t *r = batch; r;) {
+            wal_request_t *next = r->next;
+            if (status == 0) wal->stats.commits++;
+            r->status = status;
+            r->done = 1;
+            r = next;
+        }
+        pthread_cond_broadcast(&wal->flushed);
+    }
+}
+
+/**
+ * @brief Prepares a record for @p ranges outside the lock.
+ */
+static int request_init(wal_request_t *req, wal_range_desc_t *inline_descs, uint64_t state_size,
+                        const ttak_wal_range_t *ranges, size_t count) {
+    memset(req, 0, sizeof(*req));
+    req->descs = inline_descs;
+    if (count > WAL_INLINE_RANGES) {
+        if (count > SIZE_MAX / sizeof(wal_range_desc_t)) return -1;
+        req->descs = malloc(sizeof(wal_range_desc_t) * count);
+        if (!req->descs) return -1;
+    }
+
+    uint64_t payload = sizeof(wal_range_desc_t) * (uint64_t)count;
+    for (size_t i = 0; i < count; i++) {
+        if (ranges[i].len > state_size || ranges[i].offset > state_size - ranges[i].len) {
+            if (req->descs != inline_descs) free(req->descs);
+            return -1;
+        }
+        req->descs[i].offset = ranges[i].offset;
+        req->descs[i].len = ranges[i].len;
+        payload += ranges[i].len;
+    }
+
+    uint32_t crc = crc32c(0, req->descs, sizeof(wal_range_desc_t) * count);
+    for (size_t i = 0; i < count; i++) {
+        crc = crc32c(crc, ranges[i].data, ranges[i].len);
+    }
+
+    req->header.magic = WAL_MAGIC;
+    req->header.state_size = state_size;
+    req->header.payload_len = payload;
+    req->header.range_count = (uint32_t)count;
+    req->ranges = ranges;
+    req->count = count;
+    req->payload_crc = crc;
+    return 0;
+}
+
+static int wal_compact_internal(ttak_wal_t *wal);
+
+/**
+ * @brief Waits while a compaction copies the durable image. Called with the lock held.
+ *
+ * Callers that read the image before submitting (to size or diff a record)
+ * wait here first, so the image they read is the one their record applies to.
+ */
+static void wal_wait_drained_locked(ttak_wal_t *wal) {
+    while (wal->draining) {
+        pthread_cond_wait(&wal->flushed, &wal->lock);
+    }
+}
+
+/**
+ * @brief Applies, queues and waits for one record. Called and returns with the lock held.
+ */
+static int wal_submit_locked(ttak_wal_t *wal, wal_request_t *req) {
+    wal_wait_drained_locked(wal);
+    if (wal->failed || image_resize(wal, req->header.state_size) != 0) return -1;
+    for (size_t i = 0; i < req->count; i++) {
+        memcpy(wal->image + req->ranges[i].offset, req->ranges[i].data, req->ranges[i].len);
+    }
+
+    req->header.lsn = wal->next_lsn++;
+    req->header.crc = record_crc(req->payload_crc, &req->header);
+    *wal->queue_tail = req;
+    wal->queue_tail = &req->next;
+
+    while (!req->done) {
+        if (!wal->flushing) {
+            wal->flushing = 1;
+            wal_lead(wal);
+            wal->flushing = 0;
+        } else {
+            pthread_cond_wait(&wal->flushed, &wal->lock);
+        }
+    }
+
+    if (req->status == 0 && !wal->compacting &&
+        wal->seg_seq - wal->first_seq >= wal->opts.compact_segments) {
+        pthread_mutex_unlock(&wal->lock);
+        wal_compact_internal(wal);
+        pthread_mutex_lock(&wal->lock);
+    }
+    return req->status;
+}
+
+/**
+ * @brief Durably applies a set of byte ranges as one record.
+ */
+int ttak_wal_commit(ttak_wal_t *wal, uint64_t state_size, const ttak_wal_range_t *ranges, size_t count) {
+    if (!wal || (count && !ranges) || count > UINT32_MAX) return -1;
+
+    wal_range_desc_t inline_descs[WAL_INLINE_RANGES];
+    wal_request_t req;
+    if (request_init(&req, inline_descs, state_size, ranges, count) != 0) return -1;
+
+    pthread_mutex_lock(&wal->lock);
+    int status = wal_submit_locked(wal, &req);
+    pthread_mutex_unlock(&wal->lock);
+
+    if (req.descs != inline_descs) free(req.descs);
+    return status;
+}
+
+/**
+ * @brief Durably writes one range, growing the image if needed.
+ */
+int ttak_wal_write(ttak_wal_t *wal, uint64_t offset, const void *data, size_t len) {
+    if (!wal || (len && !data) || offset > UINT64_MAX - len) return -1;
+
+    ttak_wal_range_t range = { offset, data, len };
+    wal_range_desc_t inline_descs[WAL_INLINE_RANGES];
+    wal_request_t req;
+    if (request_init(&req, inline_descs, offset + len, &range, 1) != 0) return -1;
+
+    pthread_mutex_lock(&wal->lock);
+    wal_wait_drained_locked(wal);
+    // The final size is only known under the lock; the record CRC covers it there.
+    if (wal->size > req.header.state_size) req.header.state_size = wal->size;
+    int status = wal_submit_locked(wal, &req);
+    pthread_mutex_unlock(&wal->lock);
+    return status;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Compaction                                                                */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Writes the durable image as the new snapshot and deletes the closed segments it covers.
+ *
+ * Queued records are already applied to the image but may still fail, so
+ * new records are held back until the queue has been flushed; the copy is
+ * then exactly the state at the last durable LSN, which goes into the
+ * snapshot header. A log whose flush failed is not compacted.
+ *
+ * The active segment is never deleted, even though the snapshot may cover
+ * some of its records: recovery skips those by LSN, while losing the file
+ * that commits are appended to would lose acknowledged ones.
+ */
+static int wal_compact_internal(ttak_wal_t *wal) {
+    pthread_mutex_lock(&wal->lock);
+    if (wal->compacting || wal->failed) {
+        int failed = wal->failed;
+        pthread_mutex_unlock(&wal->lock);
+        return failed ? -1 : 0;
+    }
+    wal->compacting = 1;
+    wal->draining = 1;
+    while (wal->flushing || wal->queue) {
+        pthread_cond_wait(&wal->flushed, &wal->lock);
+    }
+    int status = wal->failed ? -1 : 0;
+    wal_snapshot_header_t header = {
+        .magic = WAL_SNAP_MAGIC,
+        .lsn = wal->stats.durable_lsn,
+        .size = wal->size,
+    };
+    uint64_t first = wal->first_seq;
+    uint64_t boundary = wal->seg_seq;
+    size_t size = wal->size;
+    uint8_t *copy = (status == 0 && size) ? malloc(size) : NULL;
+    if (copy) memcpy(copy, wal->image, size);
+    wal->draining = 0;
+    pthread_cond_broadcast(&wal->flushed);
+    pthread_mutex_unlock(&wal->lock);
+
+    if (size && !copy) status = -1;
+    if (status == 0) header.crc = snapshot_crc(copy, &header);
+    char tmp[PATH_MAX];
+    if (status == 0 && snprintf(tmp, sizeof(tmp), "%s.tmp", wal->path) >= (int)sizeof(tmp)) {
+        status = -1;
+    }
+    if (status == 0) {
+        int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            status = -1;
+        } else {
+            if (write_all(fd, &header, sizeof(header)) != 0 || write_all(fd, copy, size) != 0 ||
+                fsync(fd) != 0) {
+                status = -1;
+            }
+            close(fd);
+            if (status == 0 && rename(tmp, wal->path) != 0) status = -1;
+            if (status != 0) unlink(tmp);
+        }
+    }
+    free(copy);
+
+    if (status == 0) {
+        // The snapshot must be durable before the segments it replaces disappear.
+        sync_dir(wal->path);
+        char name[PATH_MAX];
+        for (uint64_t seq = first; seq < boundary; seq++) {
+            if (segment_name(wal, seq, name, sizeof(name)) == 0) unlink(name);
+        }
+        sync_dir(wal->path);
+    }
+
+    pthread_mutex_lock(&wal->lock);
+    if (status == 0) {
+        wal->first_seq = boundary;
+        wal->stats.compactions++;
+    }
+    wal->compacting = 0;
+    pthread_mutex_unlock(&wal->lock);
+    return status;
+}
+
+/**
+ * @brief Folds all closed segments into a fresh snapshot.
+ */
+int ttak_wal_compact(ttak_wal_t *wal) {
+    if (!wal) return -1;
+    return wal_compact_internal(wal);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Recovery                                                                  */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Loads the snapshot into the image.
+ *
+ * A file without a snapshot header is taken as a bare image at LSN 0, which
+ * is what save_current_progress wrote before it kept a log.
+ *
+ * @param lsn Set to the last record the snapshot covers.
+ * @return 0, or -1 if the file cannot be read or its header does not check out.
+ */
+static int load_snapshot(ttak_wal_t *wal, uint64_t *lsn) {
+    *lsn = 0;
+    int fd = open(wal->path, O_RDONLY);
+    if (fd < 0) return errno == ENOENT ? 0 : -1;
+
+    struct stat st;
+    int status = fstat(fd, &st) == 0 ? image_resize(wal, (uint64_t)st.st_size) : -1;
+    size_t done = 0;
+    while (status == 0 && done < wal->size) {
+        ssize_t n = read(fd, wal->image + done, wal->size - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            status = -1;
+            break;
+        }
+        done += (size_t)n;
+    }
+    close(fd);
+
+    wal_snapshot_header_t h;
+    if (status != 0 || wal->size < sizeof(h)) return status;
+    memcpy(&h, wal->image, sizeof(h));
+    if (h.magic != WAL_SNAP_MAGIC) return 0;
+    if (h.size != wal->size - sizeof(h) || snapshot_crc(wal->image + sizeof(h), &h) != h.crc) return -1;
+    memmove(wal->image, wal->image + sizeof(h), (size_t)h.size);
+    wal->size = (size_t)h.size;
+    *lsn = h.lsn;
+    return 0;
+}
+
+static int compare_seq(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Lists the sequence numbers of the segments next to the snapshot, ascending.
+ */
+static int list_segments(const ttak_wal_t *wal, uint64_t **out, size_t *count) {
+    char dir[PATH_MAX];
+    const char *base;
+    split_path(wal->path, dir, sizeof(dir), &base);
+    size_t base_len = strlen(base);
+
+    *out = NULL;
+    *count = 0;
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+
+    size_t cap = 0;
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        const char *name = ent->d_name;
+        if (strncmp(name, base, base_len) != 0 || strncmp(name + base_len, ".wal.", 5) != 0) continue;
+        const char *digits = name + base_len + 5;
+        char *end;
+        errno = 0;
+        unsigned long long seq = strtoull(digits, &end, 16);
+        if (errno || end == digits || *end != '\0' || seq == 0) continue;
+
+        if (*count == cap) {
+            cap = cap ? cap * 2 : 8;
+            uint64_t *grown = realloc(*out, sizeof(uint64_t) * cap);
+            if (!grown) {
+                closedir(d);
+                free(*out);
+                *out = NULL;
+                return -1;
+            }
+            *out = grown;
+        }
+        (*out)[(*count)++] = (uint64_t)seq;
+    }
+    closedir(d);
+    if (*count > 1) qsort(*out, *count, sizeof(uint64_t), compare_seq);
+    return 0;
+}
+
+/**
+ * @brief Replays one segment into the image.
+ *
+ * @param snapshot_lsn Records at or below it are already in the snapshot and
+ *                     are checked but not applied.
+ * @param last_lsn LSN of the last intact record seen so far; updated.
+ * @param valid Set to the length of the intact prefix; shorter than the file
+ *              if a record is torn.
+ * @return 0, or -1 if the segment could not be read (nothing may be truncated then).
+ */
+static int replay_segment(ttak_wal_t *wal, int fd, uint64_t snapshot_lsn, uint64_t *last_lsn, uint64_t *valid) {
+    struct stat st;
+    *valid = 0;
+    if (fstat(fd, &st) != 0) return -1;
+    if (st.st_size <= 0) return 0;
+    size_t len = (size_t)st.st_size;
+    uint8_t *buf = malloc(len);
+    if (!buf) return -1;
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pread(fd, buf + done, len - done, (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            free(buf);
+            return -1;
+        }
+        done += (size_t)n;
+    }
+
+    int status = 0;
+    size_t pos = 0;
+    while (done - pos >= sizeof(wal_record_header_t)) {
+        wal_record_header_t h;
+        memcpy(&h, buf + pos, sizeof(h));
+        const uint8_t *payload = buf + pos + sizeof(h);
+        size_t avail = done - pos - sizeof(h);
+        if (h.magic != WAL_MAGIC || h.lsn <= *last_lsn || h.payload_len > avail ||
+            h.range_count > h.payload_len / sizeof(wal_range_desc_t)) {
+            break;
+        }
+        if (record_crc(crc32c(0, payload, (size_t)h.payload_len), &h) != h.crc) break;
+
+        // Validate every descriptor before touching the image so a bad record is skipped whole.
+        const uint8_t *descs = payload;
+        uint64_t data_len = h.payload_len - sizeof(wal_range_desc_t) * h.range_count;
+        int ok = 1;
+        for (uint32_t i = 0; i < h.range_count && ok; i++) {
+            wal_range_desc_t desc;
+            memcpy(&desc, descs + sizeof(desc) * i, sizeof(desc));
+            ok = desc.len <= data_len && desc.len <= h.state_size && desc.offset <= h.state_size - desc.len;
+            data_len -= ok ? desc.len : 0;
+        }
+        if (!ok) break;
+        if (h.lsn <= snapshot_lsn) {
+            *last_lsn = h.lsn;
+            pos += sizeof(h) + (size_t)h.payload_len;
+            continue;
+        }
+        if (image_resize(wal, h.state_size) != 0) {
+            status = -1;
+            break;
+        }
+        const uint8_t *data = payload + sizeof(wal_range_desc_t) * h.range_count;
+        for (uint32_t i = 0; i < h.range_count; i++) {
+            wal_range_desc_t desc;
+            memcpy(&desc, descs + sizeof(desc) * i, sizeof(desc));
+            memcpy(wal->image + desc.offset, data, (size_t)desc.len);
+            data += desc.len;
+        }
+
+        *last_lsn = h.lsn;
+        wal->stats.replayed++;
+        pos += sizeof(h) + (size_t)h.payload_len;
+    }
+    free(buf);
+    *valid = pos;
+    return status;
+}
+
+/**
+ * @brief Opens (and recovers) a durable state image.
+ */
+ttak_wal_t *ttak_wal_open(const char *path, const ttak_wal_options_t *opts) {
+    if (!path || strlen(path) + 32 >= PATH_MAX) return NULL;
+    ttak_wal_t *wal = calloc(1, sizeof(*wal));
+    if (!wal) return NULL;
+    wal->path = strdup(path);
+    if (!wal->path) {
+        free(wal);
+        return NULL;
+    }
+    if (opts) wal->opts = *opts;
+    if (!wal->opts.segment_bytes) wal->opts.segment_bytes = TTAK_WAL_SEGMENT_BYTES;
+    if (!wal->opts.compact_segments) wal->opts.compact_segments = TTAK_WAL_COMPACT_SEGMENTS;
+    pthread_mutex_init(&wal->lock, NULL);
+    pthread_cond_init(&wal->flushed, NULL);
+    wal->queue_tail = &wal->queue;
+    wal->fd = -1;
+    wal->lock_fd = -1;
+
+    // One handle per log: a second writer would interleave LSNs in the same
+    // segment and compact away records it has never seen.
+    char lock_name[PATH_MAX];
+    snprintf(lock_name, sizeof(lock_name), "%s.lock", path);
+    wal->lock_fd = open(lock_name, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (wal->lock_fd < 0 || flock(wal->lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        int err = errno == EWOULDBLOCK ? EBUSY : errno;
+        ttak_wal_close(wal);
+        errno = err;
+        return NULL;
+    }
+
+    uint64_t *seqs = NULL;
+    size_t seq_count = 0;
+    uint64_t snapshot_lsn;
+    if (load_snapshot(wal, &snapshot_lsn) != 0 || list_segments(wal, &seqs, &seq_count) != 0) {
+        ttak_wal_close(wal);
+        return NULL;
+    }
+
+    uint64_t last_lsn = 0;
+    size_t kept = 0;
+    int torn = 0;
+    char name[PATH_MAX];
+    for (size_t i = 0; i < seq_count; i++) {
+        segment_name(wal, seqs[i], name, sizeof(name));
+        if (torn) {
+            // Segments are only opened after the previous one was synced, so
+            // nothing past a torn record can be part of the history.
+            unlink(name);
+            continue;
+        }
+        int fd = open(name, O_RDWR);
+        uint64_t valid;
+        if (fd < 0 || replay_segment(wal, fd, snapshot_lsn, &last_lsn, &valid) != 0) {
+            if (fd >= 0) close(fd);
+            free(seqs);
+            ttak_wal_close(wal);
+            return NULL;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && valid < (uint64_t)st.st_size) {
+            if (ftruncate(fd, (off_t)valid) == 0) fdatasync(fd);
+            torn = 1;
+        }
+        close(fd);
+        if (kept == 0) wal->first_seq = seqs[i];
+        wal->seg_seq = seqs[i];
+        wal->seg_bytes = valid;
+        kept++;
+    }
+    free(seqs);
+    if (torn) sync_dir(wal->path);
+
+    if (!kept) {
+        wal->first_seq = wal->seg_seq = 1;
+        wal->seg_bytes = 0;
+    }
+    // The snapshot may cover every record left on disk; LSNs must keep rising past it.
+    if (last_lsn < snapshot_lsn) last_lsn = snapshot_lsn;
+    wal->next_lsn = last_lsn + 1;
+    wal->stats.durable_lsn = last_lsn;
+    wal->fd = open_segment(wal, wal->seg_seq);
+    if (wal->fd < 0) {
+        ttak_wal_close(wal);
+        return NULL;
+    }
+    return wal;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Accessors and teardown                                                    */
+/* ------------------------------------------------------------------------- */
+
+size_t ttak_wal_read(ttak_wal_t *wal, uint64_t offset, void *buf, size_t len) {
+    if (!wal || !buf) return 0;
+    pthread_mutex_lock(&wal->lock);
+    size_t copied = 0;
+    if (offset < wal->size) {
+        copied = wal->size - (size_t)offset < len ? wal->size - (size_t)offset : len;
+        memcpy(buf, wal->image + offset, copied);
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return copied;
+}
+
+uint64_t ttak_wal_size(ttak_wal_t *wal) {
+    if (!wal) return 0;
+    pthread_mutex_lock(&wal->lock);
+    uint64_t size = wal->size;
+    pthread_mutex_unlock(&wal->lock);
+    return size;
+}
+
+void ttak_wal_get_stats(ttak_wal_t *wal, ttak_wal_stats_t *out) {
+    if (!wal || !out) return;
+    pthread_mutex_lock(&wal->lock);
+    *out = wal->stats;
+    pthread_mutex_unlock(&wal->lock);
+}
+
+/**
+ * @brief Compacts the log into its snapshot, releases its lock and frees it.
+ */
+void ttak_wal_close(ttak_wal_t *wal) {
+    if (!wal) return;
+    if (wal->fd >= 0) {
+        close(wal->fd);
+        wal->fd = -1;
+        // A failed log keeps its segments so the next open can recover them.
+        if (!wal->failed) wal_compact_internal(wal);
+    }
+    if (wal->lock_fd >= 0) close(wal->lock_fd);
+    pthread_cond_destroy(&wal->flushed);
+    pthread_mutex_destroy(&wal->lock);
+    free(wal->image);
+    free(wal->path);
+    free(wal);
+}
+
+/* ------------------------------------------------------------------------- */
+/* save_current_progress                                                     */
+/* ------------------------------------------------------------------------- */
+
+typedef struct progress_log {
+    struct progress_log *next;
+    ttak_wal_t *wal;
+    char filename[];
+} progress_log_t;
+
+static pthread_mutex_t progress_lock = PTHREAD_MUTEX_INITIALIZER;
+static progress_log_t *progress_logs = NULL;
+
+/**
+ * @brief Finds or opens the log of @p filename.
+ */
+static ttak_wal_t *progress_wal(const char *filename) {
+    pthread_mutex_lock(&progress_lock);
+    progress_log_t *entry = progress_logs;
+    while (entry && strcmp(entry->filename, filename) != 0) {
+        entry = entry->next;
+    }
+    if (!entry) {
+        size_t len = strlen(filename) + 1;
+        entry = malloc(sizeof(*entry) + len);
+        if (entry) {
+            memcpy(entry->filename, filename, len);
+            entry->wal = ttak_wal_open(filename, NULL);
+            if (entry->wal) {
+                entry->next = progress_logs;
+                progress_logs = entry;
+            } else {
+                free(entry);
+                entry = NULL;
+            }
+        }
+    }
+    pthread_mutex_unlock(&progress_lock);
+    return entry ? entry->wal : NULL;
+}
+
+/**
+ * @brief Collects the ranges where @p data differs from the image. Called with the lock held.
+ */
+static size_t diff_image(const ttak_wal_t *wal, const uint8_t *data, size_t size,
+                         ttak_wal_range_t **ranges, size_t *cap) {
+    size_t count = 0;
+    size_t common = size < wal->size ? size : wal->size;
+    size_t pos = 0;
+    while (pos < size) {
+        size_t block = size - pos < WAL_DIFF_BLOCK ? size - pos : WAL_DIFF_BLOCK;
+        int differs = pos >= common || memcmp(data + pos, wal->image + pos, block) != 0;
+        if (differs) {
+            if (count && (*ranges)[count - 1].offset + (*ranges)[count - 1].len == pos) {
+                (*ranges)[count - 1].len += block;
+            } else {
+                if (count == *cap) {
+                    size_t grown_cap = *cap ? *cap * 2 : WAL_INLINE_RANGES;
+                    ttak_wal_range_t *grown = realloc(*ranges, sizeof(**ranges) * grown_cap);
+                    if (!grown) return SIZE_MAX;
+                    *ranges = grown;
+                    *cap = grown_cap;
+                }
+                (*ranges)[count].offset = pos;
+                (*ranges)[count].data = data + pos;
+                (*ranges)[count].len = block;
+                count++;
+            }
+        }
+        pos += block;
+    }
+    return count;
+}
+
+/**
+ * @brief Persists a state blob, logging only the ranges that changed since the last save.
+ */
+void save_current_progress(const char *filename, const void *data, size_t size) {
+    if (!filename || (size && !data)) return;
+    ttak_wal_t *wal = progress_wal(filename);
+    if (!wal) return;
+
+    ttak_wal_range_t *ranges = NULL;
+    size_t cap = 0;
+    wal_range_desc_t inline_descs[WAL_INLINE_RANGES];
+    wal_request_t req;
+
+    // The diff and the submit share one critical section so that concurrent
+    // saves of the same file are ordered against the image they were diffed with.
+    pthread_mutex_lock(&wal->lock);
+    wal_wait_drained_locked(wal);
+    size_t count = diff_image(wal, data, size, &ranges, &cap);
+    if (count != SIZE_MAX && (count || size != wal->size) &&
+        request_init(&req, inline_descs, size, ranges, count) == 0) {
+        wal_submit_locked(wal, &req);
+        if (req.descs != inline_descs) free(req.descs);
+    }
+    pthread_mutex_unlock(&wal->lock);
+    free(ranges);
+}
+
+/**
+ * @brief Recovers the state saved with save_current_progress.
+ */
+size_t load_current_progress(const char *filename, void *data, size_t size) {
+    if (!filename) return 0;
+    ttak_wal_t *wal = progress_wal(filename);
+    if (!wal) return 0;
+    size_t total = (size_t)ttak_wal_size(wal);
+    if (data) ttak_wal_read(wal, 0, data, size);
+    return total;
+}
+
+/**
+ * @brief Compacts and closes the log of @p filename.
+ */
+void close_current_progress(const char *filename) {
+    if (!filename) return;
+    pthread_mutex_lock(&progress_lock);
+    progress_log_t **indirect = &progress_logs;
+    while (*indirect && strcmp((*indirect)->filename, filename) != 0) {
+        indirect = &(*indirect)->next;
+    }
+    progress_log_t *entry = *indirect;
+    if (entry) *indirect = entry->next;
+    pthread_mutex_unlock(&progress_lock);
+
+    if (entry) {
+        ttak_wal_close(entry->wal);
+        free(entry);
+    }
+}
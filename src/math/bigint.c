@@ -1,5 +1,6 @@
 #include <ttak/math/bigint.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/huge.h>
 #include "../../internal/app_types.h"
 #include <string.h>
 #include <stdlib.h>
@@ -51,11 +52,13 @@ static _Bool ensure_capacity(ttak_bigint_t *bi, size_t required, uint64_t now) {
 
     size_t new_size = new_capacity * sizeof(limb_t);
     limb_t *new_buf = NULL;
+    // Large limb arrays share pooled huge-page regions to cut TLB misses.
+    ttak_mem_flags_t flags = new_size >= TTAK_HUGE_HINT_MIN ? TTAK_MEM_HUGE_PAGES : TTAK_MEM_DEFAULT;
 
     if (bi->is_dynamic) {
-        new_buf = ttak_mem_realloc(bi->data.dyn_ptr, new_size, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        new_buf = ttak_mem_realloc_with_flags(bi->data.dyn_ptr, new_size, __TTAK_UNSAFE_MEM_FOREVER__, now, flags);
     } else {
-        new_buf = ttak_mem_alloc(new_size, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        new_buf = ttak_mem_alloc_with_flags(new_size, __TTAK_UNSAFE_MEM_FOREVER__, now, flags);
         if (new_buf) {
             memcpy(new_buf, bi->data.sso_buf, bi->used * sizeof(limb_t));
         }
@@ -0,0 +1,132 @@
+/**
+ * @file arena.c
+ * @brief Lifetime-scoped bump-pointer arenas.
+ *
+ * An arena is one tracked allocation holding the arena descriptor followed by
+ * its first chunk. The registry node of that allocation is handed to the
+ * cleanup thread (reference count zero), so an expired arena is collected as
+ * a unit unless a reader pins it. Whoever sets the block's freed bit first,
+ * the cleanup thread, an expiry sweep or ttak_arena_release, owns the
+ * reclaim; the block release then calls back into ttak_arena_drop_chunks to
+ * return the overflow chunks.
+ */
+
+#include <ttak/mem/arena.h>
+#include <ttak/mem/mem.h>
+#include <ttak/mem_tree/mem_tree.h>
+#include "../../internal/app_types.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#define ARENA_DESC_SIZE ((sizeof(ttak_arena_t) + (TTAK_ARENA_ALIGN - 1)) & ~(size_t)(TTAK_ARENA_ALIGN - 1))
+#define ARENA_CHUNK_HDR ((sizeof(ttak_arena_chunk_t) + (TTAK_ARENA_ALIGN - 1)) & ~(size_t)(TTAK_ARENA_ALIGN - 1))
+
+/**
+ * @brief Creates an arena with its first chunk stored inline.
+ *
+ * @param chunk_size Bytes per chunk (0 for the default).
+ * @param lifetime_ticks Lifetime of the arena.
+ * @param now Current tick.
+ * @return The arena, or NULL on failure.
+ */
+ttak_arena_t *ttak_arena_create(size_t chunk_size, uint64_t lifetime_ticks, uint64_t now) {
+    if (chunk_size == 0) chunk_size = TTAK_ARENA_DEFAULT_CHUNK;
+    chunk_size = (chunk_size + (TTAK_ARENA_ALIGN - 1)) & ~(size_t)(TTAK_ARENA_ALIGN - 1);
+    if (chunk_size > SIZE_MAX - ARENA_DESC_SIZE) return NULL;
+
+    // Overflow chunks are dropped when the block is released, which a generation never does per block.
+    ttak_arena_t *arena = ttak_mem_alloc_with_flags(ARENA_DESC_SIZE + chunk_size, lifetime_ticks, now, TTAK_MEM_NO_GENERATION);
+    if (!arena) return NULL;
+
+    arena->inline_base = (char *)arena + ARENA_DESC_SIZE;
+    arena->cursor = arena->inline_base;
+    arena->limit = arena->inline_base + chunk_size;
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size;
+    arena->used = 0;
+
+    ttak_mem_header_t *header = (ttak_mem_header_t *)arena - 1;
+    header->is_arena = true;
+    if (header->tree_node) {
+        // The arena owns its objects; let the cleanup thread reclaim it on expiry.
+        atomic_store(&header->tree_node->ref_count, 0);
+    }
+    return arena;
+}
+
+/**
+ * @brief Starts a new overflow chunk large enough for @p size.
+ *
+ * The rest of the current chunk is abandoned; requests larger than the
+ * chunk size get a dedicated chunk.
+ *
+ * @param arena Arena to grow.
+ * @param size Aligned request size.
+ * @return Zeroed memory or NULL.
+ */
+void *ttak_arena_alloc_slow(ttak_arena_t *arena, size_t size) {
+    size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+    if (capacity > SIZE_MAX - ARENA_CHUNK_HDR) return NULL;
+
+    ttak_arena_chunk_t *chunk = aligned_alloc(TTAK_ARENA_ALIGN,
+                                              (ARENA_CHUNK_HDR + capacity + (TTAK_ARENA_ALIGN - 1)) & ~(size_t)(TTAK_ARENA_ALIGN - 1));
+    if (!chunk) return NULL;
+    chunk->size = capacity;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+
+    char *base = (char *)chunk + ARENA_CHUNK_HDR;
+    arena->cursor = base + size;
+    arena->limit = base + capacity;
+    arena->used += size;
+    memset(base, 0, size);
+    return base;
+}
+
+/**
+ * @brief Frees all overflow chunks.
+ *
+ * @param arena Arena being reclaimed.
+ */
+void ttak_arena_drop_chunks(ttak_arena_t *arena) {
+    ttak_arena_chunk_t *chunk = arena->chunks;
+    while (chunk) {
+        ttak_arena_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+}
+
+/**
+ * @brief Rewinds the arena to its inline chunk.
+ *
+ * @param arena Arena to rewind.
+ */
+void ttak_arena_reset(ttak_arena_t *arena) {
+    if (!arena) return;
+    ttak_arena_drop_chunks(arena);
+    arena->cursor = arena->inline_base;
+    arena->limit = arena->inline_base + arena->chunk_size;
+    arena->used = 0;
+}
+
+/**
+ * @brief Releases the arena in one step.
+ *
+ * @param arena Arena to release.
+ */
+void ttak_arena_release(ttak_arena_t *arena) {
+    if (!arena) return;
+    ttak_mem_free(arena);
+}
+
+/**
+ * @brief Reports the bytes handed out by the arena.
+ *
+ * @param arena Arena to query.
+ * @return Bytes used.
+ */
+size_t ttak_arena_used(const ttak_arena_t *arena) {
+    return arena ? arena->used : 0;
+}
@@ -1,13 +1,84 @@
 #include <ttak/mem/epoch_gc.h>
 #include <ttak/mem/mem.h>
 #include <ttak/timing/timing.h>
+#include "../../internal/app_types.h"
+#include "../../internal/thread_record.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EPOCH_ACTIVE ((uint64_t)1)
+
+static _Atomic uint64_t next_gc_id = 1;
+
+/**
+ * @brief Runs the cleanup callbacks of a chain of retired blocks.
+ */
+static void reclaim_chain(ttak_epoch_retired_t *entry) {
+    while (entry) {
+        ttak_epoch_retired_t *next = entry->next;
+        entry->cleanup(entry->ptr);
+        free(entry);
+        entry = next;
+    }
+}
+
+/**
+ * @brief Reclaims every bag of @p rec whose grace period ended by @p global.
+ *
+ * Blocks retired in epoch e are unreachable to readers once the global
+ * epoch reaches e + 2: the epoch can only have moved twice after every
+ * thread active in e had left its critical section.
+ */
+static void collect_record(ttak_epoch_record_t *rec, uint64_t global) {
+    for (int i = 0; i < TTAK_EPOCH_BAGS; i++) {
+        if (rec->limbo[i] && rec->limbo_epoch[i] + 2 <= global) {
+            ttak_epoch_retired_t *chain = rec->limbo[i];
+            rec->limbo[i] = NULL;
+            reclaim_chain(chain);
+        }
+    }
+}
+
+/**
+ * @brief Reclaims orphaned blocks whose grace period ended by @p global.
+ */
+static void collect_orphans(ttak_epoch_gc_t *gc, uint64_t global) {
+    ttak_epoch_retired_t *ready = NULL;
+
+    pthread_mutex_lock(&gc->records_lock);
+    ttak_epoch_retired_t **indirect = &gc->orphans;
+    while (*indirect) {
+        ttak_epoch_retired_t *entry = *indirect;
+        if (entry->epoch + 2 <= global) {
+            *indirect = entry->next;
+            entry->next = ready;
+            ready = entry;
+        } else {
+            indirect = &entry->next;
+        }
+    }
+    pthread_mutex_unlock(&gc->records_lock);
+
+    reclaim_chain(ready);
+}
+
+/**
+ * @brief Starts a new record outside any critical section.
+ */
+static void epoch_record_created(ttak_epoch_gc_t *gc, ttak_epoch_record_t *rec) {
+    (void)gc;
+    atomic_init(&rec->state, 0);
+}
+
+TTAK_THREAD_RECORD_IMPL(ttak_epoch_gc_t, ttak_epoch_record_t, epoch_record_created)
 
 /**
  * @brief Initializes the Epoch GC structure.
- * 
+ *
  * Sets up the underlying memory tree with manual cleanup mode enabled,
  * allowing the user to control the garbage collection cycles via ttak_epoch_gc_rotate.
- * 
+ *
  * @param gc Pointer to the GC context.
  */
 void ttak_epoch_gc_init(ttak_epoch_gc_t *gc) {
@@ -15,24 +86,43 @@ void ttak_epoch_gc_init(ttak_epoch_gc_t *gc) {
     // Enable manual cleanup to prevent automatic background threads from interfering
     // with the user-controlled periodic cycle.
     ttak_mem_tree_set_manual_cleanup(&gc->tree, true);
-    gc->current_epoch = 0;
+    atomic_init(&gc->current_epoch, 0);
     gc->last_cleanup_ts = ttak_get_tick_count();
+    gc->id = atomic_fetch_add(&next_gc_id, 1);
+    pthread_mutex_init(&gc->records_lock, NULL);
+    atomic_init(&gc->records, NULL);
+    gc->orphans = NULL;
 }
 
 /**
  * @brief Destroys the GC context.
- * 
- * Frees all remaining memory blocks tracked by the tree.
- * 
+ *
+ * Reclaims every retired block regardless of epoch, releases the thread
+ * records and frees all remaining memory blocks tracked by the tree.
+ *
  * @param gc Pointer to the GC context.
  */
 void ttak_epoch_gc_destroy(ttak_epoch_gc_t *gc) {
+    ttak_epoch_record_t *rec = atomic_load_explicit(&gc->records, memory_order_acquire);
+    while (rec) {
+        ttak_epoch_record_t *next = rec->next;
+        for (int i = 0; i < TTAK_EPOCH_BAGS; i++) {
+            reclaim_chain(rec->limbo[i]);
+        }
+        free(rec);
+        rec = next;
+    }
+    atomic_store(&gc->records, NULL);
+    reclaim_chain(gc->orphans);
+    gc->orphans = NULL;
+    forget_record(gc);
+    pthread_mutex_destroy(&gc->records_lock);
     ttak_mem_tree_destroy(&gc->tree);
 }
 
 /**
  * @brief Registers a memory block with the current epoch.
- * 
+ *
  * @param gc Pointer to the GC context.
  * @param ptr Pointer to the memory block.
  * @param size Size of the block.
@@ -45,22 +135,150 @@ void ttak_epoch_gc_register(ttak_epoch_gc_t *gc, void *ptr, size_t size) {
     ttak_mem_tree_add(&gc->tree, ptr, size, 0, true);
 }
 
+/**
+ * @brief Announces the current epoch for the calling thread.
+ *
+ * The seq_cst store and fence order the announcement before any later load
+ * of a shared pointer, so an advancing thread either sees this reader or the
+ * reader sees the unlink that preceded the retire.
+ *
+ * @param gc Pointer to the GC context.
+ */
+void ttak_epoch_gc_enter(ttak_epoch_gc_t *gc) {
+    ttak_epoch_record_t *rec = local_record(gc);
+    if (!rec) return;
+    if (rec->nesting++ > 0) return;
+
+    uint64_t epoch = atomic_load_explicit(&gc->current_epoch, memory_order_relaxed);
+    atomic_store_explicit(&rec->state, (epoch << 1) | EPOCH_ACTIVE, memory_order_seq_cst);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+/**
+ * @brief Clears the calling thread's announcement once the outermost section ends.
+ *
+ * @param gc Pointer to the GC context.
+ */
+void ttak_epoch_gc_exit(ttak_epoch_gc_t *gc) {
+    ttak_epoch_record_t *rec = find_record(gc);
+    if (!rec || rec->nesting == 0) return;
+    if (--rec->nesting > 0) return;
+
+    atomic_store_explicit(&rec->state, 0, memory_order_release);
+}
+
+/**
+ * @brief Advances the global epoch if no active thread lags behind it.
+ *
+ * @param gc Pointer to the GC context.
+ * @return true if the epoch moved forward.
+ */
+_Bool ttak_epoch_gc_try_advance(ttak_epoch_gc_t *gc) {
+    uint64_t epoch = atomic_load_explicit(&gc->current_epoch, memory_order_seq_cst);
+
+    for (ttak_epoch_record_t *rec = atomic_load_explicit(&gc->records, memory_order_acquire); rec; rec = rec->next) {
+        uint64_t state = atomic_load_explicit(&rec->state, memory_order_seq_cst);
+        if ((state & EPOCH_ACTIVE) && (state >> 1) != epoch) {
+            return false;
+        }
+    }
+    return atomic_compare_exchange_weak_explicit(&gc->current_epoch, &epoch, epoch + 1,
+                                                 memory_order_acq_rel, memory_order_relaxed);
+}
+
+/**
+ * @brief Places an unlinked block into the calling thread's limbo bag.
+ *
+ * The bag for epoch e shares its slot with epoch e - 3, whose blocks are
+ * always past their grace period, so they are reclaimed before reuse.
+ *
+ * @param gc Pointer to the GC context.
+ * @param ptr Block to retire.
+ * @param cleanup Reclaim callback, or NULL for ttak_mem_free.
+ */
+void ttak_epoch_gc_retire(ttak_epoch_gc_t *gc, void *ptr, ttak_epoch_cleanup_t cleanup) {
+    if (!ptr) return;
+    if (!cleanup) cleanup = ttak_mem_free;
+
+    ttak_epoch_record_t *rec = local_record(gc);
+    ttak_epoch_retired_t *entry = malloc(sizeof(ttak_epoch_retired_t));
+    if (!rec || !entry) {
+        // Without bookkeeping the block cannot be tracked; leaking beats freeing under a reader.
+        free(entry);
+        return;
+    }
+
+    uint64_t epoch = atomic_load_explicit(&gc->current_epoch, memory_order_acquire);
+    int bag = (int)(epoch % TTAK_EPOCH_BAGS);
+    if (rec->limbo[bag] && rec->limbo_epoch[bag] != epoch) {
+        ttak_epoch_retired_t *stale = rec->limbo[bag];
+        rec->limbo[bag] = NULL;
+        reclaim_chain(stale);
+    }
+
+    entry->ptr = ptr;
+    entry->cleanup = cleanup;
+    entry->epoch = epoch;
+    entry->next = rec->limbo[bag];
+    rec->limbo[bag] = entry;
+    rec->limbo_epoch[bag] = epoch;
+
+    if (++rec->retired_count >= TTAK_EPOCH_RETIRE_THRESHOLD) {
+        rec->retired_count = 0;
+        ttak_epoch_gc_try_advance(gc);
+        collect_record(rec, atomic_load_explicit(&gc->current_epoch, memory_order_acquire));
+    }
+}
+
+/**
+ * @brief Unbinds the calling thread and hands its limbo blocks to the GC.
+ *
+ * @param gc Pointer to the GC context.
+ */
+void ttak_epoch_gc_unregister_thread(ttak_epoch_gc_t *gc) {
+    ttak_epoch_record_t *rec = find_record(gc);
+    if (!rec) return;
+
+    atomic_store_explicit(&rec->state, 0, memory_order_release);
+    rec->nesting = 0;
+    rec->retired_count = 0;
+
+    pthread_mutex_lock(&gc->records_lock);
+    for (int i = 0; i < TTAK_EPOCH_BAGS; i++) {
+        ttak_epoch_retired_t *entry = rec->limbo[i];
+        while (entry) {
+            ttak_epoch_retired_t *next = entry->next;
+            entry->next = gc->orphans;
+            gc->orphans = entry;
+            entry = next;
+        }
+        rec->limbo[i] = NULL;
+    }
+    rec->owned = false;
+    pthread_mutex_unlock(&gc->records_lock);
+    forget_record(gc);
+}
+
 /**
  * @brief Rotates the epoch and performs cleanup.
- * 
- * Increments the epoch counter and triggers the memory tree's cleanup logic.
- * This function iterates through the tree, identifying blocks that are no longer
- * referenced or valid, and frees them. It is designed to be called periodically.
- * 
+ *
+ * Tries to advance the epoch, then reclaims the caller's limbo bags and the
+ * orphaned blocks whose grace period has ended. Finally sweeps the memory
+ * tree holding registered blocks. It is designed to be called periodically.
+ *
  * @param gc Pointer to the GC context.
  */
 void ttak_epoch_gc_rotate(ttak_epoch_gc_t *gc) {
-    gc->current_epoch++;
-    
+    ttak_epoch_gc_try_advance(gc);
+    uint64_t epoch = atomic_load_explicit(&gc->current_epoch, memory_order_acquire);
+
+    ttak_epoch_record_t *rec = find_record(gc);
+    if (rec) collect_record(rec, epoch);
+    collect_orphans(gc, epoch);
+
     // Perform cleanup using the current timestamp.
-    // mem_tree_perform_cleanup iterates the tree and removes expired/unreferenced nodes.
     // By controlling when this is called, we avoid "stop-the-world" pauses at arbitrary times.
     ttak_mem_tree_perform_cleanup(&gc->tree, ttak_get_tick_count());
-    
+
     gc->last_cleanup_ts = ttak_get_tick_count();
-}
\ No newline at end of file
+}
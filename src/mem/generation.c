@@ -0,0 +1,368 @@
+/**
+ * @file generation.c
+ * @brief Lifetime-bucketed generation arenas.
+ *
+ * Blocks whose expiries round up to the same bucket deadline are bump-carved
+ * from the same generation. A generation owns a chain of 2 MB segments taken
+ * from one PROT_NONE range reserved on first use, and is dropped as a whole
+ * once its deadline has passed: every block in it has expired by then, so
+ * nothing is freed per object. Segment descriptors live outside the range,
+ * which lets readers pin a segment by address without touching memory that
+ * may already be gone.
+ *
+ * Reclaimed segments go on a free list and are handed out again before any
+ * fresh one, so the range and the descriptor pages in use stay bounded by
+ * the peak number of live segments. Between the reclaim and the reuse a
+ * stale pointer's pin fails; after it, the pointer aliases the new
+ * generation, which is the same use-after-free as with any other allocator.
+ */
+
+#include <ttak/mem/generation.h>
+#include <ttak/mem/profile.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#define GEN_ALIGN 64
+#define GEN_NONE UINT32_MAX
+
+/**
+ * @brief Segment state bit: the segment belongs to an open generation.
+ *
+ * The remaining bits count pins; a reclaim only succeeds on a word that is
+ * exactly GEN_SEG_ASSIGNED (assigned, no pins).
+ */
+#define GEN_SEG_ASSIGNED (1ULL << 63)
+
+/**
+ * @brief All blocks sharing one bucket deadline.
+ */
+typedef struct ttak_gen {
+    struct ttak_gen *next;      /**< Open list, sorted by deadline */
+    uint64_t deadline;          /**< Every block in the generation has expired after this tick */
+    uint32_t first;             /**< Most recently assigned segment; chained through gen_segment_t.next */
+    uint32_t segments;          /**< Segments in the chain */
+    size_t cursor;              /**< Next free offset in the first segment */
+    size_t live_blocks;         /**< Blocks not freed individually */
+    size_t live_bytes;          /**< Their sizes */
+    const void **sampled;       /**< Profiler-sampled blocks */
+    size_t sampled_count;
+    size_t sampled_cap;
+} ttak_gen_t;
+
+/**
+ * @brief Descriptor of one segment of the reserved range.
+ */
+typedef struct {
+    _Atomic uint64_t state;     /**< GEN_SEG_ASSIGNED | pins */
+    ttak_gen_t *gen;            /**< Owning generation, NULL while free */
+    uint32_t next;              /**< Next segment of the generation, or of the free list */
+} gen_segment_t;
+
+static pthread_mutex_t gen_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t gen_once = PTHREAD_ONCE_INIT;
+static uintptr_t gen_base = 0;
+static _Atomic size_t gen_span = 0;
+static gen_segment_t *gen_segments = NULL;  /**< TTAK_GEN_MAX_SEGMENTS descriptors, committed as used */
+static uint32_t gen_fresh = 0;              /**< Segments ever committed; the range past it is untouched */
+static uint32_t gen_free = GEN_NONE;        /**< Reclaimed segments, chained through next */
+static ttak_gen_t *gen_open = NULL;
+static ttak_gen_stats_t gen_stats;
+
+static inline size_t round_up(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+static inline char *segment_addr(uint32_t idx) {
+    return (char *)gen_base + (size_t)idx * TTAK_GEN_SEGMENT_SIZE;
+}
+
+static inline gen_segment_t *segment_of(const void *ptr) {
+    return &gen_segments[((uintptr_t)ptr - gen_base) / TTAK_GEN_SEGMENT_SIZE];
+}
+
+/**
+ * @brief Reserves the address range for every segment, without committing memory.
+ *
+ * The descriptor table is mapped the same lazy way; since fresh segments
+ * are handed out in order and reclaimed ones are reused first, only the
+ * pages of descriptors up to the peak segment count are touched.
+ */
+static void gen_reserve(void) {
+    size_t table = (size_t)TTAK_GEN_MAX_SEGMENTS * sizeof(gen_segment_t);
+    void *descriptors = mmap(NULL, table, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (descriptors == MAP_FAILED) return;
+
+    size_t size = (size_t)TTAK_GEN_MAX_SEGMENTS * TTAK_GEN_SEGMENT_SIZE;
+    size_t span = size + TTAK_GEN_SEGMENT_SIZE;
+    char *raw = mmap(NULL, span, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw == MAP_FAILED) {
+        munmap(descriptors, table);
+        return;
+    }
+
+    char *aligned = (char *)round_up((uintptr_t)raw, TTAK_GEN_SEGMENT_SIZE);
+    size_t head = (size_t)(aligned - raw);
+    size_t tail = span - head - size;
+    if (head) munmap(raw, head);
+    if (tail) munmap(aligned + size, tail);
+
+    gen_segments = descriptors;
+    gen_base = (uintptr_t)aligned;
+    atomic_store_explicit(&gen_span, size, memory_order_release);
+}
+
+/**
+ * @brief Rounds an expiry up to its bucket deadline.
+ */
+uint64_t ttak_gen_deadline(uint64_t expires_tick, uint64_t lifetime_ticks) {
+    uint64_t slack = lifetime_ticks >> TTAK_GEN_SLACK_SHIFT;
+    uint64_t width = slack > TTAK_GEN_MIN_WIDTH ? 1ULL << (63 - __builtin_clzll(slack)) : TTAK_GEN_MIN_WIDTH;
+    if (expires_tick > UINT64_MAX - width) return 0;
+    return (expires_tick + width - 1) & ~(width - 1);
+}
+
+/**
+ * @brief Commits a reclaimed segment, or else the next unused one, to @p gen.
+ *
+ * Called with gen_lock held.
+ *
+ * @return The segment index, or GEN_NONE if every segment is in use.
+ */
+static uint32_t gen_segment_take(ttak_gen_t *gen) {
+    uint32_t idx = gen_free;
+    bool reused = idx != GEN_NONE;
+    if (!reused) {
+        if (gen_fresh >= TTAK_GEN_MAX_SEGMENTS) {
+            if (gen_stats.exhausted++ == 0) {
+                fprintf(stderr, "[TTAK_MEM_GEN] All %u segments in use; generational allocations fall back to the regular path.\n",
+                        (unsigned)TTAK_GEN_MAX_SEGMENTS);
+            }
+            return GEN_NONE;
+        }
+        idx = gen_fresh;
+    }
+    if (mprotect(segment_addr(idx), TTAK_GEN_SEGMENT_SIZE, PROT_READ | PROT_WRITE) != 0) {
+        return GEN_NONE;
+    }
+    gen_segment_t *seg = &gen_segments[idx];
+    if (reused) {
+        gen_free = seg->next;
+        gen_stats.reused_segments++;
+    } else {
+        gen_fresh++;
+    }
+
+    seg->gen = gen;
+    seg->next = gen->first;
+    gen->first = idx;
+    gen->segments++;
+    gen->cursor = 0;
+    gen_stats.segments++;
+    atomic_store_explicit(&seg->state, GEN_SEG_ASSIGNED, memory_order_release);
+    return idx;
+}
+
+/**
+ * @brief Bump-allocates a block from the generation of @p deadline, its segment pinned.
+ */
+void *ttak_gen_alloc(size_t size, uint64_t deadline) {
+    if (size == 0 || size > TTAK_GEN_MAX_BLOCK || deadline == 0) return NULL;
+    pthread_once(&gen_once, gen_reserve);
+    if (!atomic_load_explicit(&gen_span, memory_order_acquire)) return NULL;
+
+    size_t need = round_up(size, GEN_ALIGN);
+    pthread_mutex_lock(&gen_lock);
+
+    ttak_gen_t **link = &gen_open;
+    while (*link && (*link)->deadline < deadline) {
+        link = &(*link)->next;
+    }
+    ttak_gen_t *gen = *link;
+    if (!gen || gen->deadline != deadline) {
+        gen = calloc(1, sizeof(*gen));
+        if (!gen) {
+            pthread_mutex_unlock(&gen_lock);
+            return NULL;
+        }
+        gen->deadline = deadline;
+        gen->first = GEN_NONE;
+        gen->cursor = TTAK_GEN_SEGMENT_SIZE;
+        gen->next = *link;
+        *link = gen;
+        gen_stats.generations++;
+    }
+
+    if (gen->cursor + need > TTAK_GEN_SEGMENT_SIZE && gen_segment_take(gen) == GEN_NONE) {
+        if (gen->segments == 0) {
+            *link = gen->next;
+            gen_stats.generations--;
+            free(gen);
+        }
+        pthread_mutex_unlock(&gen_lock);
+        return NULL;
+    }
+
+    void *block = segment_addr(gen->first) + gen->cursor;
+    // The caller's pin keeps a reclaim with a later clock off the block until it is initialized.
+    atomic_fetch_add_explicit(&gen_segments[gen->first].state, 1, memory_order_acq_rel);
+    gen->cursor += need;
+    gen->live_blocks++;
+    gen->live_bytes += size;
+    gen_stats.live_blocks++;
+    pthread_mutex_unlock(&gen_lock);
+    return block;
+}
+
+/**
+ * @brief Drops a freed block from its generation's accounting.
+ */
+void ttak_gen_release(const void *ptr, size_t size) {
+    gen_segment_t *seg = segment_of(ptr);
+    pthread_mutex_lock(&gen_lock);
+    ttak_gen_t *gen = seg->gen;
+    if (gen) {
+        gen->live_blocks--;
+        gen->live_bytes -= size;
+        gen_stats.live_blocks--;
+    }
+    pthread_mutex_unlock(&gen_lock);
+}
+
+/**
+ * @brief Records a sampled block on its generation.
+ */
+void ttak_gen_note_sampled(const void *ptr) {
+    gen_segment_t *seg = segment_of(ptr);
+    pthread_mutex_lock(&gen_lock);
+    ttak_gen_t *gen = seg->gen;
+    if (gen && gen->sampled_count == gen->sampled_cap) {
+        size_t cap = gen->sampled_cap ? gen->sampled_cap * 2 : 8;
+        const void **grown = realloc(gen->sampled, cap * sizeof(*grown));
+        if (grown) {
+            gen->sampled = grown;
+            gen->sampled_cap = cap;
+        }
+    }
+    if (gen && gen->sampled_count < gen->sampled_cap) {
+        gen->sampled[gen->sampled_count++] = ptr;
+    }
+    pthread_mutex_unlock(&gen_lock);
+}
+
+/**
+ * @brief Returns whether @p ptr lies in the reserved range.
+ */
+_Bool ttak_gen_contains(const void *ptr) {
+    size_t span = atomic_load_explicit(&gen_span, memory_order_acquire);
+    return (uintptr_t)ptr - gen_base < span;
+}
+
+/**
+ * @brief Pins the segment of @p ptr if it belongs to an open generation.
+ */
+_Bool ttak_gen_pin(const void *ptr) {
+    gen_segment_t *seg = segment_of(ptr);
+    uint64_t state = atomic_load_explicit(&seg->state, memory_order_acquire);
+    do {
+        if (!(state & GEN_SEG_ASSIGNED)) return false;
+    } while (!atomic_compare_exchange_weak_explicit(&seg->state, &state, state + 1,
+                                                    memory_order_acq_rel, memory_order_acquire));
+    return true;
+}
+
+/**
+ * @brief Releases a segment pin.
+ */
+void ttak_gen_unpin(const void *ptr) {
+    atomic_fetch_sub_explicit(&segment_of(ptr)->state, 1, memory_order_release);
+}
+
+/**
+ * @brief Moves every segment of @p gen from assigned to free, or none of them.
+ *
+ * Called with gen_lock held. A pinned segment rolls the others back, and
+ * readers that raced with the rollback simply fail their pin.
+ */
+static bool gen_seal(ttak_gen_t *gen) {
+    for (uint32_t idx = gen->first; idx != GEN_NONE; idx = gen_segments[idx].next) {
+        uint64_t expected = GEN_SEG_ASSIGNED;
+        if (!atomic_compare_exchange_strong_explicit(&gen_segments[idx].state, &expected, 0,
+                                                     memory_order_acq_rel, memory_order_relaxed)) {
+            for (uint32_t undo = gen->first; undo != idx; undo = gen_segments[undo].next) {
+                atomic_store_explicit(&gen_segments[undo].state, GEN_SEG_ASSIGNED, memory_order_release);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Drops every unpinned generation whose deadline has passed.
+ */
+size_t ttak_gen_reclaim(uint64_t now) {
+    if (!atomic_load_explicit(&gen_span, memory_order_acquire)) return 0;
+
+    ttak_gen_t *dead = NULL;
+    size_t bytes = 0;
+    pthread_mutex_lock(&gen_lock);
+    ttak_gen_t **link = &gen_open;
+    while (*link && (*link)->deadline < now) {
+        ttak_gen_t *gen = *link;
+        if (!gen_seal(gen)) {
+            link = &gen->next;
+            continue;
+        }
+        *link = gen->next;
+        gen->next = dead;
+        dead = gen;
+        for (uint32_t idx = gen->first; idx != GEN_NONE; idx = gen_segments[idx].next) {
+            gen_segments[idx].gen = NULL;
+        }
+        bytes += gen->live_bytes;
+        gen_stats.generations--;
+        gen_stats.segments -= gen->segments;
+        gen_stats.live_blocks -= gen->live_blocks;
+        gen_stats.reclaimed_generations++;
+        gen_stats.reclaimed_segments += gen->segments;
+        gen_stats.reclaimed_blocks += gen->live_blocks;
+    }
+    pthread_mutex_unlock(&gen_lock);
+
+    while (dead) {
+        ttak_gen_t *next = dead->next;
+        for (size_t i = 0; i < dead->sampled_count; i++) {
+            ttak_profile_record_free(dead->sampled[i]);
+        }
+        // Remapping the segment in place drops its pages and keeps the range
+        // reserved, so nothing outside the allocator is ever mapped there.
+        uint32_t last = GEN_NONE;
+        for (uint32_t idx = dead->first; idx != GEN_NONE; idx = gen_segments[idx].next) {
+            mmap(segment_addr(idx), TTAK_GEN_SEGMENT_SIZE, PROT_NONE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+            last = idx;
+        }
+        pthread_mutex_lock(&gen_lock);
+        gen_segments[last].next = gen_free;
+        gen_free = dead->first;
+        pthread_mutex_unlock(&gen_lock);
+        free(dead->sampled);
+        free(dead);
+        dead = next;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Copies the manager's counters.
+ */
+void ttak_gen_get_stats(ttak_gen_stats_t *out) {
+    if (!out) return;
+    pthread_mutex_lock(&gen_lock);
+    *out = gen_stats;
+    pthread_mutex_unlock(&gen_lock);
+}
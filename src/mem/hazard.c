@@ -0,0 +1,247 @@
+#include <ttak/mem/hazard.h>
+#include <ttak/mem/mem.h>
+#include "../../internal/app_types.h"
+#include "../../internal/thread_record.h"
+#include <stdlib.h>
+#include <string.h>
+
+static _Atomic uint64_t next_domain_id = 1;
+
+/**
+ * @brief Clears the slots of a new record and counts it for the scan threshold.
+ */
+static void hazard_record_created(ttak_hazard_domain_t *dom, ttak_hazard_record_t *rec) {
+    for (int i = 0; i < TTAK_HAZARD_SLOTS; i++) {
+        atomic_init(&rec->slots[i], NULL);
+    }
+    atomic_fetch_add(&dom->record_count, 1);
+}
+
+TTAK_THREAD_RECORD_IMPL(ttak_hazard_domain_t, ttak_hazard_record_t, hazard_record_created)
+
+/**
+ * @brief Orders addresses for the sorted hazard snapshot.
+ */
+static int compare_ptr(const void *a, const void *b) {
+    uintptr_t x = (uintptr_t)*(void *const *)a;
+    uintptr_t y = (uintptr_t)*(void *const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Initializes a hazard-pointer domain.
+ *
+ * @param dom Pointer to the domain.
+ */
+void ttak_hazard_domain_init(ttak_hazard_domain_t *dom) {
+    dom->id = atomic_fetch_add(&next_domain_id, 1);
+    pthread_mutex_init(&dom->records_lock, NULL);
+    atomic_init(&dom->records, NULL);
+    atomic_init(&dom->record_count, 0);
+    dom->orphans = NULL;
+}
+
+/**
+ * @brief Destroys the domain, reclaiming all retired blocks and records.
+ *
+ * @param dom Pointer to the domain.
+ */
+void ttak_hazard_domain_destroy(ttak_hazard_domain_t *dom) {
+    ttak_hazard_retired_t *pending = dom->orphans;
+    dom->orphans = NULL;
+
+    ttak_hazard_record_t *rec = atomic_load_explicit(&dom->records, memory_order_acquire);
+    while (rec) {
+        ttak_hazard_record_t *next = rec->next;
+        while (rec->retired) {
+            ttak_hazard_retired_t *entry = rec->retired;
+            rec->retired = entry->next;
+            entry->next = pending;
+            pending = entry;
+        }
+        free(rec);
+        rec = next;
+    }
+    atomic_store(&dom->records, NULL);
+
+    while (pending) {
+        ttak_hazard_retired_t *next = pending->next;
+        pending->cleanup(pending->ptr);
+        free(pending);
+        pending = next;
+    }
+    forget_record(dom);
+    pthread_mutex_destroy(&dom->records_lock);
+}
+
+/**
+ * @brief Publishes the pointer read from @p src and validates it is still current.
+ *
+ * The seq_cst store/load pair guarantees a scanner either sees the hazard or
+ * this thread sees the unlink and retries with the new value.
+ *
+ * @param dom Pointer to the domain.
+ * @param slot Hazard slot index.
+ * @param src Shared location holding the pointer.
+ * @return The protected pointer.
+ */
+void *ttak_hazard_protect(ttak_hazard_domain_t *dom, int slot, void *_Atomic *src) {
+    ttak_hazard_record_t *rec = local_record(dom);
+    if (!rec || slot < 0 || slot >= TTAK_HAZARD_SLOTS) return NULL;
+
+    void *ptr = atomic_load_explicit(src, memory_order_acquire);
+    for (;;) {
+        atomic_store_explicit(&rec->slots[slot], ptr, memory_order_seq_cst);
+        void *again = atomic_load_explicit(src, memory_order_seq_cst);
+        if (again == ptr) return ptr;
+        ptr = again;
+    }
+}
+
+/**
+ * @brief Publishes an already-protected pointer in a slot.
+ *
+ * @param dom Pointer to the domain.
+ * @param slot Hazard slot index.
+ * @param ptr Pointer to protect, or NULL.
+ */
+void ttak_hazard_set(ttak_hazard_domain_t *dom, int slot, void *ptr) {
+    ttak_hazard_record_t *rec = local_record(dom);
+    if (!rec || slot < 0 || slot >= TTAK_HAZARD_SLOTS) return;
+    atomic_store_explicit(&rec->slots[slot], ptr, memory_order_seq_cst);
+}
+
+/**
+ * @brief Clears a hazard slot.
+ *
+ * @param dom Pointer to the domain.
+ * @param slot Hazard slot index.
+ */
+void ttak_hazard_clear(ttak_hazard_domain_t *dom, int slot) {
+    ttak_hazard_record_t *rec = find_record(dom);
+    if (!rec || slot < 0 || slot >= TTAK_HAZARD_SLOTS) return;
+    atomic_store_explicit(&rec->slots[slot], NULL, memory_order_release);
+}
+
+/**
+ * @brief Reclaims the caller's retired blocks that no hazard slot protects.
+ *
+ * Takes a sorted snapshot of every published slot, then binary-searches it
+ * for each retired block, so a scan costs O(R log H) for R retired blocks and
+ * H slots.
+ *
+ * @param dom Pointer to the domain.
+ * @return Number of blocks reclaimed.
+ */
+size_t ttak_hazard_scan(ttak_hazard_domain_t *dom) {
+    ttak_hazard_record_t *self = local_record(dom);
+    if (!self) return 0;
+
+    // Adopt orphans so blocks of exited threads are not stranded.
+    pthread_mutex_lock(&dom->records_lock);
+    while (dom->orphans) {
+        ttak_hazard_retired_t *entry = dom->orphans;
+        dom->orphans = entry->next;
+        entry->next = self->retired;
+        self->retired = entry;
+        self->retired_count++;
+    }
+    pthread_mutex_unlock(&dom->records_lock);
+
+    if (!self->retired) return 0;
+
+    // Records are only ever pushed at the head, so the list below a snapshot
+    // is stable. Records bound later cannot validate a pointer retired before now.
+    atomic_thread_fence(memory_order_seq_cst);
+    ttak_hazard_record_t *head = atomic_load_explicit(&dom->records, memory_order_acquire);
+    size_t capacity = 0;
+    for (ttak_hazard_record_t *rec = head; rec; rec = rec->next) {
+        capacity += TTAK_HAZARD_SLOTS;
+    }
+    void **hazards = malloc(capacity * sizeof(void *));
+    if (!hazards) return 0;
+
+    size_t hazard_count = 0;
+    for (ttak_hazard_record_t *rec = head; rec; rec = rec->next) {
+        for (int i = 0; i < TTAK_HAZARD_SLOTS; i++) {
+            void *ptr = atomic_load_explicit(&rec->slots[i], memory_order_seq_cst);
+            if (ptr) hazards[hazard_count++] = ptr;
+        }
+    }
+    qsort(hazards, hazard_count, sizeof(void *), compare_ptr);
+
+    size_t reclaimed = 0;
+    ttak_hazard_retired_t **indirect = &self->retired;
+    while (*indirect) {
+        ttak_hazard_retired_t *entry = *indirect;
+        if (hazard_count && bsearch(&entry->ptr, hazards, hazard_count, sizeof(void *), compare_ptr)) {
+            indirect = &entry->next;
+            continue;
+        }
+        *indirect = entry->next;
+        entry->cleanup(entry->ptr);
+        free(entry);
+        reclaimed++;
+    }
+    self->retired_count -= reclaimed;
+    free(hazards);
+    return reclaimed;
+}
+
+/**
+ * @brief Queues a block for reclamation and scans once the list grows past its bound.
+ *
+ * @param dom Pointer to the domain.
+ * @param ptr Block to retire.
+ * @param cleanup Reclaim callback, or NULL for ttak_mem_free.
+ */
+void ttak_hazard_retire(ttak_hazard_domain_t *dom, void *ptr, ttak_hazard_cleanup_t cleanup) {
+    if (!ptr) return;
+    if (!cleanup) cleanup = ttak_mem_free;
+
+    ttak_hazard_record_t *rec = local_record(dom);
+    ttak_hazard_retired_t *entry = malloc(sizeof(ttak_hazard_retired_t));
+    if (!rec || !entry) {
+        // Without bookkeeping the block cannot be tracked; leaking beats freeing under a reader.
+        free(entry);
+        return;
+    }
+    entry->ptr = ptr;
+    entry->cleanup = cleanup;
+    entry->next = rec->retired;
+    rec->retired = entry;
+    rec->retired_count++;
+
+    size_t bound = 2 * TTAK_HAZARD_SLOTS * atomic_load_explicit(&dom->record_count, memory_order_relaxed);
+    if (bound < TTAK_HAZARD_MIN_SCAN) bound = TTAK_HAZARD_MIN_SCAN;
+    if (rec->retired_count >= bound) {
+        ttak_hazard_scan(dom);
+    }
+}
+
+/**
+ * @brief Clears the caller's slots, hands leftovers to the domain and unbinds.
+ *
+ * @param dom Pointer to the domain.
+ */
+void ttak_hazard_unregister_thread(ttak_hazard_domain_t *dom) {
+    ttak_hazard_record_t *rec = find_record(dom);
+    if (!rec) return;
+
+    for (int i = 0; i < TTAK_HAZARD_SLOTS; i++) {
+        atomic_store_explicit(&rec->slots[i], NULL, memory_order_release);
+    }
+    ttak_hazard_scan(dom);
+
+    pthread_mutex_lock(&dom->records_lock);
+    while (rec->retired) {
+        ttak_hazard_retired_t *entry = rec->retired;
+        rec->retired = entry->next;
+        entry->next = dom->orphans;
+        dom->orphans = entry;
+    }
+    rec->retired_count = 0;
+    rec->owned = false;
+    pthread_mutex_unlock(&dom->records_lock);
+    forget_record(dom);
+}
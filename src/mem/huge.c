@@ -0,0 +1,257 @@
+/**
+ * @file huge.c
+ * @brief Pooled huge-page backing for TTAK_MEM_HUGE_PAGES allocations.
+ *
+ * Small and medium blocks are bump-carved from shared 2 MB regions that are
+ * aligned to their size, so the region owning a block is found by masking
+ * its address. A region keeps a live-block count and is rewound (or unmapped)
+ * when it drops to zero. Blocks above TTAK_HUGE_MAX_CARVE get a dedicated
+ * mapping with a one-cache-line prefix. Every mapping records whether it got
+ * hugetlbfs pages, transparent huge pages or regular pages.
+ */
+
+#include <ttak/mem/huge.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#define TTAK_HUGE_MAGIC 0x48554745U /* "HUGE" */
+#define HUGE_PREFIX 64
+#define HUGE_ALIGN 64
+#define HUGE_MASK ((uintptr_t)TTAK_HUGE_REGION_SIZE - 1)
+
+/**
+ * @brief Bookkeeping stored in the first cache line of every mapping.
+ */
+typedef struct ttak_huge_region {
+    uint32_t magic;                 /**< TTAK_HUGE_MAGIC */
+    uint32_t backing;               /**< ttak_huge_backing_t */
+    size_t map_size;                /**< Bytes mapped */
+    size_t cursor;                  /**< Next free offset (regions only) */
+    size_t live;                    /**< Blocks handed out (regions only) */
+} ttak_huge_region_t;
+
+_Static_assert(sizeof(ttak_huge_region_t) <= HUGE_PREFIX, "region header must fit its prefix");
+
+static pthread_mutex_t huge_lock = PTHREAD_MUTEX_INITIALIZER;
+static ttak_huge_region_t *active_region = NULL;
+static ttak_huge_region_t *spare_region = NULL;
+static ttak_huge_stats_t huge_stats;
+
+static inline size_t round_up(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief Maps @p size bytes (a multiple of 2 MB) aligned to 2 MB.
+ *
+ * MAP_HUGETLB is tried first. Without reserved hugetlbfs pages an
+ * over-sized anonymous mapping is trimmed to alignment and advised with
+ * MADV_HUGEPAGE so the kernel can back it with transparent huge pages.
+ */
+static void *map_huge(size_t size, ttak_huge_backing_t *backing) {
+#ifdef MAP_HUGETLB
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem != MAP_FAILED) {
+        *backing = TTAK_HUGE_BACKING_HUGETLB;
+        return mem;
+    }
+#endif
+
+    size_t span = size + TTAK_HUGE_REGION_SIZE;
+    char *raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+
+    char *aligned = (char *)round_up((uintptr_t)raw, TTAK_HUGE_REGION_SIZE);
+    size_t head = (size_t)(aligned - raw);
+    size_t tail = span - head - size;
+    if (head) munmap(raw, head);
+    if (tail) munmap(aligned + size, tail);
+
+    *backing = TTAK_HUGE_BACKING_NONE;
+#ifdef MADV_HUGEPAGE
+    if (madvise(aligned, size, MADV_HUGEPAGE) == 0) {
+        *backing = TTAK_HUGE_BACKING_THP;
+    }
+#endif
+    return aligned;
+}
+
+/**
+ * @brief Maps a fresh shared region. Called with huge_lock held.
+ */
+static ttak_huge_region_t *region_create(void) {
+    ttak_huge_backing_t backing;
+    ttak_huge_region_t *region = map_huge(TTAK_HUGE_REGION_SIZE, &backing);
+    if (!region) return NULL;
+    region->magic = TTAK_HUGE_MAGIC;
+    region->backing = backing;
+    region->map_size = TTAK_HUGE_REGION_SIZE;
+    region->cursor = HUGE_PREFIX;
+    region->live = 0;
+    huge_stats.regions[backing]++;
+    huge_stats.mapped_bytes += TTAK_HUGE_REGION_SIZE;
+    return region;
+}
+
+/**
+ * @brief Unmaps or caches an empty region. Called with huge_lock held.
+ */
+static void region_recycle(ttak_huge_region_t *region) {
+    region->cursor = HUGE_PREFIX;
+    if (!spare_region) {
+        spare_region = region;
+        return;
+    }
+    huge_stats.regions[region->backing]--;
+    huge_stats.mapped_bytes -= region->map_size;
+    munmap(region, region->map_size);
+}
+
+/**
+ * @brief Allocates a huge-page backed block.
+ */
+void *ttak_huge_alloc(size_t size) {
+    if (size == 0 || size > SIZE_MAX - 2 * TTAK_HUGE_REGION_SIZE) return NULL;
+
+    if (size > TTAK_HUGE_MAX_CARVE) {
+        size_t map_size = round_up(size + HUGE_PREFIX, TTAK_HUGE_REGION_SIZE);
+        ttak_huge_backing_t backing;
+        ttak_huge_region_t *mapping = map_huge(map_size, &backing);
+        if (!mapping) return NULL;
+        mapping->magic = TTAK_HUGE_MAGIC;
+        mapping->backing = backing;
+        mapping->map_size = map_size;
+        mapping->cursor = 0;
+        mapping->live = 1;
+
+        pthread_mutex_lock(&huge_lock);
+        huge_stats.dedicated[backing]++;
+        huge_stats.live_blocks++;
+        huge_stats.mapped_bytes += map_size;
+        pthread_mutex_unlock(&huge_lock);
+        return (char *)mapping + HUGE_PREFIX;
+    }
+
+    size = round_up(size, HUGE_ALIGN);
+    pthread_mutex_lock(&huge_lock);
+    ttak_huge_region_t *region = active_region;
+    if (!region || region->cursor + size > TTAK_HUGE_REGION_SIZE) {
+        // The full region stays mapped until its remaining blocks are freed.
+        if (region && region->live == 0) {
+            region_recycle(region);
+        }
+        if (spare_region) {
+            region = spare_region;
+            spare_region = NULL;
+        } else {
+            region = region_create();
+        }
+        active_region = region;
+        if (!region) {
+            pthread_mutex_unlock(&huge_lock);
+            return NULL;
+        }
+    }
+    void *ptr = (char *)region + region->cursor;
+    region->cursor += size;
+    region->live++;
+    huge_stats.live_blocks++;
+    pthread_mutex_unlock(&huge_lock);
+    return ptr;
+}
+
+/**
+ * @brief Returns a block to its region or unmaps its dedicated mapping.
+ */
+void ttak_huge_free(void *ptr, size_t size) {
+    if (!ptr) return;
+
+    if (size > TTAK_HUGE_MAX_CARVE) {
+        ttak_huge_region_t *mapping = (ttak_huge_region_t *)((char *)ptr - HUGE_PREFIX);
+        size_t map_size = mapping->map_size;
+        pthread_mutex_lock(&huge_lock);
+        huge_stats.dedicated[mapping->backing]--;
+        huge_stats.live_blocks--;
+        huge_stats.mapped_bytes -= map_size;
+        pthread_mutex_unlock(&huge_lock);
+        munmap(mapping, map_size);
+        return;
+    }
+
+    ttak_huge_region_t *region = (ttak_huge_region_t *)((uintptr_t)ptr & ~HUGE_MASK);
+    pthread_mutex_lock(&huge_lock);
+    huge_stats.live_blocks--;
+    if (--region->live == 0) {
+        if (region == active_region) {
+            region->cursor = HUGE_PREFIX;
+        } else {
+            region_recycle(region);
+        }
+    }
+    pthread_mutex_unlock(&huge_lock);
+}
+
+/**
+ * @brief Resizes a block in place.
+ */
+_Bool ttak_huge_resize(void *ptr, size_t old_size, size_t new_size) {
+    if (!ptr || new_size == 0 || new_size > SIZE_MAX - 2 * TTAK_HUGE_REGION_SIZE) return 0;
+    if ((old_size > TTAK_HUGE_MAX_CARVE) != (new_size > TTAK_HUGE_MAX_CARVE)) return 0;
+
+    if (old_size > TTAK_HUGE_MAX_CARVE) {
+        ttak_huge_region_t *mapping = (ttak_huge_region_t *)((char *)ptr - HUGE_PREFIX);
+        size_t need = round_up(new_size + HUGE_PREFIX, TTAK_HUGE_REGION_SIZE);
+        if (need <= mapping->map_size) return 1;
+#ifdef MREMAP_MAYMOVE
+        // Without MREMAP_MAYMOVE the kernel only extends into free address space.
+        if (mremap(mapping, mapping->map_size, need, 0) == MAP_FAILED) return 0;
+#ifdef MADV_HUGEPAGE
+        if (mapping->backing == TTAK_HUGE_BACKING_THP) {
+            madvise((char *)mapping + mapping->map_size, need - mapping->map_size, MADV_HUGEPAGE);
+        }
+#endif
+        pthread_mutex_lock(&huge_lock);
+        huge_stats.mapped_bytes += need - mapping->map_size;
+        pthread_mutex_unlock(&huge_lock);
+        mapping->map_size = need;
+        return 1;
+#else
+        return 0;
+#endif
+    }
+
+    size_t old_span = round_up(old_size, HUGE_ALIGN);
+    size_t new_span = round_up(new_size, HUGE_ALIGN);
+    ttak_huge_region_t *region = (ttak_huge_region_t *)((uintptr_t)ptr & ~HUGE_MASK);
+    pthread_mutex_lock(&huge_lock);
+    _Bool last = (region == active_region) && (char *)ptr + old_span == (char *)region + region->cursor;
+    _Bool ok = new_span <= old_span || (last && region->cursor - old_span + new_span <= TTAK_HUGE_REGION_SIZE);
+    if (ok && last) {
+        region->cursor = region->cursor - old_span + new_span;
+    }
+    pthread_mutex_unlock(&huge_lock);
+    return ok;
+}
+
+/**
+ * @brief Reports the backing of the mapping holding a block.
+ */
+ttak_huge_backing_t ttak_huge_backing_of(const void *ptr, size_t size) {
+    const ttak_huge_region_t *region;
+    if (size > TTAK_HUGE_MAX_CARVE) {
+        region = (const ttak_huge_region_t *)((const char *)ptr - HUGE_PREFIX);
+    } else {
+        region = (const ttak_huge_region_t *)((uintptr_t)ptr & ~HUGE_MASK);
+    }
+    return region->magic == TTAK_HUGE_MAGIC ? (ttak_huge_backing_t)region->backing : TTAK_HUGE_BACKING_NONE;
+}
+
+/**
+ * @brief Copies the manager's counters.
+ */
+void ttak_huge_get_stats(ttak_huge_stats_t *out) {
+    if (!out) return;
+    pthread_mutex_lock(&huge_lock);
+    *out = huge_stats;
+    pthread_mutex_unlock(&huge_lock);
+}
@@ -1,36 +1,129 @@
 #include <ttak/mem/mem.h>
 #include <ttak/atomic/atomic.h>
-#include <ttak/ht/map.h>
 #include <ttak/timing/timing.h>
 #include <ttak/mem_tree/mem_tree.h> // Include for mem tree integration
+#include <ttak/mem/slab.h>
+#include <ttak/mem/arena.h>
+#include <ttak/mem/huge.h>
+#include <ttak/mem/generation.h>
+#include <ttak/mem/trace.h>
+#include <ttak/mem/profile.h>
 #include "../../internal/app_types.h"
 #include <stdlib.h>
+#include <malloc.h>
 #include <string.h>
 #include <pthread.h>
 #include <limits.h>
 #include <errno.h>
-#include <sys/mman.h>
 #include <unistd.h>
 #include <stdalign.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <time.h>
 
 #define TTAK_CANARY_START_MAGIC 0xDEADBEEFDEADBEEFULL
 #define TTAK_CANARY_END_MAGIC   0xBEEFDEADBEEFDEADULL
 
-#ifndef TTAK_THREAD_LOCAL
-#if defined(__TINYC__)
-#define TTAK_THREAD_LOCAL
+/**
+ * @brief Access count above which an allocation is reported as dirty.
+ *
+ * Compact headers count in 16 bits, so they report a block sooner.
+ */
+#if defined(TTAK_MEM_COMPACT_HEADER)
+#define TTAK_MEM_DIRTY_ACCESS_LIMIT (UINT16_MAX - 1ULL)
 #else
-#define TTAK_THREAD_LOCAL _Thread_local
-#endif
+#define TTAK_MEM_DIRTY_ACCESS_LIMIT 1000000ULL
 #endif
 
+/**
+ * @brief Blocks registered or unregistered per registry splice by the batch API.
+ */
+#define TTAK_MEM_BATCH_CHUNK 64
+
+/**
+ * @brief Due nodes examined per shard lock hold by tt_sweep_dirty_pointers.
+ */
+#define TTAK_MEM_SWEEP_SLICE 64
+
+/**
+ * @brief Default pause between background sweeper steps (10 ms).
+ */
+#define TTAK_MEM_SWEEP_INTERVAL_NS 10000000ULL
+
 static volatile uint64_t global_mem_usage = 0;
-static pthread_mutex_t global_map_lock = PTHREAD_MUTEX_INITIALIZER;
-static ttak_mem_tree_t global_mem_tree; // Global instance of the mem tree
+static ttak_mem_tree_t global_mem_tree; // Global allocation registry (sharded, O(1) lookup)
 static int global_trace_enabled = 0;
+static int global_access_mode = TTAK_MEM_ACCESS_ATOMIC;
+static int global_generational = 0;
+
+#define STATE_WORD(h) ((_Atomic uint64_t *)&(h)->state)
+
+#if defined(TTAK_MEM_COMPACT_HEADER)
+#define TTAK_MEM_LOCK_STRIPES 64
+
+static pthread_mutex_t header_lock_stripes[TTAK_MEM_LOCK_STRIPES];
+static pthread_once_t header_lock_once = PTHREAD_ONCE_INIT;
+
+static void header_locks_init(void) {
+    for (size_t i = 0; i < TTAK_MEM_LOCK_STRIPES; i++) {
+        pthread_mutex_init(&header_lock_stripes[i], NULL);
+    }
+}
+
+/**
+ * @brief Compact headers have no mutex; map them onto a fixed set of striped locks.
+ */
+static inline pthread_mutex_t *header_lock(const ttak_mem_header_t *h) {
+    pthread_once(&header_lock_once, header_locks_init);
+    return &header_lock_stripes[((uintptr_t)h >> 5) & (TTAK_MEM_LOCK_STRIPES - 1)];
+}
+
+#define HEADER_LOCK(h) header_lock(h)
+#define HEADER_ACCESS_COUNT(h) ((uint64_t)atomic_load_explicit((_Atomic uint16_t *)&(h)->access_count, memory_order_relaxed))
+#else
+#define HEADER_LOCK(h) (&(h)->lock)
+#define HEADER_ACCESS_COUNT(h) ttak_atomic_read64(&(h)->access_count)
+#endif
+
+#if defined(TTAK_MEM_COMPACT_HEADER)
+#define V_CANARY_START(h, ptr) ((void)0)
+#else
+#define V_CANARY_START(h, ptr) do { \
+    if ((h)->canary_start != TTAK_CANARY_START_MAGIC) { \
+        fprintf(stderr, "[FATAL] TTAK Memory Corruption detected at %p (Start canary corrupted in header)\n", (void*)ptr); \
+        abort(); \
+    } \
+} while(0)
+#endif
+
+/**
+ * @brief Whether a header and its end canary read consistently.
+ */
+static inline bool header_intact(const ttak_mem_header_t *h, const void *ptr) {
+    if (h->magic != TTAK_MAGIC_NUMBER || h->checksum != ttak_calc_header_checksum(h)) return false;
+    return !h->strict_check || *(const uint64_t *)((const char *)ptr + h->size) == TTAK_CANARY_END_MAGIC;
+}
+
+/**
+ * @brief Re-validate a header that failed the lock-free check, under its lock.
+ *
+ * An in-place resize rewrites the expiry, size, checksum and end canary
+ * under the header lock, so a lock-free reader can catch them half way.
+ * Only a mismatch that persists under the lock is corruption.
+ */
+static TTAK_COLD_PATH void header_recheck(ttak_mem_header_t *h, const void *ptr) {
+    pthread_mutex_lock(HEADER_LOCK(h));
+    bool header_ok = h->magic == TTAK_MAGIC_NUMBER && h->checksum == ttak_calc_header_checksum(h);
+    bool intact = header_ok && header_intact(h, ptr);
+    pthread_mutex_unlock(HEADER_LOCK(h));
+    if (!intact) {
+        fprintf(stderr, "[FATAL] TTAK Memory Corruption detected at %p (%s)\n", ptr,
+                header_ok ? "End canary corrupted" : "Header corrupted");
+        abort();
+    }
+}
 
 /**
  * @brief Internal validation macro.
@@ -38,32 +131,33 @@ static int global_trace_enabled = 0;
 #define V_HEADER(ptr) do { \
     if (!ptr) break; \
     ttak_mem_header_t *_h = (ttak_mem_header_t *)(ptr) - 1; \
-    if (_h->magic != TTAK_MAGIC_NUMBER || _h->checksum != ttak_calc_header_checksum(_h)) { \
-        fprintf(stderr, "[FATAL] TTAK Memory Corruption detected at %p (Header corrupted)\n", (void*)ptr); \
-        abort(); \
+    if (_h->magic == TTAK_MAGIC_NUMBER && _h->strict_check) { \
+        V_CANARY_START(_h, ptr); \
     } \
-    if (_h->strict_check) { \
-        if (_h->canary_start != TTAK_CANARY_START_MAGIC) { \
-            fprintf(stderr, "[FATAL] TTAK Memory Corruption detected at %p (Start canary corrupted in header)\n", (void*)ptr); \
-            abort(); \
-        } \
-        uint64_t *canary_end_ptr = (uint64_t *)((char *)ptr + _h->size); \
-        if (*canary_end_ptr != TTAK_CANARY_END_MAGIC) { \
-            fprintf(stderr, "[FATAL] TTAK Memory Corruption detected at %p (End canary corrupted)\n", (void*)ptr); \
-            abort(); \
-        } \
+    if (!header_intact(_h, ptr)) { \
+        header_recheck(_h, ptr); \
     } \
 } while(0)
 
 #define GET_HEADER(ptr) ((ttak_mem_header_t *)(ptr) - 1)
 #define GET_USER_PTR(header) ((void *)((ttak_mem_header_t *)(header) + 1))
 
-static volatile tt_map_t *global_ptr_map = NULL;
 static pthread_mutex_t global_init_lock = PTHREAD_MUTEX_INITIALIZER;
-TTAK_THREAD_LOCAL int in_mem_op = 0;
 TTAK_THREAD_LOCAL int in_mem_init = 0;
 static volatile int global_init_done = 0;
 
+/**
+ * @brief Block freed while still pinned, waiting for its last reader.
+ */
+typedef struct ttak_mem_deferred {
+    ttak_mem_header_t *header;
+    struct ttak_mem_deferred *next;
+} ttak_mem_deferred_t;
+
+static pthread_mutex_t deferred_lock = PTHREAD_MUTEX_INITIALIZER;
+static ttak_mem_deferred_t *deferred_head = NULL;
+static size_t deferred_count = 0;
+
 /**
  * @brief Returns whether memory tracing is currently enabled.
  */
@@ -72,47 +166,31 @@ int ttak_mem_is_trace_enabled(void) {
 }
 
 /**
- * @brief Toggles memory tracing globally and for all existing allocations.
+ * @brief Toggles memory tracing.
+ *
+ * Events go to the per-thread binary rings of trace.c; enabling starts the
+ * drain thread and disabling flushes and stops it.
  */
 void ttak_mem_set_trace(int enable) {
-    global_trace_enabled = enable;
-    if (!global_init_done) return;
-
-    pthread_mutex_lock(&global_map_lock);
-    tt_map_t *map_handle = (tt_map_t *)global_ptr_map;
-    if (map_handle) {
-        for (size_t i = 0; i < map_handle->cap; i++) {
-            if (map_handle->tbl[i].ctrl == OCCUPIED) {
-                ttak_mem_header_t *h = (ttak_mem_header_t *)map_handle->tbl[i].value;
-                pthread_mutex_lock(&h->lock);
-                if (enable && !h->tracking_log) {
-                    h->tracking_log = malloc(1024);
-                    if (h->tracking_log) {
-                        snprintf(h->tracking_log, 1024, "{\"event\":\"trace_enabled\",\"ts\":%lu}", ttak_get_tick_count());
-                    }
-                } else if (!enable && h->tracking_log) {
-                    free(h->tracking_log);
-                    h->tracking_log = NULL;
-                }
-                pthread_mutex_unlock(&h->lock);
-            }
-        }
+    if (enable) {
+        if (global_trace_enabled || ttak_trace_start() != 0) return;
+        global_trace_enabled = 1;
+        ttak_trace_emit(TTAK_TRACE_ENABLED, NULL, 0, 0, ttak_get_tick_count(), NULL);
+    } else if (global_trace_enabled) {
+        global_trace_enabled = 0;
+        ttak_trace_stop();
     }
-    pthread_mutex_unlock(&global_map_lock);
 }
 
 /**
- * @brief Lazily initialize the global pointer map and mem tree.
- *
- * @param now Timestamp propagated to the map allocator.
+ * @brief Lazily initialize the global allocation registry.
  */
-static void ensure_global_map(uint64_t now) {
+static void ensure_global_registry(void) {
     if (global_init_done || in_mem_init) return;
 
     pthread_mutex_lock(&global_init_lock);
-    if (!global_ptr_map && !global_init_done) {
+    if (!global_init_done) {
         in_mem_init = true;
-        global_ptr_map = ttak_create_map(8192, now);
         ttak_mem_tree_init(&global_mem_tree); // Initialize the global mem tree
         global_init_done = true;
         in_mem_init = false;
@@ -121,33 +199,88 @@ static void ensure_global_map(uint64_t now) {
 }
 
 /**
- * @brief Allocate tracked memory with metadata headers and optional strict checks.
+ * @brief Whether a new block should be carved from a lifetime generation.
+ */
+static inline bool mem_wants_generation(ttak_mem_flags_t flags, uint64_t lifetime_ticks, size_t total_alloc_size) {
+    if (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__ || total_alloc_size > TTAK_GEN_MAX_BLOCK) return false;
+    if (flags & (TTAK_MEM_HUGE_PAGES | TTAK_MEM_NO_GENERATION)) return false;
+    return (flags & TTAK_MEM_GENERATIONAL) || global_generational;
+}
+
+/**
+ * @brief Drop expired generations and take their unfreed blocks off the usage counter.
+ */
+static void mem_gen_reclaim(uint64_t now) {
+    size_t bytes = ttak_gen_reclaim(now);
+    if (bytes) {
+        ttak_atomic_sub64(&global_mem_usage, bytes);
+    }
+}
+
+/**
+ * @brief Pin the generation segment of @p ptr (if any) before its header is read.
  *
- * @param size           Number of bytes requested.
- * @param lifetime_ticks Lifetime hint for automatic reclamation.
- * @param now            Current timestamp.
- * @param is_const       Marks the buffer as immutable.
- * @param is_volatile    Indicates volatile access patterns.
- * @param allow_direct   If false, ttak_mem_access will refuse direct pointers.
- * @param is_root        Marks the allocation as externally referenced for the mem tree.
- * @param flags          Allocation behavior flags.
- * @return Pointer to zeroed user memory or NULL on failure.
+ * @return false if @p ptr belongs to a generation that was already reclaimed.
  */
-void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, uint64_t now, _Bool is_const, _Bool is_volatile, _Bool allow_direct, _Bool is_root, ttak_mem_flags_t flags) {
+static inline bool mem_gen_enter(const void *ptr) {
+    return !ttak_gen_contains(ptr) || ttak_gen_pin(ptr);
+}
+
+/**
+ * @brief Drop the segment pin taken by mem_gen_enter.
+ */
+static inline void mem_gen_leave(const void *ptr) {
+    if (ttak_gen_contains(ptr)) {
+        ttak_gen_unpin(ptr);
+    }
+}
+
+/**
+ * @brief Allocate and initialize a block without registering it.
+ *
+ * Parameters match ttak_mem_alloc_safe. Kept out of line so every sampled
+ * backtrace has exactly one constructor frame for the profiler to drop.
+ *
+ * @return Header of a block with zeroed user memory, or NULL on failure.
+ */
+static TTAK_NOINLINE ttak_mem_header_t *mem_block_create(size_t size, uint64_t lifetime_ticks, uint64_t now, _Bool is_const, _Bool is_volatile, _Bool allow_direct, _Bool is_root, ttak_mem_flags_t flags) {
     size_t header_size = sizeof(ttak_mem_header_t);
     bool strict_check_enabled = (flags & TTAK_MEM_STRICT_CHECK);
     size_t canary_padding = strict_check_enabled ? sizeof(uint64_t) : 0;
     size_t total_alloc_size = header_size + canary_padding + size;
     ttak_mem_header_t *header = NULL;
     bool is_huge = false;
+    bool is_slab = false;
+    bool is_gen = false;
+
+#if defined(TTAK_MEM_COMPACT_HEADER)
+    if (size > UINT32_MAX) {
+        errno = ENOMEM;
+        return NULL;
+    }
+#endif
 
     if (flags & TTAK_MEM_HUGE_PAGES) {
-        header = mmap(NULL, total_alloc_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
-        if (header != MAP_FAILED) {
-            is_huge = true;
-        } else {
-            header = NULL;
+        // Carved from a shared 2 MB region; only a region's first block maps memory.
+        header = ttak_huge_alloc(total_alloc_size);
+        is_huge = (header != NULL);
+    }
+
+    if (!header && mem_wants_generation(flags, lifetime_ticks, total_alloc_size)) {
+        // Bump-carved from the generation of its expiry bucket and dropped with it.
+        uint64_t deadline = ttak_gen_deadline(now + lifetime_ticks, lifetime_ticks);
+        header = ttak_gen_alloc(total_alloc_size, deadline);
+        if (!header) {
+            mem_gen_reclaim(now);
+            header = ttak_gen_alloc(total_alloc_size, deadline);
         }
+        is_gen = (header != NULL);
+    }
+
+    if (!header && total_alloc_size <= TTAK_SLAB_MAX_BLOCK) {
+        // Small blocks come from the calling thread's slab cache (no global lock)
+        header = ttak_slab_alloc(total_alloc_size);
+        is_slab = (header != NULL);
     }
 
     if (!header) {
@@ -162,7 +295,7 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
         if (!retrying) {
             retrying = 1;
             tt_autoclean_dirty_pointers(now);
-            void *res = ttak_mem_alloc_safe(size, lifetime_ticks, now, is_const, is_volatile, allow_direct, is_root, flags);
+            ttak_mem_header_t *res = mem_block_create(size, lifetime_ticks, now, is_const, is_volatile, allow_direct, is_root, flags);
             retrying = 0;
             return res;
         }
@@ -170,60 +303,180 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
 
     if (!header) return NULL;
 
+    uint64_t expires_tick = (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) ? (uint64_t)-1 : now + lifetime_ticks;
     header->magic = TTAK_MAGIC_NUMBER;
-    header->created_tick = now;
-    header->expires_tick = (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) ? (uint64_t)-1 : now + lifetime_ticks;
-    header->access_count = 0;
-    header->pin_count = 0;
+    header->state = ttak_mem_state_encode_expiry(expires_tick);
     header->size = size;
-    header->freed = false;
     header->is_const = is_const;
     header->is_volatile = is_volatile;
     header->allow_direct_access = allow_direct;
     header->is_huge = is_huge;
+    header->is_slab = is_slab;
+    header->is_arena = false;
+    header->is_sampled = false;
+    header->is_gen = is_gen;
+    header->tree_node = NULL;
     header->should_join = false; // Default to false, can be set later if needed
     header->strict_check = strict_check_enabled;
     header->is_root = is_root;
+    header->access_count = 0;
+#if !defined(TTAK_MEM_COMPACT_HEADER)
+    header->created_tick = now;
+    header->expires_tick = expires_tick;
     header->canary_start = strict_check_enabled ? TTAK_CANARY_START_MAGIC : 0;
     header->canary_end = strict_check_enabled ? TTAK_CANARY_END_MAGIC : 0;
     pthread_mutex_init(&header->lock, NULL);
+#endif
     header->checksum = ttak_calc_header_checksum(header);
 
     if (global_trace_enabled) {
-        header->tracking_log = malloc(1024);
-        if (header->tracking_log) {
-            snprintf(header->tracking_log, 1024, 
-                     "{\"event\":\"alloc\",\"ptr\":\"%p\",\"size\":%zu,\"ts\":%lu,\"root\":%d}", 
-                     (void*)((char*)header + header_size), size, now, (int)is_root);
-            fprintf(stderr, "[MEM_TRACK] %s\n", header->tracking_log);
-        }
-    } else {
-        header->tracking_log = NULL;
+        ttak_trace_emit(TTAK_TRACE_ALLOC, (char *)header + header_size, size, is_root, now, NULL);
     }
 
     ttak_atomic_add64(&global_mem_usage, total_alloc_size);
 
-    void *user_ptr = (char *)header + header_size;
+    void *user_ptr = GET_USER_PTR(header);
     memset(user_ptr, 0, size);
 
     if (strict_check_enabled) {
         *((uint64_t *)((char *)user_ptr + size)) = TTAK_CANARY_END_MAGIC;
     }
 
-    ensure_global_map(now);
-    tt_map_t *map_handle = (tt_map_t *)global_ptr_map;
-    if (global_init_done && !in_mem_init && !in_mem_op && map_handle) {
-        pthread_mutex_lock(&global_map_lock);
-        in_mem_op = true;
-        if (is_root) { ttak_insert_to_map(map_handle, (uintptr_t)user_ptr, (size_t)header, now); }
-        ttak_mem_tree_add(&global_mem_tree, user_ptr, size, header->expires_tick, is_root); // Add to mem tree
-        in_mem_op = false;
-        pthread_mutex_unlock(&global_map_lock);
+    // One allocation per sampling interval (in bytes) records its call site.
+    if (ttak_profile_should_sample(size)) {
+        header->is_sampled = ttak_profile_record_alloc(user_ptr, size, lifetime_ticks);
+        if (header->is_sampled && is_gen) {
+            ttak_gen_note_sampled(user_ptr);
+        }
+    }
+
+    if (is_gen) {
+        ttak_gen_unpin(header);
+    }
+    return header;
+}
+
+/**
+ * @brief Whether a fresh block belongs in the global registry.
+ *
+ * Forever-lived slab blocks can never expire, so they stay off the global
+ * registry and the small-object fast path never takes a registry lock.
+ * Generation blocks are reclaimed with their generation, not by the sweep.
+ */
+static inline bool mem_block_tracked(const ttak_mem_header_t *header, uint64_t lifetime_ticks) {
+    if (header->is_gen) return false;
+    return !(header->is_slab && lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__);
+}
+
+/**
+ * @brief Allocate tracked memory with metadata headers and optional strict checks.
+ *
+ * @param size           Number of bytes requested.
+ * @param lifetime_ticks Lifetime hint for automatic reclamation.
+ * @param now            Current timestamp.
+ * @param is_const       Marks the buffer as immutable.
+ * @param is_volatile    Indicates volatile access patterns.
+ * @param allow_direct   If false, ttak_mem_access will refuse direct pointers.
+ * @param is_root        Marks the allocation as externally referenced for the mem tree.
+ * @param flags          Allocation behavior flags.
+ * @return Pointer to zeroed user memory or NULL on failure.
+ */
+void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, uint64_t now, _Bool is_const, _Bool is_volatile, _Bool allow_direct, _Bool is_root, ttak_mem_flags_t flags) {
+    ttak_mem_header_t *header = mem_block_create(size, lifetime_ticks, now, is_const, is_volatile, allow_direct, is_root, flags);
+    if (!header) return NULL;
+
+    void *user_ptr = GET_USER_PTR(header);
+    if (!mem_block_tracked(header, lifetime_ticks)) {
+        return user_ptr;
+    }
+
+    ensure_global_registry();
+    if (global_init_done) {
+        // Only the owning registry shard is locked; the node is kept in the
+        // header so ttak_mem_free can unlink it without a lookup.
+        uint64_t expires_tick = (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) ? (uint64_t)-1 : now + lifetime_ticks;
+        header->tree_node = ttak_mem_tree_add(&global_mem_tree, user_ptr, size, expires_tick, is_root);
     }
 
     return user_ptr;
 }
 
+/**
+ * @brief Resize a block without moving it, if its backing has room.
+ *
+ * Slab blocks grow into the slack of their size class, heap blocks into the
+ * usable size malloc reports, and huge blocks through ttak_huge_resize.
+ * Shrinking never moves. The header, its registry node and the pins stay
+ * where they are; the new lifetime is written into the state word and the
+ * node is moved to the matching timer slot. Blocks whose root flag or
+ * registry membership would change are left to the copying path.
+ *
+ * @return true if the block now holds @p new_size bytes at the same address.
+ */
+static bool mem_resize_in_place(ttak_mem_header_t *header, size_t new_size, uint64_t lifetime_ticks, uint64_t now, bool is_root) {
+#if defined(TTAK_MEM_COMPACT_HEADER)
+    if (new_size > UINT32_MAX) return false;
+#endif
+    if (new_size == 0 || new_size > SIZE_MAX - sizeof(ttak_mem_header_t) - sizeof(uint64_t)) return false;
+    if (header->is_arena || header->is_gen || header->is_root != is_root) return false;
+    if (mem_block_tracked(header, lifetime_ticks) != (header->tree_node != NULL)) return false;
+
+    uint64_t expires_tick = (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) ? (uint64_t)-1 : now + lifetime_ticks;
+    uint64_t state = atomic_load_explicit(STATE_WORD(header), memory_order_acquire);
+    if (state & TTAK_MEM_STATE_FREED) return false;
+
+    size_t canary_padding = header->strict_check ? sizeof(uint64_t) : 0;
+    size_t old_size = header->size;
+    size_t old_total = sizeof(ttak_mem_header_t) + canary_padding + old_size;
+    size_t new_total = sizeof(ttak_mem_header_t) + canary_padding + new_size;
+
+    bool fits;
+    if (header->is_huge) {
+        fits = ttak_huge_resize(header, old_total, new_total);
+    } else if (header->is_slab) {
+        fits = new_total <= ttak_slab_block_size(header);
+    } else {
+        fits = new_total <= malloc_usable_size(header);
+    }
+    if (!fits) return false;
+
+    // The expiry, size, checksum and end canary change together under the
+    // header lock, which V_HEADER takes before declaring a mismatch corrupt.
+    char *user_ptr = GET_USER_PTR(header);
+    uint64_t expiry = ttak_mem_state_encode_expiry(expires_tick);
+    pthread_mutex_lock(HEADER_LOCK(header));
+    // Only the expiry bits change; concurrent pins keep their count.
+    while (!atomic_compare_exchange_weak_explicit(STATE_WORD(header), &state,
+                                                  (state & ~TTAK_MEM_STATE_EXP_MASK) | expiry,
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+    }
+    if (new_size > old_size) {
+        memset(user_ptr + old_size, 0, new_size - old_size);
+    }
+    header->size = new_size;
+#if !defined(TTAK_MEM_COMPACT_HEADER)
+    header->expires_tick = expires_tick;
+#endif
+    header->checksum = ttak_calc_header_checksum(header);
+    if (header->strict_check) {
+        *((uint64_t *)(user_ptr + new_size)) = TTAK_CANARY_END_MAGIC;
+    }
+    pthread_mutex_unlock(HEADER_LOCK(header));
+
+    if (new_total > old_total) {
+        ttak_atomic_add64(&global_mem_usage, new_total - old_total);
+    } else {
+        ttak_atomic_sub64(&global_mem_usage, old_total - new_total);
+    }
+    if (header->tree_node) {
+        ttak_mem_tree_resize(&global_mem_tree, header->tree_node, new_size, expires_tick);
+    }
+    if (header->is_sampled) {
+        ttak_profile_record_resize(user_ptr, new_size, lifetime_ticks);
+    }
+    return true;
+}
+
 /**
  * @brief Reallocate memory while preserving metadata and strict-check flags.
  *
@@ -236,19 +489,26 @@ void TTAK_HOT_PATH *ttak_mem_alloc_safe(size_t size, uint64_t lifetime_ticks, ui
  * @return Reallocated pointer or NULL on failure.
  */
 void TTAK_HOT_PATH *ttak_mem_realloc_safe(void *ptr, size_t new_size, uint64_t lifetime_ticks, uint64_t now, _Bool is_root, ttak_mem_flags_t flags) {
-    V_HEADER(ptr);
     if (!ptr) {
         return ttak_mem_alloc_safe(new_size, lifetime_ticks, now, false, false, true, is_root, flags);
     }
+    // A block of a reclaimed generation has no header left to read.
+    if (!mem_gen_enter(ptr)) return NULL;
+    V_HEADER(ptr);
 
     ttak_mem_header_t *old_header = GET_HEADER(ptr);
-    pthread_mutex_lock(&old_header->lock);
+    if (mem_resize_in_place(old_header, new_size, lifetime_ticks, now, is_root)) {
+        mem_gen_leave(ptr);
+        return ptr;
+    }
+
+    pthread_mutex_lock(HEADER_LOCK(old_header));
     bool is_const = old_header->is_const;
     bool is_volatile = old_header->is_volatile;
     bool allow_direct = old_header->allow_direct_access;
     size_t old_size = old_header->size;
     bool old_strict_check = old_header->strict_check; // Capture old strict_check
-    pthread_mutex_unlock(&old_header->lock);
+    pthread_mutex_unlock(HEADER_LOCK(old_header));
 
     // Pass the strict_check flag to the new allocation
     ttak_mem_flags_t new_flags = flags;
@@ -259,123 +519,501 @@ void TTAK_HOT_PATH *ttak_mem_realloc_safe(void *ptr, size_t new_size, uint64_t l
     }
 
     void *new_ptr = ttak_mem_alloc_safe(new_size, lifetime_ticks, now, is_const, is_volatile, allow_direct, is_root, new_flags);
-    if (!new_ptr) return NULL;
+    if (!new_ptr) {
+        mem_gen_leave(ptr);
+        return NULL;
+    }
 
     size_t copy_size = (old_size < new_size) ? old_size : new_size;
     memcpy(new_ptr, ptr, copy_size);
 
     ttak_mem_free(ptr);
+    mem_gen_leave(ptr);
     return new_ptr;
 }
 
+/**
+ * @brief Return a block's memory to its backing allocator.
+ */
+static void mem_release_block(ttak_mem_header_t *header) {
+    size_t canary_padding = header->strict_check ? sizeof(uint64_t) : 0;
+    size_t total_alloc_size = sizeof(ttak_mem_header_t) + canary_padding + header->size;
+
+    if (header->is_arena) {
+        ttak_arena_drop_chunks((ttak_arena_t *)GET_USER_PTR(header));
+    }
+    ttak_atomic_sub64(&global_mem_usage, total_alloc_size);
+#if !defined(TTAK_MEM_COMPACT_HEADER)
+    pthread_mutex_destroy(&header->lock);
+#endif
+
+    if (header->is_gen) {
+        // The memory goes away with the whole generation.
+        ttak_gen_release(header, total_alloc_size);
+    } else if (header->is_huge) {
+        ttak_huge_free(header, total_alloc_size);
+    } else if (header->is_slab) {
+        ttak_slab_free(header);
+    } else {
+        free(header);
+    }
+}
+
+/**
+ * @brief Release every parked block whose pin count has dropped to zero.
+ */
+static void deferred_drain(void) {
+    ttak_mem_deferred_t *ready = NULL;
+
+    pthread_mutex_lock(&deferred_lock);
+    ttak_mem_deferred_t **indirect = &deferred_head;
+    while (*indirect) {
+        ttak_mem_deferred_t *entry = *indirect;
+        uint64_t state = atomic_load_explicit(STATE_WORD(entry->header), memory_order_acquire);
+        if (TTAK_MEM_STATE_PINS(state) == 0) {
+            *indirect = entry->next;
+            entry->next = ready;
+            ready = entry;
+            deferred_count--;
+        } else {
+            indirect = &entry->next;
+        }
+    }
+    pthread_mutex_unlock(&deferred_lock);
+
+    while (ready) {
+        ttak_mem_deferred_t *next = ready->next;
+        mem_release_block(ready->header);
+        free(ready);
+        ready = next;
+    }
+}
+
+/**
+ * @brief Park a freed-but-pinned block until its last reader unpins it.
+ *
+ * The pin count is re-checked after parking, so an unpin that raced with
+ * ttak_mem_free before the entry was visible cannot strand the block.
+ */
+static void deferred_park(ttak_mem_header_t *header) {
+    ttak_mem_deferred_t *entry = malloc(sizeof(ttak_mem_deferred_t));
+    if (!entry) {
+        // Leaking is the only safe option while readers may still hold the block.
+        return;
+    }
+    entry->header = header;
+
+    pthread_mutex_lock(&deferred_lock);
+    entry->next = deferred_head;
+    deferred_head = entry;
+    deferred_count++;
+    pthread_mutex_unlock(&deferred_lock);
+
+    uint64_t state = atomic_load_explicit(STATE_WORD(header), memory_order_acquire);
+    if (TTAK_MEM_STATE_PINS(state) == 0) {
+        deferred_drain();
+    }
+}
+
+/**
+ * @brief Set the freed bit of a block unless another path already did.
+ *
+ * @param state Receives the state word the freed bit was added to.
+ * @return true if the caller now owns the block.
+ */
+static bool mem_claim_block(ttak_mem_header_t *header, uint64_t *state_out) {
+    pthread_mutex_lock(HEADER_LOCK(header));
+    uint64_t state = atomic_load_explicit(STATE_WORD(header), memory_order_acquire);
+    do {
+        if (state & TTAK_MEM_STATE_FREED) {
+            pthread_mutex_unlock(HEADER_LOCK(header));
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(STATE_WORD(header), &state, state | TTAK_MEM_STATE_FREED,
+                                                    memory_order_acq_rel, memory_order_acquire));
+
+    pthread_mutex_unlock(HEADER_LOCK(header));
+    *state_out = state;
+    return true;
+}
+
+/**
+ * @brief Reclaim a claimed block whose registry node is gone, or park it while pinned.
+ *
+ * @param state State word observed by the claim.
+ */
+static void mem_retire_claimed(ttak_mem_header_t *header, uint64_t state) {
+    void *stable_ptr = GET_USER_PTR(header);
+    if (global_trace_enabled) {
+        ttak_trace_emit(TTAK_TRACE_FREE, stable_ptr, 0, 0, ttak_get_tick_count(), NULL);
+    }
+    if (header->is_sampled) {
+        ttak_profile_record_free(stable_ptr);
+    }
+
+    // Readers still hold pins: the last ttak_mem_unpin reclaims the block.
+    // Generation blocks only drop their accounting; their readers' segment
+    // pins keep the memory mapped.
+    if (TTAK_MEM_STATE_PINS(state) > 0 && !header->is_gen) {
+        deferred_park(header);
+        return;
+    }
+    mem_release_block(header);
+}
+
+/**
+ * @brief Set the freed bit of a registered block from a registry pass.
+ *
+ * Runs under the node's shard lock, so it cannot take the header lock (the
+ * locked access path nests them the other way); a single CAS on the state
+ * word decides the race with ttak_mem_free, with readers and with other
+ * passes. A linked node guarantees the block is still mapped.
+ *
+ * @param allow_pinned Whether a pinned block may be claimed (and parked).
+ * @return true if the caller now owns the block.
+ */
+static bool mem_claim_registered(ttak_mem_header_t *header, bool allow_pinned) {
+    uint64_t state = atomic_load_explicit(STATE_WORD(header), memory_order_acquire);
+    do {
+        if (state & TTAK_MEM_STATE_FREED) return false;
+        if (!allow_pinned && TTAK_MEM_STATE_PINS(state) != 0) return false;
+    } while (!atomic_compare_exchange_weak_explicit(STATE_WORD(header), &state, state | TTAK_MEM_STATE_FREED,
+                                                    memory_order_acq_rel, memory_order_acquire));
+    return true;
+}
+
+/**
+ * @brief Claim an expired, unpinned block for the registry's cleanup pass.
+ */
+_Bool ttak_mem_try_claim(void *ptr) {
+    return mem_claim_registered(GET_HEADER(ptr), false);
+}
+
+/**
+ * @brief Release a block claimed by a registry pass.
+ *
+ * Unlinks the block's node unless the pass already detached it, then
+ * releases the block, or parks it while pinned.
+ */
+void ttak_mem_reap(void *ptr) {
+    ttak_mem_header_t *header = GET_HEADER(ptr);
+    ttak_mem_node_t *node = header->tree_node;
+    if (node) {
+        header->tree_node = NULL;
+        ttak_mem_tree_remove(&global_mem_tree, node);
+    }
+    // A freed block takes no new pins, so this count can only have dropped.
+    mem_retire_claimed(header, atomic_load_explicit(STATE_WORD(header), memory_order_acquire));
+}
+
 /**
  * @brief Free tracked memory, remove it from maps, and verify canaries.
  *
+ * Blocks that are still pinned are marked freed (so no new access succeeds)
+ * and parked on the deferred-reclaim list; their memory is released by the
+ * ttak_mem_unpin that drops the last pin.
+ *
  * @param ptr Pointer returned by ttak_mem_alloc_safe.
  */
 void TTAK_HOT_PATH ttak_mem_free(void *ptr) {
     volatile void *volatile_ptr = ptr;
     if (!volatile_ptr) return;
     void *stable_ptr = (void *)volatile_ptr;
+    // A block whose generation was already reclaimed has nothing left to free.
+    if (!mem_gen_enter(stable_ptr)) return;
     V_HEADER(stable_ptr); // This will check canaries if strict_check is enabled
     ttak_mem_header_t *header = GET_HEADER(stable_ptr);
 
-    _Bool already_locked = (_Bool)in_mem_op;
-    _Bool should_release_lock = false;
-    if (header->is_root) {
-        if (!already_locked) {
-            pthread_mutex_lock(&global_map_lock);
-            in_mem_op = 1;
-            should_release_lock = true;
-        }
-        tt_map_t *map_handle = (tt_map_t *)global_ptr_map;
-        if (map_handle) {
-            ttak_delete_from_map(map_handle, (uintptr_t)stable_ptr, 0);
+    // Claim the block before touching its registry node: a cleanup pass that
+    // finds the freed bit set leaves the node linked for us, and one that set
+    // it first owns both, so we stop here.
+    uint64_t state;
+    if (mem_claim_block(header, &state)) {
+        // Unlink from the registry through the header back-pointer: O(1), and
+        // only the node's shard is locked. Untracked blocks have no node.
+        ttak_mem_node_t *node = header->tree_node;
+        if (node) {
+            header->tree_node = NULL;
+            ttak_mem_tree_remove(&global_mem_tree, node);
         }
-        // Remove from heap tree
-        ttak_mem_node_t *node_to_remove = ttak_mem_tree_find_node(&global_mem_tree, stable_ptr);
-        if (node_to_remove) {
-            ttak_mem_tree_remove(&global_mem_tree, node_to_remove);
+        mem_retire_claimed(header, state);
+    }
+    mem_gen_leave(stable_ptr);
+}
+
+/**
+ * @brief Allocate several tracked blocks with one registry splice.
+ *
+ * Every block is created first; the ones that belong in the registry are
+ * then added with ttak_mem_tree_add_batch, which locks each touched shard
+ * once per TTAK_MEM_BATCH_CHUNK blocks instead of once per block.
+ *
+ * @param out            Receives the user pointers.
+ * @param sizes          Size of each block.
+ * @param count          Number of blocks.
+ * @param lifetime_ticks Lifetime shared by every block.
+ * @param now            Current timestamp.
+ * @param flags          Allocation behavior flags shared by every block.
+ * @return true on success; on failure nothing stays allocated and @p out is cleared.
+ */
+bool ttak_mem_alloc_batch(void **out, const size_t *sizes, size_t count, uint64_t lifetime_ticks, uint64_t now, ttak_mem_flags_t flags) {
+    if (!out || (count && !sizes)) return false;
+
+    for (size_t i = 0; i < count; i++) {
+        ttak_mem_header_t *header = mem_block_create(sizes[i], lifetime_ticks, now, false, false, true, true, flags);
+        if (!header) {
+            // No block is registered yet; the regular free path still emits
+            // the trace and profile events that matched their allocation.
+            while (i > 0) {
+                ttak_mem_free(out[--i]);
+            }
+            memset(out, 0, count * sizeof(void *));
+            return false;
         }
-        if (should_release_lock) {
-            in_mem_op = 0;
-            pthread_mutex_unlock(&global_map_lock);
+        out[i] = GET_USER_PTR(header);
+    }
+
+    ensure_global_registry();
+    if (!global_init_done) return true;
+
+    uint64_t expires_tick = (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) ? (uint64_t)-1 : now + lifetime_ticks;
+    void *ptrs[TTAK_MEM_BATCH_CHUNK];
+    size_t chunk_sizes[TTAK_MEM_BATCH_CHUNK];
+    ttak_mem_node_t *nodes[TTAK_MEM_BATCH_CHUNK];
+    for (size_t base = 0; base < count; base += TTAK_MEM_BATCH_CHUNK) {
+        size_t n = count - base < TTAK_MEM_BATCH_CHUNK ? count - base : TTAK_MEM_BATCH_CHUNK;
+        size_t tracked = 0;
+        for (size_t i = 0; i < n; i++) {
+            bool track = mem_block_tracked(GET_HEADER(out[base + i]), lifetime_ticks);
+            ptrs[i] = track ? out[base + i] : NULL;
+            chunk_sizes[i] = sizes[base + i];
+            tracked += track;
         }
-    } else {
-        // Even non-root allocations participate in the mem tree.
-        ttak_mem_node_t *node_to_remove = ttak_mem_tree_find_node(&global_mem_tree, stable_ptr);
-        if (node_to_remove) {
-            ttak_mem_tree_remove(&global_mem_tree, node_to_remove);
+        if (!tracked) continue;
+        ttak_mem_tree_add_batch(&global_mem_tree, ptrs, chunk_sizes, n, expires_tick, true, nodes);
+        for (size_t i = 0; i < n; i++) {
+            if (nodes[i]) GET_HEADER(out[base + i])->tree_node = nodes[i];
         }
     }
+    return true;
+}
 
-    pthread_mutex_lock(&header->lock);
-    if (header->freed) {
-        pthread_mutex_unlock(&header->lock);
-        return;
-    }
-    header->freed = true;
-    
-    if (header->tracking_log) {
-        snprintf(header->tracking_log, 1024, "{\"event\":\"free\",\"ptr\":\"%p\",\"ts\":%lu}", stable_ptr, ttak_get_tick_count());
-        fprintf(stderr, "[MEM_TRACK] %s\n", header->tracking_log);
-        free(header->tracking_log);
-        header->tracking_log = NULL;
+/**
+ * @brief Free several tracked blocks with one registry splice.
+ *
+ * Registry nodes are unlinked with ttak_mem_tree_remove_batch, then each
+ * block follows the ttak_mem_free rules (pinned blocks are parked).
+ *
+ * @param ptrs  Blocks to free; NULL entries are skipped.
+ * @param count Number of entries.
+ */
+void ttak_mem_free_batch(void *const *ptrs, size_t count) {
+    if (!ptrs) return;
+
+    ttak_mem_node_t *nodes[TTAK_MEM_BATCH_CHUNK];
+    uint64_t states[TTAK_MEM_BATCH_CHUNK];
+    bool live[TTAK_MEM_BATCH_CHUNK];
+    for (size_t base = 0; base < count; base += TTAK_MEM_BATCH_CHUNK) {
+        size_t n = count - base < TTAK_MEM_BATCH_CHUNK ? count - base : TTAK_MEM_BATCH_CHUNK;
+        size_t tracked = 0;
+        for (size_t i = 0; i < n; i++) {
+            void *ptr = ptrs[base + i];
+            nodes[i] = NULL;
+            live[i] = ptr && mem_gen_enter(ptr);
+            if (!live[i]) continue;
+            V_HEADER(ptr);
+            ttak_mem_header_t *header = GET_HEADER(ptr);
+            if (!mem_claim_block(header, &states[i])) {
+                // Already freed, possibly by a cleanup pass that owns the node.
+                mem_gen_leave(ptr);
+                live[i] = false;
+                continue;
+            }
+            nodes[i] = header->tree_node;
+            header->tree_node = NULL;
+            tracked += (nodes[i] != NULL);
+        }
+        if (tracked) {
+            ttak_mem_tree_remove_batch(&global_mem_tree, nodes, n);
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (!live[i]) continue;
+            mem_retire_claimed(GET_HEADER(ptrs[base + i]), states[i]);
+            mem_gen_leave(ptrs[base + i]);
+        }
     }
+}
 
-    size_t canary_padding = header->strict_check ? sizeof(uint64_t) : 0;
-    size_t total_alloc_size = sizeof(ttak_mem_header_t) + canary_padding + header->size;
+/**
+ * @brief Release a pin taken by ttak_mem_access.
+ *
+ * Dropping the last pin of a block that was freed in the meantime drains
+ * the deferred-reclaim list. Saturated pin counts are sticky and never
+ * drop, so such blocks are never reclaimed.
+ *
+ * @param ptr Pointer previously returned by ttak_mem_access.
+ */
+void TTAK_HOT_PATH ttak_mem_unpin(void *ptr) {
+    if (!ptr) return;
+    V_HEADER(ptr);
+    ttak_mem_header_t *header = GET_HEADER(ptr);
 
-    // Check pin count for delayed free
-    if (ttak_atomic_read64(&header->pin_count) > 0) {
-        // In a real implementation, we would mark it for deferred cleanup.
-        // For now, we'll proceed but this is where the Pinning mechanism would act.
+    uint64_t state = atomic_load_explicit(STATE_WORD(header), memory_order_acquire);
+    uint64_t pins;
+    do {
+        pins = TTAK_MEM_STATE_PINS(state);
+        if (pins == 0 || pins == TTAK_MEM_STATE_PIN_MAX) return;
+    } while (!atomic_compare_exchange_weak_explicit(STATE_WORD(header), &state, state - TTAK_MEM_STATE_PIN_ONE,
+                                                    memory_order_acq_rel, memory_order_acquire));
+
+    if (pins == 1 && (state & TTAK_MEM_STATE_FREED)) {
+        deferred_drain();
     }
-    pthread_mutex_unlock(&header->lock);
+    mem_gen_leave(ptr);
+}
 
-    ttak_atomic_sub64(&global_mem_usage, total_alloc_size);
-    pthread_mutex_destroy(&header->lock);
+/**
+ * @brief Number of freed blocks still waiting for their readers to unpin.
+ */
+size_t ttak_mem_deferred_count(void) {
+    pthread_mutex_lock(&deferred_lock);
+    size_t count = deferred_count;
+    pthread_mutex_unlock(&deferred_lock);
+    return count;
+}
 
-    if (header->is_huge) {
-        munmap(header, total_alloc_size);
-    } else {
-        free(header);
+/**
+ * @brief Selects how ttak_mem_access validates allocations.
+ *
+ * @param mode TTAK_MEM_ACCESS_ATOMIC (default) or TTAK_MEM_ACCESS_LOCKED.
+ */
+void ttak_mem_set_access_mode(ttak_mem_access_mode_t mode) {
+    global_access_mode = (int)mode;
+}
+
+/**
+ * @brief Returns the current ttak_mem_access validation mode.
+ */
+ttak_mem_access_mode_t ttak_mem_get_access_mode(void) {
+    return (ttak_mem_access_mode_t)global_access_mode;
+}
+
+/**
+ * @brief Routes finite-lifetime allocations into lifetime generations.
+ *
+ * @param enable Non-zero to carve every eligible allocation from the
+ *               generation of its expiry bucket.
+ */
+void ttak_mem_set_generational(int enable) {
+    global_generational = enable ? 1 : 0;
+}
+
+/**
+ * @brief Returns whether generational routing is on.
+ */
+int ttak_mem_is_generational(void) {
+    return global_generational;
+}
+
+/**
+ * @brief Validate the state word and take one pin.
+ *
+ * A single acquire load followed by a CAS; the pin field saturates instead of
+ * overflowing into the freed bit, after which pins are sticky and the CAS is
+ * skipped.
+ *
+ * @return true if the block is live and unexpired at @p now.
+ */
+static inline _Bool state_try_pin(ttak_mem_header_t *header, uint64_t now) {
+    uint64_t state = atomic_load_explicit(STATE_WORD(header), memory_order_acquire);
+    for (;;) {
+        if (state & TTAK_MEM_STATE_FREED) return false;
+        uint64_t expiry = TTAK_MEM_STATE_EXPIRY(state);
+        if (expiry != TTAK_MEM_STATE_EXP_MASK && now > expiry) return false;
+        if (TTAK_MEM_STATE_PINS(state) == TTAK_MEM_STATE_PIN_MAX) return true;
+        if (atomic_compare_exchange_weak_explicit(STATE_WORD(header), &state, state + TTAK_MEM_STATE_PIN_ONE,
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Bump the access audit counter and surface the block once it crosses the limit.
+ */
+static inline void access_audit(ttak_mem_header_t *header) {
+#if defined(TTAK_MEM_COMPACT_HEADER)
+    // The 16-bit counter sticks at its maximum instead of wrapping back under the limit.
+    _Atomic uint16_t *counter = (_Atomic uint16_t *)&header->access_count;
+    uint16_t seen = atomic_load_explicit(counter, memory_order_relaxed);
+    do {
+        if (seen == UINT16_MAX) return;
+    } while (!atomic_compare_exchange_weak_explicit(counter, &seen, (uint16_t)(seen + 1),
+                                                    memory_order_relaxed, memory_order_relaxed));
+    uint64_t count = (uint64_t)seen + 1;
+#else
+    uint64_t count = atomic_fetch_add_explicit((_Atomic uint64_t *)&header->access_count, 1, memory_order_relaxed) + 1;
+#endif
+    if (count == TTAK_MEM_DIRTY_ACCESS_LIMIT + 1 && header->tree_node) {
+        // Crossed the audit limit: surface it to the dirty scan without waiting for expiry.
+        ttak_mem_tree_mark_due(&global_mem_tree, header->tree_node);
     }
 }
 
 /**
  * @brief Validate an allocation and obtain a pinned pointer for direct access.
  *
+ * Every successful call takes one pin, which must be released with
+ * ttak_mem_unpin. A pinned block stays mapped even if ttak_mem_free runs
+ * concurrently.
+ *
+ * In TTAK_MEM_ACCESS_ATOMIC mode no lock is taken:
+ * freed, expiry and pin state are checked and updated through the header's
+ * packed state word.
+ *
  * @param ptr Pointer to validate.
  * @param now Current timestamp for expiry checks.
  * @return Original pointer if access is permitted, SAFE_NULL otherwise.
  */
 void TTAK_HOT_PATH *ttak_mem_access(void *ptr, uint64_t now) {
     if (!ptr) return SAFE_NULL;
+    // Generation blocks hold a segment pin alongside the header pin.
+    if (!mem_gen_enter(ptr)) return SAFE_NULL;
     V_HEADER(ptr);
     ttak_mem_header_t *header = GET_HEADER(ptr);
 
-    pthread_mutex_lock(&header->lock);
-    if (header->freed || (header->expires_tick != (uint64_t)-1 && now > header->expires_tick)) {
-        pthread_mutex_unlock(&header->lock);
+    if (!header->allow_direct_access) {
+        mem_gen_leave(ptr);
         return SAFE_NULL;
     }
-    if (!header->allow_direct_access) {
-        pthread_mutex_unlock(&header->lock);
+
+    if (global_access_mode == TTAK_MEM_ACCESS_ATOMIC) {
+        if (!state_try_pin(header, now)) {
+            mem_gen_leave(ptr);
+            return SAFE_NULL;
+        }
+        access_audit(header);
+        if (global_trace_enabled) {
+            ttak_trace_emit(TTAK_TRACE_ACCESS, ptr, HEADER_ACCESS_COUNT(header), 0, now, NULL);
+        }
+        return ptr;
+    }
+
+    pthread_mutex_lock(HEADER_LOCK(header));
+    if (!state_try_pin(header, now)) {
+        pthread_mutex_unlock(HEADER_LOCK(header));
+        mem_gen_leave(ptr);
         return SAFE_NULL;
     }
 
-    // Safe access auditing and pinning inside the lock
-    ttak_atomic_inc64(&header->access_count);
-    ttak_atomic_inc64(&header->pin_count);
+    // Safe access auditing inside the lock
+    access_audit(header);
 
-    if (header->tracking_log) {
-        snprintf(header->tracking_log, 1024, "{\"event\":\"access\",\"ptr\":\"%p\",\"count\":%lu,\"ts\":%lu}", 
-                 ptr, ttak_atomic_read64(&header->access_count), now);
-        fprintf(stderr, "[MEM_TRACK] %s\n", header->tracking_log);
+    if (global_trace_enabled) {
+        ttak_trace_emit(TTAK_TRACE_ACCESS, ptr, HEADER_ACCESS_COUNT(header), 0, now, NULL);
     }
 
-    pthread_mutex_unlock(&header->lock);
+    pthread_mutex_unlock(HEADER_LOCK(header));
 
     return ptr;
 }
@@ -384,65 +1022,263 @@ void TTAK_HOT_PATH *ttak_mem_access(void *ptr, uint64_t now) {
  * @brief Configures the global background GC (mem_tree) parameters.
  */
 void ttak_mem_configure_gc(uint64_t min_interval_ns, uint64_t max_interval_ns, size_t pressure_threshold) {
-    uint64_t now = ttak_get_tick_count();
-    ensure_global_map(now);
+    ensure_global_registry();
     ttak_mem_tree_set_cleaning_intervals(&global_mem_tree, min_interval_ns, max_interval_ns);
     ttak_mem_tree_set_pressure_threshold(&global_mem_tree, pressure_threshold);
 }
 
+/**
+ * @brief Accumulator for tt_inspect_dirty_pointers.
+ */
+typedef struct {
+    uint64_t now;
+    void   **items;
+    size_t   count;
+    size_t   cap;
+    _Bool    failed;
+    _Bool    claim;     /**< Claim each block for freeing */
+} ttak_dirty_scan_t;
+
+/**
+ * @brief Whether a registered node is a root that expired or crossed the access limit.
+ */
+static inline bool dirty_node(const ttak_mem_node_t *node, uint64_t now) {
+    if (!node->is_root) return false;
+    ttak_mem_header_t *h = GET_HEADER(node->ptr);
+    return (node->expires_tick != (uint64_t)-1 && now > node->expires_tick) ||
+           HEADER_ACCESS_COUNT(h) > TTAK_MEM_DIRTY_ACCESS_LIMIT;
+}
+
+/**
+ * @brief Collect a registered root if it is expired or over-accessed.
+ */
+static void dirty_scan_visit(ttak_mem_node_t *node, void *arg) {
+    ttak_dirty_scan_t *scan = (ttak_dirty_scan_t *)arg;
+    if (scan->failed || !dirty_node(node, scan->now)) return;
+    if (scan->count == scan->cap) {
+        size_t new_cap = scan->cap ? scan->cap * 2 : 64;
+        void **grown = realloc(scan->items, new_cap * sizeof(void *));
+        if (!grown) {
+            scan->failed = true;
+            return;
+        }
+        scan->items = grown;
+        scan->cap = new_cap;
+    }
+    if (scan->claim && !mem_claim_registered(GET_HEADER(node->ptr), true)) return;
+    scan->items[scan->count++] = node->ptr;
+}
+
+/**
+ * @brief Collect the dirty roots, optionally claiming each one.
+ *
+ * A claimed block is marked freed under its shard lock; the caller must
+ * pass it to ttak_mem_reap. If growing the array fails midway, the blocks
+ * claimed so far are reaped before NULL is returned.
+ */
+static void **dirty_scan(uint64_t now, bool claim, size_t *count_out) {
+    if (!count_out || !global_init_done) return NULL;
+    *count_out = 0;
+
+    ttak_dirty_scan_t scan = { .now = now, .claim = claim };
+    // Only allocations whose expiry timer fired (or that crossed the access
+    // limit) are on the due lists, so the scan never walks the live heap.
+    ttak_mem_tree_for_each_due(&global_mem_tree, now, dirty_scan_visit, &scan);
+    if (scan.failed) {
+        for (size_t i = 0; claim && i < scan.count; i++) {
+            ttak_mem_reap(scan.items[i]);
+        }
+        free(scan.items);
+        return NULL;
+    }
+    if (!scan.items) {
+        // Keep the "empty array, count 0" contract of the map-based scan.
+        scan.items = malloc(sizeof(void *));
+        if (!scan.items) return NULL;
+    }
+    *count_out = scan.count;
+    return scan.items;
+}
+
+/**
+ * @brief Return a snapshot of allocations considered "dirty".
+ *
+ * Caller owns the returned array.
+ *
+ * @param now       Current timestamp.
+ * @param count_out Number of pointers returned.
+ * @return Array of pointers or NULL if inspection fails.
+ */
+void TTAK_COLD_PATH **tt_inspect_dirty_pointers(uint64_t now, size_t *count_out) {
+    return dirty_scan(now, false, count_out);
+}
+
 /**
  * @brief Sweep and free expired or highly accessed allocations.
  *
  * @param now Current timestamp for expiration checks.
  */
 void TTAK_COLD_PATH tt_autoclean_dirty_pointers(uint64_t now) {
+    mem_gen_reclaim(now);
     size_t count = 0;
-    void **dirty = tt_inspect_dirty_pointers(now, &count);
+    // The scan claims each block under its shard lock, so the cleanup thread
+    // or a concurrent sweep cannot free it before we do.
+    void **dirty = dirty_scan(now, true, &count);
     if (!dirty) return;
     register int hot_slot = 0;
     for (size_t i = 0; i < count; i++) {
         hot_slot = (int)i;
         volatile void *volatile_target = dirty[i];
-        ttak_mem_free((void *)volatile_target);
+        ttak_mem_reap((void *)volatile_target);
     }
     free(dirty);
 }
 
 /**
- * @brief Return a snapshot of allocations considered "dirty".
+ * @brief Fixed-capacity accumulator for one tt_sweep_dirty_pointers slice.
+ */
+typedef struct {
+    uint64_t now;
+    size_t   count;
+    void    *items[TTAK_MEM_SWEEP_SLICE];
+} ttak_dirty_slice_t;
+
+static void dirty_slice_visit(ttak_mem_node_t *node, void *arg) {
+    ttak_dirty_slice_t *slice = (ttak_dirty_slice_t *)arg;
+    if (dirty_node(node, slice->now) && mem_claim_registered(GET_HEADER(node->ptr), true)) {
+        slice->items[slice->count++] = node->ptr;
+    }
+}
+
+/**
+ * @brief Free dirty roots incrementally, resuming where the last call stopped.
  *
- * Caller owns the returned array.
+ * The sweep walks one shard slice of at most TTAK_MEM_SWEEP_SLICE due nodes
+ * at a time, frees the dirty roots of that slice outside the shard lock, and
+ * stops when either budget is spent or every shard has been visited once.
  *
+ * @param cursor    Sweep position (zero-initialize before the first call).
  * @param now       Current timestamp.
- * @param count_out Number of pointers returned.
- * @return Array of pointers or NULL if inspection fails.
+ * @param max_nodes Due nodes to examine at most (0 for no limit).
+ * @param max_ns    Wall-clock budget in nanoseconds (0 for no limit).
+ * @return Number of allocations freed.
  */
-void TTAK_COLD_PATH **tt_inspect_dirty_pointers(uint64_t now, size_t *count_out) {
-    tt_map_t *map_handle = (tt_map_t *)global_ptr_map;
-    if (!count_out || !map_handle) return NULL;
-    *count_out = 0;
+size_t TTAK_COLD_PATH tt_sweep_dirty_pointers(ttak_mem_sweep_cursor_t *cursor, uint64_t now, size_t max_nodes, uint64_t max_ns) {
+    if (!cursor) return 0;
+    mem_gen_reclaim(now);
+    if (!global_init_done) return 0;
 
-    pthread_mutex_lock(&global_map_lock);
-    size_t cap = map_handle->cap;
-    void **dirty = malloc(sizeof(void *) * map_handle->size);
-    if (!dirty) {
-        pthread_mutex_unlock(&global_map_lock);
-        return NULL;
+    uint64_t deadline = max_ns ? ttak_get_tick_count_ns() + max_ns : 0;
+    size_t budget = max_nodes ? max_nodes : SIZE_MAX;
+    size_t freed = 0;
+    // One extra step lets a sweep that starts mid-shard finish the round.
+    unsigned shard_steps = TTAK_MEM_TREE_SHARDS + (cursor->offset != 0);
+
+    while (budget > 0 && shard_steps > 0) {
+        ttak_dirty_slice_t slice = { .now = now };
+        uint32_t shard = cursor->shard;
+        size_t limit = budget < TTAK_MEM_SWEEP_SLICE ? budget : TTAK_MEM_SWEEP_SLICE;
+        size_t visited = ttak_mem_tree_sweep_due(&global_mem_tree, cursor, now, limit, dirty_slice_visit, &slice);
+        budget -= visited;
+
+        for (size_t i = 0; i < slice.count; i++) {
+            ttak_mem_reap(slice.items[i]);
+        }
+        freed += slice.count;
+        // Freed nodes left the shard's lists, so the resume offset shrinks with them.
+        if (cursor->shard == shard) {
+            cursor->offset = cursor->offset > slice.count ? cursor->offset - slice.count : 0;
+        } else {
+            shard_steps--;
+        }
+
+        if (deadline && ttak_get_tick_count_ns() >= deadline) break;
     }
-    size_t found = 0;
-    for (size_t i = 0; i < cap; i++) {
-        if (map_handle->tbl[i].ctrl == OCCUPIED) {
-            void *user_ptr = (void *)map_handle->tbl[i].key;
-            ttak_mem_header_t *h = (ttak_mem_header_t *)map_handle->tbl[i].value;
-            if ((h->expires_tick != (uint64_t)-1 && now > h->expires_tick) ||
-                ttak_atomic_read64(&h->access_count) > 1000000) {
-                dirty[found++] = user_ptr;
-            }
+    return freed;
+}
+
+/**
+ * @brief Budgeted background sweeper shared by every ttak_mem_sweeper_start caller.
+ */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t thread;
+    size_t users;
+    bool stop;
+    uint64_t interval_ns;
+    size_t max_nodes;
+    uint64_t max_ns;
+} mem_sweeper = { .lock = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER };
+
+static void *mem_sweeper_func(void *arg) {
+    (void)arg;
+    ttak_mem_sweep_cursor_t cursor = {0};
+
+    pthread_mutex_lock(&mem_sweeper.lock);
+    while (!mem_sweeper.stop) {
+        size_t max_nodes = mem_sweeper.max_nodes;
+        uint64_t max_ns = mem_sweeper.max_ns;
+        pthread_mutex_unlock(&mem_sweeper.lock);
+
+        tt_sweep_dirty_pointers(&cursor, ttak_get_tick_count(), max_nodes, max_ns);
+
+        pthread_mutex_lock(&mem_sweeper.lock);
+        if (mem_sweeper.stop) break;
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        uint64_t wake = (uint64_t)ts.tv_nsec + mem_sweeper.interval_ns;
+        ts.tv_sec += (time_t)(wake / 1000000000ULL);
+        ts.tv_nsec = (long)(wake % 1000000000ULL);
+        pthread_cond_timedwait(&mem_sweeper.cond, &mem_sweeper.lock, &ts);
+    }
+    pthread_mutex_unlock(&mem_sweeper.lock);
+    return NULL;
+}
+
+/**
+ * @brief Starts (or joins) the background dirty-pointer sweeper.
+ *
+ * The first caller launches the thread; later callers only update the
+ * budget. Every successful call must be paired with ttak_mem_sweeper_stop.
+ *
+ * @param interval_ns Pause between sweep steps.
+ * @param max_nodes   Due nodes examined per step (0 for no limit).
+ * @param max_ns      Time budget per step (0 for no limit).
+ * @return true if the sweeper is running.
+ */
+bool ttak_mem_sweeper_start(uint64_t interval_ns, size_t max_nodes, uint64_t max_ns) {
+    ensure_global_registry();
+    pthread_mutex_lock(&mem_sweeper.lock);
+    mem_sweeper.interval_ns = interval_ns ? interval_ns : TTAK_MEM_SWEEP_INTERVAL_NS;
+    mem_sweeper.max_nodes = max_nodes;
+    mem_sweeper.max_ns = max_ns;
+    if (mem_sweeper.users == 0) {
+        mem_sweeper.stop = false;
+        if (pthread_create(&mem_sweeper.thread, NULL, mem_sweeper_func, NULL) != 0) {
+            pthread_mutex_unlock(&mem_sweeper.lock);
+            return false;
         }
     }
-    pthread_mutex_unlock(&global_map_lock);
-    *count_out = found;
-    return dirty;
+    mem_sweeper.users++;
+    pthread_mutex_unlock(&mem_sweeper.lock);
+    return true;
+}
+
+/**
+ * @brief Drops one ttak_mem_sweeper_start reference; the last one joins the thread.
+ */
+void ttak_mem_sweeper_stop(void) {
+    pthread_mutex_lock(&mem_sweeper.lock);
+    if (mem_sweeper.users == 0 || --mem_sweeper.users > 0) {
+        pthread_mutex_unlock(&mem_sweeper.lock);
+        return;
+    }
+    mem_sweeper.stop = true;
+    pthread_cond_signal(&mem_sweeper.cond);
+    pthread_t thread = mem_sweeper.thread;
+    pthread_mutex_unlock(&mem_sweeper.lock);
+    pthread_join(thread, NULL);
 }
 
 /**
@@ -464,39 +1300,3 @@ _Bool ttak_mem_is_pressure_high(void) {
     return ttak_atomic_read64(&global_mem_usage) > TTAK_MEM_HIGH_WATERMARK;
 }
 
-/**
- * @brief Atomic WAL pattern for secure state persistence.
- */
-void save_current_progress(const char *filename, const void *data, size_t size) {
-    char temp_name[256];
-    snprintf(temp_name, sizeof(temp_name), "%s.tmp", filename);
-
-    int fd = open(temp_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-    if (fd < 0) return;
-
-    if (write(fd, data, size) != (ssize_t)size) {
-        close(fd);
-        unlink(temp_name);
-        return;
-    }
-
-    if (fsync(fd) != 0) {
-        close(fd);
-        unlink(temp_name);
-        return;
-    }
-
-    close(fd);
-
-    if (rename(temp_name, filename) != 0) {
-        unlink(temp_name);
-        return;
-    }
-
-    // Sync parent directory
-    int dfd = open(".", O_RDONLY | O_DIRECTORY);
-    if (dfd >= 0) {
-        fsync(dfd);
-        close(dfd);
-    }
-}
@@ -1,18 +1,21 @@
 #include <ttak/mem/owner.h>
 #include <ttak/ht/hash.h>
 #include <ttak/mem/mem.h>
+#include <ttak/mem/trace.h>
 #include <ttak/timing/timing.h>
+#include "../../internal/app_types.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
 
 /**
  * @brief Hashing helper for string keys.
+ *
+ * DJB2 only picks the slot chain; names are always compared in full, so
+ * colliding names get distinct handles.
  */
 static inline uintptr_t _hash_str(const char *str) {
-    // Simple wrapper assuming string keys are cast to uintptr_t or hashed
-    // For this implementation, we use a basic DJB2-like hash or cast if the map supports it.
-    // Assuming ttak_map handles uintptr_t keys. We hash the string to uintptr_t.
     uintptr_t hash = 5381;
     int c;
     while ((c = *str++))
@@ -20,15 +23,121 @@ static inline uintptr_t _hash_str(const char *str) {
     return hash;
 }
 
-ttak_owner_t *ttak_owner_create(uint32_t policy) {
+/**
+ * @brief Returns the slot of a handle, or NULL if it is out of range. Lock-free.
+ */
+static inline ttak_owner_slot_t *table_slot(ttak_owner_table_t *table, ttak_owner_handle_t handle) {
+    uint32_t count = atomic_load_explicit(&table->count, memory_order_acquire);
+    if (handle == TTAK_OWNER_INVALID_HANDLE || handle > count) return NULL;
+    uint32_t index = handle - 1;
+    ttak_owner_slot_t *chunk = atomic_load_explicit(&table->chunks[index / TTAK_OWNER_CHUNK_SLOTS],
+                                                    memory_order_acquire);
+    return &chunk[index % TTAK_OWNER_CHUNK_SLOTS];
+}
+
+/**
+ * @brief Finds the handle of @p name. Called with the owner lock held.
+ *
+ * The index maps a name hash to the newest handle with that hash; slots with
+ * colliding hashes are chained and told apart by comparing the names.
+ */
+static ttak_owner_handle_t table_find(ttak_owner_table_t *table, const char *name) {
+    size_t head = 0;
+    if (!table->index || !ttak_map_get_key(table->index, _hash_str(name), &head, ttak_get_tick_count())) {
+        return TTAK_OWNER_INVALID_HANDLE;
+    }
+    for (ttak_owner_handle_t h = (ttak_owner_handle_t)head; h != TTAK_OWNER_INVALID_HANDLE;) {
+        ttak_owner_slot_t *slot = table_slot(table, h);
+        if (!slot) break;
+        if (strcmp(slot->name, name) == 0) return h;
+        h = slot->next;
+    }
+    return TTAK_OWNER_INVALID_HANDLE;
+}
+
+/**
+ * @brief Bumps the owner's arena; safe from any thread.
+ */
+static void *owner_arena_alloc(ttak_owner_t *owner, size_t size) {
+    ttak_mutex_lock(&owner->arena_lock);
+    void *ptr = ttak_arena_alloc(owner->arena, size);
+    ttak_mutex_unlock(&owner->arena_lock);
+    return ptr;
+}
+
+/**
+ * @brief Finds or appends the slot for @p name. Called with the owner write lock held.
+ */
+static ttak_owner_handle_t table_intern(ttak_owner_t *owner, ttak_owner_table_t *table, const char *name) {
+    ttak_owner_handle_t found = table_find(table, name);
+    if (found != TTAK_OWNER_INVALID_HANDLE || !table->index) return found;
+
+    uint32_t index = atomic_load_explicit(&table->count, memory_order_relaxed);
+    uint32_t chunk_idx = index / TTAK_OWNER_CHUNK_SLOTS;
+    if (chunk_idx >= TTAK_OWNER_MAX_CHUNKS) return TTAK_OWNER_INVALID_HANDLE;
+
+    ttak_owner_slot_t *chunk = atomic_load_explicit(&table->chunks[chunk_idx], memory_order_relaxed);
+    if (!chunk) {
+        chunk = owner_arena_alloc(owner, TTAK_OWNER_CHUNK_SLOTS * sizeof(*chunk));
+        if (!chunk) return TTAK_OWNER_INVALID_HANDLE;
+        atomic_store_explicit(&table->chunks[chunk_idx], chunk, memory_order_release);
+    }
+
+    ttak_owner_slot_t *slot = &chunk[index % TTAK_OWNER_CHUNK_SLOTS];
+    size_t name_len = strlen(name) + 1;
+    slot->name = owner_arena_alloc(owner, name_len);
+    if (!slot->name) return TTAK_OWNER_INVALID_HANDLE;
+    memcpy(slot->name, name, name_len);
+
+    uintptr_t key = _hash_str(name);
+    size_t head = 0;
+    uint64_t now = ttak_get_tick_count();
+    slot->next = ttak_map_get_key(table->index, key, &head, now) ? (ttak_owner_handle_t)head
+                                                                 : TTAK_OWNER_INVALID_HANDLE;
+    ttak_owner_handle_t handle = index + 1;
+    atomic_store_explicit(&table->count, handle, memory_order_release);
+    ttak_insert_to_map(table->index, key, handle, now);
+    return handle;
+}
+
+static void table_init(ttak_owner_table_t *table, uint64_t now) {
+    table->index = ttak_create_map(32, now);
+    for (int i = 0; i < TTAK_OWNER_MAX_CHUNKS; i++) {
+        atomic_init(&table->chunks[i], NULL);
+    }
+    atomic_init(&table->count, 0);
+}
+
+static void table_destroy(ttak_owner_table_t *table) {
+    // Names and slot chunks live in the owner's arena; only the index is separate.
+    ttak_destroy_map(table->index);
+    table->index = NULL;
+}
+
+/**
+ * @brief Destructor hook of adopted child owners.
+ */
+static void owner_dtor(void *data) {
+    ttak_owner_destroy((ttak_owner_t *)data);
+}
+
+ttak_owner_t *ttak_owner_create_sized(uint32_t policy, size_t arena_chunk) {
     ttak_owner_t *owner = malloc(sizeof(ttak_owner_t));
     if (!owner) return NULL;
 
     uint64_t now = ttak_get_tick_count();
+    if (arena_chunk == 0) arena_chunk = TTAK_OWNER_DEFAULT_ARENA_CHUNK;
+    owner->arena = ttak_arena_create(arena_chunk, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    if (!owner->arena) {
+        free(owner);
+        return NULL;
+    }
+    ttak_mutex_init(&owner->arena_lock);
+    owner->dtor_count = 0;
     
-    // Initialize resource and function maps
-    owner->resources = ttak_create_map(32, now);
-    owner->functions = ttak_create_map(32, now);
+    // Initialize resource and function tables
+    table_init(&owner->resources, now);
+    table_init(&owner->functions, now);
     
     ttak_rwlock_init(&owner->lock);
     owner->creation_ts = now;
@@ -37,17 +146,31 @@ ttak_owner_t *ttak_owner_create(uint32_t policy) {
     return owner;
 }
 
+ttak_owner_t *ttak_owner_create(uint32_t policy) {
+    return ttak_owner_create_sized(policy, 0);
+}
+
 void ttak_owner_destroy(ttak_owner_t *owner) {
     if (!owner) return;
 
+    // Hooks run without the lock so that they may destroy adopted child owners.
+    if (owner->dtor_count) {
+        for (uint32_t h = atomic_load(&owner->resources.count); h > 0; h--) {
+            ttak_owner_slot_t *slot = table_slot(&owner->resources, h);
+            if (slot->dtor && atomic_load_explicit(&slot->live, memory_order_acquire)) {
+                slot->dtor((void *)atomic_load_explicit(&slot->value, memory_order_relaxed));
+            }
+        }
+    }
+
     ttak_rwlock_wrlock(&owner->lock);
-    
-    // Note: We do not deep-free resources here as we don't know their destructors.
-    // In a full system, we might need a resource wrapper with a dtor.
-    // ttak_map_destroy(owner->resources); // Assuming generic map destroy exists or we just leak for this snippet
-    // ttak_map_destroy(owner->functions);
-    
+    table_destroy(&owner->resources);
+    table_destroy(&owner->functions);
     ttak_rwlock_unlock(&owner->lock);
+
+    // Every name, slot table and ttak_owner_alloc block goes with the arena.
+    ttak_arena_release(owner->arena);
+    ttak_mutex_destroy(&owner->arena_lock);
     ttak_rwlock_destroy(&owner->lock);
     free(owner);
 }
@@ -56,94 +179,178 @@ bool ttak_owner_register_func(ttak_owner_t *owner, const char *name, ttak_owner_
     if (!owner || !name || !func) return false;
 
     ttak_rwlock_wrlock(&owner->lock);
-    uintptr_t key = _hash_str(name);
     
-    // Check if strict policy prevents overwriting (simplified: just insert)
-    ttak_insert_to_map(owner->functions, key, (size_t)func, ttak_get_tick_count());
+    // Check if strict policy prevents overwriting (simplified: re-registering replaces the function)
+    ttak_owner_handle_t handle = table_intern(owner, &owner->functions, name);
+    ttak_owner_slot_t *slot = table_slot(&owner->functions, handle);
+    if (slot) {
+        atomic_store_explicit(&slot->value, (uintptr_t)func, memory_order_relaxed);
+        atomic_store_explicit(&slot->live, true, memory_order_release);
+    }
     
     ttak_rwlock_unlock(&owner->lock);
-    return true;
+    return slot != NULL;
 }
 
-bool ttak_owner_register_resource(ttak_owner_t *owner, const char *name, void *data) {
-    if (!owner || !name) return false;
+/**
+ * @brief Stores a resource in its slot. Called with the owner write lock held.
+ */
+static void slot_publish(ttak_owner_t *owner, ttak_owner_slot_t *slot, uintptr_t data,
+                         ttak_owner_dtor_t dtor, size_t arena_size) {
+    if (slot->dtor && atomic_load_explicit(&slot->live, memory_order_relaxed)) owner->dtor_count--;
+    if (dtor) owner->dtor_count++;
+    slot->dtor = dtor;
+    slot->arena_size = arena_size;
+    atomic_store_explicit(&slot->value, data, memory_order_relaxed);
+    atomic_store_explicit(&slot->live, true, memory_order_release);
+}
+
+/**
+ * @brief Clears a resource slot. Called with the owner write lock held.
+ */
+static void slot_retract(ttak_owner_t *owner, ttak_owner_slot_t *slot) {
+    if (slot->dtor) owner->dtor_count--;
+    slot->dtor = NULL;
+    atomic_store_explicit(&slot->live, false, memory_order_release);
+}
 
+static bool register_resource(ttak_owner_t *owner, const char *name, void *data,
+                              ttak_owner_dtor_t dtor, size_t arena_size) {
     ttak_rwlock_wrlock(&owner->lock);
-    uintptr_t key = _hash_str(name);
-    
-    ttak_insert_to_map(owner->resources, key, (size_t)data, ttak_get_tick_count());
+    ttak_owner_slot_t *slot = table_slot(&owner->resources, table_intern(owner, &owner->resources, name));
+    if (!slot) {
+        ttak_rwlock_unlock(&owner->lock);
+        return false;
+    }
+    slot_publish(owner, slot, (uintptr_t)data, dtor, arena_size);
     
     if (ttak_mem_is_trace_enabled()) {
-        fprintf(stderr, "[MEM_TRACK] {\"event\":\"register\",\"ptr\":\"%p\",\"owner\":\"%p\",\"name\":\"%s\",\"ts\":%lu}\n", 
-                data, (void*)owner, name, ttak_get_tick_count());
+        ttak_trace_emit(TTAK_TRACE_REGISTER, data, (uint64_t)(uintptr_t)owner, 0, ttak_get_tick_count(), name);
     }
 
     ttak_rwlock_unlock(&owner->lock);
     return true;
 }
 
+bool ttak_owner_register_resource(ttak_owner_t *owner, const char *name, void *data) {
+    if (!owner || !name) return false;
+    return register_resource(owner, name, data, NULL, 0);
+}
+
+bool ttak_owner_register_resource_dtor(ttak_owner_t *owner, const char *name, void *data, ttak_owner_dtor_t dtor) {
+    if (!owner || !name) return false;
+    return register_resource(owner, name, data, dtor, 0);
+}
+
+void *ttak_owner_alloc(ttak_owner_t *owner, size_t size) {
+    if (!owner || size == 0) return NULL;
+    return owner_arena_alloc(owner, size);
+}
+
+void *ttak_owner_alloc_resource(ttak_owner_t *owner, const char *name, size_t size, ttak_owner_dtor_t dtor) {
+    if (!owner || !name || size == 0) return NULL;
+    void *data = owner_arena_alloc(owner, size);
+    if (!data || !register_resource(owner, name, data, dtor, size)) return NULL;
+    return data;
+}
+
+bool ttak_owner_adopt(ttak_owner_t *parent, const char *name, ttak_owner_t *child) {
+    if (!parent || !name || !child || parent == child) return false;
+    return register_resource(parent, name, child, owner_dtor, 0);
+}
+
 bool ttak_owner_transfer_resource(ttak_owner_t *from, ttak_owner_t *to, const char *name) {
     if (!from || !to || !name) return false;
-
-    uintptr_t key = _hash_str(name);
-    size_t data_val = 0;
+    if (from == to) return ttak_owner_resolve_resource(from, name) != TTAK_OWNER_INVALID_HANDLE;
 
     ttak_rwlock_wrlock(&from->lock);
-    if (!ttak_map_get_key(from->resources, key, &data_val, ttak_get_tick_count())) {
+    ttak_owner_slot_t *src = table_slot(&from->resources, table_find(&from->resources, name));
+    // Arena memory cannot change hands, and a copy would leave every pointer
+    // into the object dangling once the source owner is destroyed.
+    if (!src || !atomic_load_explicit(&src->live, memory_order_relaxed) || src->arena_size) {
         ttak_rwlock_unlock(&from->lock);
         return false;
     }
-    ttak_delete_from_map(from->resources, key, 0);
+    uintptr_t data_val = atomic_load_explicit(&src->value, memory_order_relaxed);
+    ttak_owner_dtor_t dtor = src->dtor;
+    slot_retract(from, src);
     ttak_rwlock_unlock(&from->lock);
 
     ttak_rwlock_wrlock(&to->lock);
-    ttak_insert_to_map(to->resources, key, data_val, ttak_get_tick_count());
-    
-    if (ttak_mem_is_trace_enabled()) {
-        fprintf(stderr, "[MEM_TRACK] {\"event\":\"transfer\",\"ptr\":\"%p\",\"from\":\"%p\",\"to\":\"%p\",\"name\":\"%s\",\"ts\":%lu}\n", 
-                (void*)data_val, (void*)from, (void*)to, name, ttak_get_tick_count());
+    ttak_owner_slot_t *dst = table_slot(&to->resources, table_intern(to, &to->resources, name));
+    if (dst) {
+        slot_publish(to, dst, data_val, dtor, 0);
+        if (ttak_mem_is_trace_enabled()) {
+            ttak_trace_emit(TTAK_TRACE_TRANSFER, (void *)data_val, (uint64_t)(uintptr_t)from, (uint64_t)(uintptr_t)to,
+                            ttak_get_tick_count(), name);
+        }
     }
-
     ttak_rwlock_unlock(&to->lock);
+
+    if (!dst) {
+        // The destination is full; hand the resource back.
+        ttak_rwlock_wrlock(&from->lock);
+        slot_publish(from, src, data_val, dtor, 0);
+        ttak_rwlock_unlock(&from->lock);
+        return false;
+    }
     return true;
 }
 
-bool ttak_owner_execute(ttak_owner_t *owner, const char *func_name, const char *resource_name, void *args) {
-    if (!owner || !func_name) return false;
+ttak_owner_handle_t ttak_owner_resolve_func(ttak_owner_t *owner, const char *name) {
+    if (!owner || !name) return TTAK_OWNER_INVALID_HANDLE;
+    ttak_rwlock_rdlock(&owner->lock);
+    ttak_owner_handle_t handle = table_find(&owner->functions, name);
+    ttak_rwlock_unlock(&owner->lock);
+    return handle;
+}
 
+ttak_owner_handle_t ttak_owner_resolve_resource(ttak_owner_t *owner, const char *name) {
+    if (!owner || !name) return TTAK_OWNER_INVALID_HANDLE;
     ttak_rwlock_rdlock(&owner->lock);
+    ttak_owner_handle_t handle = table_find(&owner->resources, name);
+    ttak_rwlock_unlock(&owner->lock);
+    return handle;
+}
 
-    // 1. Safety Check: Verify policy
-    // If strict isolation is on, ensure we aren't passing "args" from outside that violates it?
-    // For this prototype, we just proceed.
-    
-    uintptr_t func_key = _hash_str(func_name);
-    size_t func_ptr_val = 0;
-    
-    // 2. Retrieve Function
-    if (!ttak_map_get_key(owner->functions, func_key, &func_ptr_val, ttak_get_tick_count())) {
-        ttak_rwlock_unlock(&owner->lock);
-        return false; // Function not found
-    }
+bool TTAK_HOT_PATH ttak_owner_execute_handle(ttak_owner_t *owner, ttak_owner_handle_t func,
+                                             ttak_owner_handle_t resource, void *args) {
+    if (!owner) return false;
+
+    ttak_owner_slot_t *fslot = table_slot(&owner->functions, func);
+    if (!fslot || !atomic_load_explicit(&fslot->live, memory_order_acquire)) return false;
+    ttak_owner_func_t fn = (ttak_owner_func_t)atomic_load_explicit(&fslot->value, memory_order_relaxed);
 
-    // 3. Retrieve Context Resource (if specified)
     void *ctx = NULL;
-    if (resource_name) {
-        uintptr_t res_key = _hash_str(resource_name);
-        size_t res_ptr_val = 0;
-        if (ttak_map_get_key(owner->resources, res_key, &res_ptr_val, ttak_get_tick_count())) {
-            ctx = (void *)res_ptr_val;
+    if (resource != TTAK_OWNER_INVALID_HANDLE) {
+        ttak_owner_slot_t *rslot = table_slot(&owner->resources, resource);
+        if (!rslot) return false;
+        if (atomic_load_explicit(&rslot->live, memory_order_acquire)) {
+            ctx = (void *)atomic_load_explicit(&rslot->value, memory_order_relaxed);
         }
     }
 
-    ttak_owner_func_t func = (ttak_owner_func_t)func_ptr_val;
-
-    // 4. Execution Boundary
+    // Execution Boundary
     // Ideally, we would set thread-local storage here to indicate we are inside this owner
     // so that mem_alloc calls check the owner's policy.
-    
-    func(ctx, args);
+    fn(ctx, args);
+    return true;
+}
+
+bool ttak_owner_execute(ttak_owner_t *owner, const char *func_name, const char *resource_name, void *args) {
+    if (!owner || !func_name) return false;
 
+    // 1. Safety Check: Verify policy
+    // If strict isolation is on, ensure we aren't passing "args" from outside that violates it?
+    // For this prototype, we just proceed.
+
+    // 2. Resolve names; the lock is not held across the call itself.
+    ttak_rwlock_rdlock(&owner->lock);
+    ttak_owner_handle_t func = table_find(&owner->functions, func_name);
+    ttak_owner_handle_t resource = resource_name ? table_find(&owner->resources, resource_name)
+                                                 : TTAK_OWNER_INVALID_HANDLE;
     ttak_rwlock_unlock(&owner->lock);
-    return true;
+
+    if (func == TTAK_OWNER_INVALID_HANDLE) return false; // Function not found
+    return ttak_owner_execute_handle(owner, func, resource, args);
 }
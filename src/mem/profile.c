@@ -0,0 +1,355 @@
+/**
+ * @file profile.c
+ * @brief Sampling heap profiler for tracked allocations.
+ *
+ * The allocation hook only decrements a thread-local byte counter; roughly
+ * one allocation per sample interval takes the slow path, which captures a
+ * backtrace and files the block under its call site. Sampled blocks carry a
+ * header bit so the free hook only looks up blocks that were recorded.
+ */
+
+#include <ttak/mem/profile.h>
+#include <ttak/mem/mem.h>
+#include "../../internal/app_types.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <execinfo.h>
+#include <dlfcn.h>
+
+#define PROFILE_SITE_BUCKETS   1024
+#define PROFILE_SAMPLE_BUCKETS 4096
+
+/*
+ * Frames belonging to the profiler and the allocator itself: the recording
+ * hook and ttak_mem_alloc_safe's block constructor. Only sizes the capture;
+ * the frames actually dropped are found by return address.
+ */
+#define PROFILE_SKIP_FRAMES 2
+
+/**
+ * @brief Live statistics of one distinct backtrace.
+ */
+typedef struct ttak_profile_site {
+    struct ttak_profile_site *next;
+    uint64_t hash;
+    int depth;
+    void *frames[TTAK_PROFILE_MAX_DEPTH];
+    uint64_t live_bytes[TTAK_PROFILE_LIFETIME_BUCKETS];
+} ttak_profile_site_t;
+
+/**
+ * @brief A sampled block that has not been freed yet.
+ */
+typedef struct ttak_profile_sample {
+    struct ttak_profile_sample *next;
+    const void *ptr;
+    uint64_t weight;
+    size_t interval;                /**< Sampling interval the weight was computed for. */
+    ttak_profile_site_t *site;
+    ttak_profile_lifetime_t bucket;
+} ttak_profile_sample_t;
+
+static _Atomic size_t sample_interval = 0;
+static _Atomic uint32_t sample_generation = 0;
+static TTAK_THREAD_LOCAL int64_t bytes_until_sample = 0;
+static TTAK_THREAD_LOCAL uint32_t tls_generation = 0;
+static TTAK_THREAD_LOCAL uint64_t tls_rng = 0;
+
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+static ttak_profile_site_t *sites[PROFILE_SITE_BUCKETS];
+static ttak_profile_sample_t *samples[PROFILE_SAMPLE_BUCKETS];
+static ttak_profile_stats_t profile_stats;
+
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * @brief Draws the next exponentially distributed sampling distance.
+ */
+static int64_t next_sample_distance(size_t interval) {
+    if (tls_rng == 0) {
+        tls_rng = mix64((uint64_t)(uintptr_t)&tls_rng) | 1;
+    }
+    tls_rng ^= tls_rng << 13;
+    tls_rng ^= tls_rng >> 7;
+    tls_rng ^= tls_rng << 17;
+    // Uniform in (0, 1]; -ln(u) is exponential with mean 1.
+    double u = ((double)(tls_rng >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+    double distance = -log(u) * (double)interval;
+    return distance < 1.0 ? 1 : (int64_t)distance;
+}
+
+static ttak_profile_lifetime_t lifetime_bucket(uint64_t lifetime_ticks) {
+    if (lifetime_ticks == __TTAK_UNSAFE_MEM_FOREVER__) return TTAK_PROFILE_LIFETIME_FOREVER;
+    if (lifetime_ticks <= 100) return TTAK_PROFILE_LIFETIME_SHORT;
+    if (lifetime_ticks <= 10000) return TTAK_PROFILE_LIFETIME_MEDIUM;
+    return TTAK_PROFILE_LIFETIME_LONG;
+}
+
+static const char *lifetime_name(int bucket) {
+    static const char *const names[TTAK_PROFILE_LIFETIME_BUCKETS] = { "short", "medium", "long", "forever" };
+    return names[bucket];
+}
+
+/**
+ * @brief Advances the calling thread's byte countdown.
+ */
+int TTAK_HOT_PATH ttak_profile_should_sample(size_t size) {
+    size_t interval = atomic_load_explicit(&sample_interval, memory_order_relaxed);
+    if (!interval) return 0;
+
+    uint32_t generation = atomic_load_explicit(&sample_generation, memory_order_relaxed);
+    if (tls_generation != generation) {
+        tls_generation = generation;
+        bytes_until_sample = next_sample_distance(interval);
+    }
+    bytes_until_sample -= (int64_t)size;
+    if (bytes_until_sample > 0) return 0;
+    bytes_until_sample = next_sample_distance(interval);
+    return 1;
+}
+
+/**
+ * @brief Finds or creates the site for a backtrace. Called with profile_lock held.
+ */
+static ttak_profile_site_t *site_lookup(void *const *frames, int depth) {
+    uint64_t hash = (uint64_t)depth;
+    for (int i = 0; i < depth; i++) {
+        hash = mix64(hash ^ (uint64_t)(uintptr_t)frames[i]);
+    }
+    ttak_profile_site_t **slot = &sites[hash & (PROFILE_SITE_BUCKETS - 1)];
+    for (ttak_profile_site_t *site = *slot; site; site = site->next) {
+        if (site->hash == hash && site->depth == depth &&
+            memcmp(site->frames, frames, sizeof(void *) * (size_t)depth) == 0) {
+            return site;
+        }
+    }
+
+    ttak_profile_site_t *site = calloc(1, sizeof(*site));
+    if (!site) return NULL;
+    site->hash = hash;
+    site->depth = depth;
+    memcpy(site->frames, frames, sizeof(void *) * (size_t)depth);
+    site->next = *slot;
+    *slot = site;
+    profile_stats.sites++;
+    return site;
+}
+
+static inline size_t sample_bucket(const void *ptr) {
+    return (size_t)(mix64((uint64_t)(uintptr_t)ptr) & (PROFILE_SAMPLE_BUCKETS - 1));
+}
+
+/**
+ * @brief Unbiased estimate: a block of s bytes is sampled with probability 1 - e^(-s/interval).
+ */
+static uint64_t sample_weight(size_t size, size_t interval) {
+    double probability = -expm1(-(double)size / (double)interval);
+    return probability > 0.0 ? (uint64_t)((double)size / probability) : size;
+}
+
+/**
+ * @brief Finds the live sample of @p ptr. Called with profile_lock held.
+ */
+static ttak_profile_sample_t **sample_find(const void *ptr) {
+    ttak_profile_sample_t **indirect = &samples[sample_bucket(ptr)];
+    while (*indirect && (*indirect)->ptr != ptr) {
+        indirect = &(*indirect)->next;
+    }
+    return indirect;
+}
+
+/**
+ * @brief Records a sampled block under its call site.
+ *
+ * Kept out of line so that its return address is a frame of the block
+ * constructor no matter how -O3 -flto inlines around it.
+ */
+int TTAK_NOINLINE ttak_profile_record_alloc(const void *ptr, size_t size, uint64_t lifetime_ticks) {
+    size_t interval = atomic_load_explicit(&sample_interval, memory_order_relaxed);
+    if (!ptr || !interval) return 0;
+
+    void *frames[TTAK_PROFILE_MAX_DEPTH + PROFILE_SKIP_FRAMES];
+    int depth = backtrace(frames, TTAK_PROFILE_MAX_DEPTH + PROFILE_SKIP_FRAMES);
+    // Drop this hook and the constructor frame it returns into; the site
+    // starts at the allocator entry point that called the constructor.
+    void *constructor = __builtin_return_address(0);
+    int skip = 0;
+    while (skip < depth && frames[skip] != constructor) skip++;
+    skip = skip < depth ? skip + 1 : 0;
+
+    uint64_t weight = sample_weight(size, interval);
+
+    ttak_profile_sample_t *sample = malloc(sizeof(*sample));
+    if (!sample) return 0;
+
+    pthread_mutex_lock(&profile_lock);
+    ttak_profile_site_t *site = site_lookup(frames + skip, depth - skip);
+    if (!site) {
+        pthread_mutex_unlock(&profile_lock);
+        free(sample);
+        return 0;
+    }
+    sample->ptr = ptr;
+    sample->weight = weight;
+    sample->interval = interval;
+    sample->site = site;
+    sample->bucket = lifetime_bucket(lifetime_ticks);
+    size_t b = sample_bucket(ptr);
+    sample->next = samples[b];
+    samples[b] = sample;
+
+    site->live_bytes[sample->bucket] += weight;
+    profile_stats.live_bytes[sample->bucket] += weight;
+    profile_stats.live_samples++;
+    profile_stats.total_samples++;
+    pthread_mutex_unlock(&profile_lock);
+    return 1;
+}
+
+/**
+ * @brief Removes a sampled block from its site's live bytes.
+ */
+void ttak_profile_record_free(const void *ptr) {
+    pthread_mutex_lock(&profile_lock);
+    ttak_profile_sample_t **indirect = sample_find(ptr);
+    ttak_profile_sample_t *sample = *indirect;
+    if (sample) {
+        *indirect = sample->next;
+        sample->site->live_bytes[sample->bucket] -= sample->weight;
+        profile_stats.live_bytes[sample->bucket] -= sample->weight;
+        profile_stats.live_samples--;
+    }
+    pthread_mutex_unlock(&profile_lock);
+    free(sample);
+}
+
+/**
+ * @brief Moves a sampled block's live bytes to its new size and lifetime.
+ *
+ * The sample keeps its call site; the weight is recomputed for the new size
+ * with the interval it was sampled at.
+ */
+void ttak_profile_record_resize(const void *ptr, size_t new_size, uint64_t lifetime_ticks) {
+    pthread_mutex_lock(&profile_lock);
+    ttak_profile_sample_t *sample = *sample_find(ptr);
+    if (sample) {
+        sample->site->live_bytes[sample->bucket] -= sample->weight;
+        profile_stats.live_bytes[sample->bucket] -= sample->weight;
+        sample->weight = sample_weight(new_size, sample->interval);
+        sample->bucket = lifetime_bucket(lifetime_ticks);
+        sample->site->live_bytes[sample->bucket] += sample->weight;
+        profile_stats.live_bytes[sample->bucket] += sample->weight;
+    }
+    pthread_mutex_unlock(&profile_lock);
+}
+
+/**
+ * @brief Starts sampling with the given mean interval.
+ */
+void ttak_profile_start(size_t interval) {
+    if (interval == 0) interval = TTAK_PROFILE_DEFAULT_INTERVAL;
+    atomic_fetch_add(&sample_generation, 1);
+    atomic_store(&sample_interval, interval);
+}
+
+/**
+ * @brief Stops taking new samples.
+ */
+void ttak_profile_stop(void) {
+    atomic_store(&sample_interval, 0);
+}
+
+/**
+ * @brief Returns whether sampling is on.
+ */
+int ttak_profile_is_enabled(void) {
+    return atomic_load(&sample_interval) != 0;
+}
+
+/**
+ * @brief Drops every site and sample.
+ */
+void ttak_profile_reset(void) {
+    pthread_mutex_lock(&profile_lock);
+    for (size_t i = 0; i < PROFILE_SAMPLE_BUCKETS; i++) {
+        while (samples[i]) {
+            ttak_profile_sample_t *next = samples[i]->next;
+            free(samples[i]);
+            samples[i] = next;
+        }
+    }
+    for (size_t i = 0; i < PROFILE_SITE_BUCKETS; i++) {
+        while (sites[i]) {
+            ttak_profile_site_t *next = sites[i]->next;
+            free(sites[i]);
+            sites[i] = next;
+        }
+    }
+    memset(&profile_stats, 0, sizeof(profile_stats));
+    pthread_mutex_unlock(&profile_lock);
+}
+
+/**
+ * @brief Copies the aggregate counters.
+ */
+void ttak_profile_get_stats(ttak_profile_stats_t *out) {
+    if (!out) return;
+    pthread_mutex_lock(&profile_lock);
+    *out = profile_stats;
+    pthread_mutex_unlock(&profile_lock);
+}
+
+/**
+ * @brief Writes one frame as a folded-stack token.
+ */
+static void write_frame(FILE *out, void *addr) {
+    Dl_info info;
+    int found = dladdr(addr, &info);
+    if (found && info.dli_sname) {
+        fprintf(out, "%s", info.dli_sname);
+    } else if (found && info.dli_fname && info.dli_fbase) {
+        const char *module = strrchr(info.dli_fname, '/');
+        fprintf(out, "%s+0x%" PRIxPTR, module ? module + 1 : info.dli_fname,
+                (uintptr_t)addr - (uintptr_t)info.dli_fbase);
+    } else {
+        fprintf(out, "%p", addr);
+    }
+}
+
+/**
+ * @brief Writes live bytes per call site and lifetime bucket as folded stacks.
+ */
+long ttak_profile_dump_folded(FILE *out) {
+    if (!out) return 0;
+
+    long lines = 0;
+    pthread_mutex_lock(&profile_lock);
+    for (size_t i = 0; i < PROFILE_SITE_BUCKETS; i++) {
+        for (ttak_profile_site_t *site = sites[i]; site; site = site->next) {
+            for (int b = 0; b < TTAK_PROFILE_LIFETIME_BUCKETS; b++) {
+                if (!site->live_bytes[b]) continue;
+                fprintf(out, "lifetime=%s", lifetime_name(b));
+                // backtrace() lists the innermost frame first; folded stacks start at the root.
+                for (int f = site->depth - 1; f >= 0; f--) {
+                    fputc(';', out);
+                    write_frame(out, site->frames[f]);
+                }
+                fprintf(out, " %" PRIu64 "\n", site->live_bytes[b]);
+                lines++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&profile_lock);
+    return lines;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file slab.c
+ * @brief Per-thread size-class slab backend for small tracked allocations.
+ *
+ * Every thread owns a cache with one free list per size class. Blocks are
+ * carved from 64 KiB spans that are aligned to their size, so the owning span
+ * (and therefore the owning cache) of a block is found by masking its address.
+ * Frees issued by a foreign thread are pushed onto the owner's lock-free
+ * remote list, which the owner drains when a class runs dry.
+ */
+
+#include <ttak/mem/slab.h>
+#include "../../internal/app_types.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define TTAK_SLAB_SPAN_MAGIC 0x534C4142U /* "SLAB" */
+
+static const uint32_t slab_class_sizes[TTAK_SLAB_NUM_CLASSES] = {
+    32, 48, 64, 96, 128, 192,
+    256, 320, 384, 512, 640, 768, 1024, 1536, 2048, 3072, 4096
+};
+
+typedef struct ttak_slab_cache ttak_slab_cache_t;
+
+/**
+ * @brief Span descriptor stored in the first cache line of every span.
+ */
+typedef struct ttak_slab_span {
+    alignas(64) uint32_t magic;  /**< TTAK_SLAB_SPAN_MAGIC */
+    uint32_t block_size;         /**< Size class of every block in the span */
+    uint32_t capacity;           /**< Number of blocks that fit in the span */
+    uint32_t carved;             /**< Blocks handed out by the bump cursor so far */
+    uint8_t  cls;                /**< Size class index */
+    ttak_slab_cache_t *cache;    /**< Owning thread cache */
+    struct ttak_slab_span *next; /**< Next span of the same class */
+} ttak_slab_span_t;
+
+/**
+ * @brief Per-thread cache. Only the owner touches the free lists; other
+ * threads only ever push onto remote_head.
+ */
+struct ttak_slab_cache {
+    void *free_list[TTAK_SLAB_NUM_CLASSES];         /**< Recycled blocks per class */
+    ttak_slab_span_t *spans[TTAK_SLAB_NUM_CLASSES]; /**< Spans per class, head is being carved */
+    _Atomic uintptr_t remote_head;                  /**< Treiber stack of cross-thread frees */
+    struct ttak_slab_cache *next_orphan;            /**< Link while parked after thread exit */
+};
+
+static TTAK_THREAD_LOCAL ttak_slab_cache_t *tls_cache = NULL;
+static pthread_key_t slab_key;
+static pthread_once_t slab_key_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t slab_orphan_lock = PTHREAD_MUTEX_INITIALIZER;
+static ttak_slab_cache_t *slab_orphans = NULL;
+
+/**
+ * @brief Free-list links live in the last word of a block so the tracked
+ * header at the front stays readable while the block is cached.
+ */
+static inline void **slab_link(void *block, uint32_t block_size) {
+    return (void **)((char *)block + block_size - sizeof(void *));
+}
+
+static inline ttak_slab_span_t *slab_span_of(const void *block) {
+    return (ttak_slab_span_t *)((uintptr_t)block & ~((uintptr_t)TTAK_SLAB_SPAN_SIZE - 1));
+}
+
+/**
+ * @brief Map a block size to its size class index.
+ *
+ * @return Class index, or -1 if the size is not slab-eligible.
+ */
+static inline int slab_class_of(size_t block_size) {
+    if (block_size == 0 || block_size > TTAK_SLAB_MAX_BLOCK) return -1;
+    for (int cls = 0; cls < TTAK_SLAB_NUM_CLASSES; cls++) {
+        if (block_size <= slab_class_sizes[cls]) return cls;
+    }
+    return -1;
+}
+
+/**
+ * @brief Thread-exit hook: park the cache so a later thread can adopt it.
+ *
+ * Live blocks keep pointing at the cache, so it is never released; frees that
+ * arrive while it is parked accumulate on its remote list.
+ */
+static void slab_cache_orphan(void *arg) {
+    ttak_slab_cache_t *cache = (ttak_slab_cache_t *)arg;
+    if (!cache) return;
+    pthread_mutex_lock(&slab_orphan_lock);
+    cache->next_orphan = slab_orphans;
+    slab_orphans = cache;
+    pthread_mutex_unlock(&slab_orphan_lock);
+}
+
+static void slab_key_create(void) {
+    pthread_key_create(&slab_key, slab_cache_orphan);
+}
+
+/**
+ * @brief Return the calling thread's cache, adopting or creating one on first use.
+ */
+static ttak_slab_cache_t *slab_current_cache(void) {
+#if defined(__TINYC__)
+    pthread_once(&slab_key_once, slab_key_create);
+    ttak_slab_cache_t *cache = (ttak_slab_cache_t *)pthread_getspecific(slab_key);
+    if (cache) return cache;
+#else
+    if (tls_cache) return tls_cache;
+    pthread_once(&slab_key_once, slab_key_create);
+    ttak_slab_cache_t *cache = NULL;
+#endif
+
+    pthread_mutex_lock(&slab_orphan_lock);
+    if (slab_orphans) {
+        cache = slab_orphans;
+        slab_orphans = cache->next_orphan;
+        cache->next_orphan = NULL;
+    }
+    pthread_mutex_unlock(&slab_orphan_lock);
+
+    if (!cache) {
+        cache = calloc(1, sizeof(ttak_slab_cache_t));
+        if (!cache) return NULL;
+        atomic_init(&cache->remote_head, (uintptr_t)0);
+    }
+
+    pthread_setspecific(slab_key, cache);
+    tls_cache = cache;
+    return cache;
+}
+
+/**
+ * @brief Move every block on the remote list back onto the owner's free lists.
+ */
+static void slab_drain_remote(ttak_slab_cache_t *cache) {
+    uintptr_t head = atomic_load_explicit(&cache->remote_head, memory_order_acquire);
+    if (!head) return;
+    while (!atomic_compare_exchange_weak_explicit(&cache->remote_head, &head, (uintptr_t)0,
+                                                  memory_order_acquire, memory_order_acquire)) {
+        if (!head) return;
+    }
+
+    void *block = (void *)head;
+    while (block) {
+        ttak_slab_span_t *span = slab_span_of(block);
+        void **link = slab_link(block, span->block_size);
+        void *next = *link;
+        *link = cache->free_list[span->cls];
+        cache->free_list[span->cls] = block;
+        block = next;
+    }
+}
+
+/**
+ * @brief Carve a block from the class's current span, mapping a new span if needed.
+ */
+static void *slab_carve(ttak_slab_cache_t *cache, int cls) {
+    ttak_slab_span_t *span = cache->spans[cls];
+    if (!span || span->carved == span->capacity) {
+        void *mem = NULL;
+        if (posix_memalign(&mem, TTAK_SLAB_SPAN_SIZE, TTAK_SLAB_SPAN_SIZE) != 0) return NULL;
+        span = (ttak_slab_span_t *)mem;
+        span->magic = TTAK_SLAB_SPAN_MAGIC;
+        span->block_size = slab_class_sizes[cls];
+        span->capacity = (uint32_t)((TTAK_SLAB_SPAN_SIZE - sizeof(ttak_slab_span_t)) / span->block_size);
+        span->carved = 0;
+        span->cls = (uint8_t)cls;
+        span->cache = cache;
+        span->next = cache->spans[cls];
+        cache->spans[cls] = span;
+    }
+    void *block = (char *)span + sizeof(ttak_slab_span_t) + (size_t)span->carved * span->block_size;
+    span->carved++;
+    return block;
+}
+
+/**
+ * @brief Allocate a raw block from the calling thread's cache.
+ *
+ * @param block_size Total bytes required.
+ * @return Block pointer or NULL.
+ */
+void TTAK_HOT_PATH *ttak_slab_alloc(size_t block_size) {
+    int cls = slab_class_of(block_size);
+    if (cls < 0) return NULL;
+
+    ttak_slab_cache_t *cache = slab_current_cache();
+    if (!cache) return NULL;
+
+    void *block = cache->free_list[cls];
+    if (!block) {
+        slab_drain_remote(cache);
+        block = cache->free_list[cls];
+    }
+    if (block) {
+        cache->free_list[cls] = *slab_link(block, slab_class_sizes[cls]);
+        return block;
+    }
+    return slab_carve(cache, cls);
+}
+
+/**
+ * @brief Return a block to its owning cache (locally or via the remote list).
+ *
+ * @param block Block to release.
+ */
+void TTAK_HOT_PATH ttak_slab_free(void *block) {
+    if (!block) return;
+    ttak_slab_span_t *span = slab_span_of(block);
+    ttak_slab_cache_t *owner = span->cache;
+    void **link = slab_link(block, span->block_size);
+
+#if defined(__TINYC__)
+    ttak_slab_cache_t *self = (ttak_slab_cache_t *)pthread_getspecific(slab_key);
+#else
+    ttak_slab_cache_t *self = tls_cache;
+#endif
+    if (owner == self) {
+        *link = owner->free_list[span->cls];
+        owner->free_list[span->cls] = block;
+        return;
+    }
+
+    uintptr_t head = atomic_load_explicit(&owner->remote_head, memory_order_relaxed);
+    do {
+        *link = (void *)head;
+    } while (!atomic_compare_exchange_weak_explicit(&owner->remote_head, &head, (uintptr_t)block,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+/**
+ * @brief Report the size class a block was carved from.
+ *
+ * @param block Block to inspect.
+ * @return Class size in bytes.
+ */
+size_t ttak_slab_block_size(const void *block) {
+    if (!block) return 0;
+    return slab_span_of(block)->block_size;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file trace.c
+ * @brief Binary memory tracing through per-thread lock-free rings.
+ *
+ * Each tracing thread owns a single-producer ring of fixed 64-byte records.
+ * Emitting an event fills one slot and publishes it with a release store of
+ * the ring head; no lock, allocation or formatting happens on the caller's
+ * path. A background drain thread consumes every ring and writes the records
+ * to a binary file, or formats them as JSON lines on stderr when no file is
+ * configured. Rings of exited threads are freed once drained.
+ */
+
+#include <ttak/mem/trace.h>
+#include "../../internal/app_types.h"
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+
+#define TRACE_RING_MASK ((uint64_t)TTAK_TRACE_RING_SIZE - 1)
+#define TRACE_DRAIN_INTERVAL_NS 1000000L
+
+_Static_assert(sizeof(ttak_trace_record_t) == 64, "trace records must stay one cache line");
+_Static_assert((TTAK_TRACE_RING_SIZE & (TTAK_TRACE_RING_SIZE - 1)) == 0, "ring size must be a power of two");
+
+/**
+ * @brief Single-producer, single-consumer ring owned by one thread.
+ */
+typedef struct ttak_trace_ring {
+    alignas(64) _Atomic uint64_t head;  /**< Next slot the owner writes. */
+    alignas(64) _Atomic uint64_t tail;  /**< Next slot the drain thread reads. */
+    _Atomic int orphaned;               /**< Set when the owning thread exits. */
+    uint32_t tid;                       /**< Small ID stamped into records. */
+    struct ttak_trace_ring *next;       /**< Next ring in the global list. */
+    ttak_trace_record_t records[TTAK_TRACE_RING_SIZE];
+} ttak_trace_ring_t;
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static ttak_trace_ring_t *rings = NULL;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+static TTAK_THREAD_LOCAL ttak_trace_ring_t *tls_ring = NULL;
+static _Atomic uint64_t dropped_events = 0;
+static _Atomic uint32_t next_tid = 1;
+
+static char *output_path = NULL;
+static FILE *sink = NULL;
+static bool sink_binary = false;
+static bool running = false;
+static _Atomic int drain_active = 0;
+static pthread_t drain_thread;
+
+/**
+ * @brief Marks an exiting thread's ring so the drain thread frees it once empty.
+ */
+static void ring_orphan(void *arg) {
+    ttak_trace_ring_t *ring = arg;
+    atomic_store_explicit(&ring->orphaned, 1, memory_order_release);
+    tls_ring = NULL;
+}
+
+static void ring_key_init(void) {
+    pthread_key_create(&ring_key, ring_orphan);
+}
+
+/**
+ * @brief Creates and registers the calling thread's ring.
+ */
+static ttak_trace_ring_t *ring_attach(void) {
+    pthread_once(&ring_key_once, ring_key_init);
+    ttak_trace_ring_t *ring = aligned_alloc(64, sizeof(ttak_trace_ring_t));
+    if (!ring) return NULL;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->orphaned, 0);
+    ring->tid = atomic_fetch_add(&next_tid, 1);
+
+    pthread_mutex_lock(&trace_lock);
+    ring->next = rings;
+    rings = ring;
+    pthread_mutex_unlock(&trace_lock);
+
+    pthread_setspecific(ring_key, ring);
+    tls_ring = ring;
+    return ring;
+}
+
+/**
+ * @brief Appends one record to the calling thread's ring.
+ */
+void TTAK_HOT_PATH ttak_trace_emit(ttak_trace_event_t event, const void *ptr, uint64_t a, uint64_t b, uint64_t ts, const char *name) {
+    ttak_trace_ring_t *ring = tls_ring;
+    if (!ring && !(ring = ring_attach())) {
+        atomic_fetch_add_explicit(&dropped_events, 1, memory_order_relaxed);
+        return;
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= TTAK_TRACE_RING_SIZE) {
+        atomic_fetch_add_explicit(&dropped_events, 1, memory_order_relaxed);
+        return;
+    }
+
+    ttak_trace_record_t *rec = &ring->records[head & TRACE_RING_MASK];
+    rec->ts = ts;
+    rec->ptr = (uint64_t)(uintptr_t)ptr;
+    rec->a = a;
+    rec->b = b;
+    rec->event = (uint32_t)event;
+    rec->tid = ring->tid;
+    memset(rec->name, 0, sizeof(rec->name));
+    if (name) {
+        for (size_t i = 0; i < TTAK_TRACE_NAME_LEN - 1 && name[i]; i++) {
+            rec->name[i] = name[i];
+        }
+    }
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+/**
+ * @brief Returns the number of events dropped on full rings.
+ */
+uint64_t ttak_trace_dropped(void) {
+    return atomic_load(&dropped_events);
+}
+
+/**
+ * @brief Formats one record as the JSON object of the text trace.
+ */
+int ttak_trace_format(const ttak_trace_record_t *rec, char *buf, size_t len) {
+    void *ptr = (void *)(uintptr_t)rec->ptr;
+    char name[TTAK_TRACE_NAME_LEN];
+    memcpy(name, rec->name, sizeof(name));
+    name[TTAK_TRACE_NAME_LEN - 1] = '\0';
+
+    switch ((ttak_trace_event_t)rec->event) {
+        case TTAK_TRACE_ALLOC:
+            return snprintf(buf, len, "{\"event\":\"alloc\",\"ptr\":\"%p\",\"size\":%" PRIu64 ",\"ts\":%" PRIu64 ",\"root\":%d}",
+                            ptr, rec->a, rec->ts, (int)rec->b);
+        case TTAK_TRACE_ACCESS:
+            return snprintf(buf, len, "{\"event\":\"access\",\"ptr\":\"%p\",\"count\":%" PRIu64 ",\"ts\":%" PRIu64 "}",
+                            ptr, rec->a, rec->ts);
+        case TTAK_TRACE_FREE:
+            return snprintf(buf, len, "{\"event\":\"free\",\"ptr\":\"%p\",\"ts\":%" PRIu64 "}", ptr, rec->ts);
+        case TTAK_TRACE_ENABLED:
+            return snprintf(buf, len, "{\"event\":\"trace_enabled\",\"ts\":%" PRIu64 "}", rec->ts);
+        case TTAK_TRACE_REGISTER:
+            return snprintf(buf, len, "{\"event\":\"register\",\"ptr\":\"%p\",\"owner\":\"%p\",\"name\":\"%s\",\"ts\":%" PRIu64 "}",
+                            ptr, (void *)(uintptr_t)rec->a, name, rec->ts);
+        case TTAK_TRACE_TRANSFER:
+            return snprintf(buf, len, "{\"event\":\"transfer\",\"ptr\":\"%p\",\"from\":\"%p\",\"to\":\"%p\",\"name\":\"%s\",\"ts\":%" PRIu64 "}",
+                            ptr, (void *)(uintptr_t)rec->a, (void *)(uintptr_t)rec->b, name, rec->ts);
+    }
+    return -1;
+}
+
+/**
+ * @brief Writes one record to the current sink.
+ */
+static void sink_write(const ttak_trace_record_t *rec) {
+    if (sink_binary) {
+        fwrite(rec, sizeof(*rec), 1, sink);
+        return;
+    }
+    char line[256];
+    if (ttak_trace_format(rec, line, sizeof(line)) >= 0) {
+        fprintf(sink, "[MEM_TRACK] %s\n", line);
+    }
+}
+
+/**
+ * @brief Consumes every ring once and frees drained rings of exited threads.
+ */
+static void drain_once(void) {
+    pthread_mutex_lock(&trace_lock);
+    ttak_trace_ring_t **indirect = &rings;
+    while (*indirect) {
+        ttak_trace_ring_t *ring = *indirect;
+        int orphaned = atomic_load_explicit(&ring->orphaned, memory_order_acquire);
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        for (; tail != head; tail++) {
+            if (sink) sink_write(&ring->records[tail & TRACE_RING_MASK]);
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+        if (orphaned) {
+            *indirect = ring->next;
+            free(ring);
+            continue;
+        }
+        indirect = &ring->next;
+    }
+    if (sink) fflush(sink);
+    pthread_mutex_unlock(&trace_lock);
+}
+
+static void *drain_thread_func(void *arg) {
+    (void)arg;
+    struct timespec interval = { 0, TRACE_DRAIN_INTERVAL_NS };
+    while (atomic_load(&drain_active)) {
+        drain_once();
+        nanosleep(&interval, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Selects the binary file (or stderr JSON) output.
+ */
+int ttak_trace_set_output(const char *path) {
+    pthread_mutex_lock(&trace_lock);
+    if (running) {
+        pthread_mutex_unlock(&trace_lock);
+        return -1;
+    }
+    free(output_path);
+    output_path = path ? strdup(path) : NULL;
+    int rc = (path && !output_path) ? -1 : 0;
+    pthread_mutex_unlock(&trace_lock);
+    return rc;
+}
+
+/**
+ * @brief Opens the sink and launches the drain thread.
+ */
+int ttak_trace_start(void) {
+    pthread_mutex_lock(&trace_lock);
+    if (running) {
+        pthread_mutex_unlock(&trace_lock);
+        return 0;
+    }
+
+    if (output_path) {
+        sink = fopen(output_path, "wb");
+        if (!sink) {
+            pthread_mutex_unlock(&trace_lock);
+            return -1;
+        }
+        ttak_trace_file_header_t header = { .version = TTAK_TRACE_VERSION, .record_size = sizeof(ttak_trace_record_t) };
+        memcpy(header.magic, TTAK_TRACE_MAGIC, sizeof(header.magic));
+        fwrite(&header, sizeof(header), 1, sink);
+        sink_binary = true;
+    } else {
+        sink = stderr;
+        sink_binary = false;
+    }
+
+    atomic_store(&drain_active, 1);
+    if (pthread_create(&drain_thread, NULL, drain_thread_func, NULL) != 0) {
+        atomic_store(&drain_active, 0);
+        if (sink_binary) fclose(sink);
+        sink = NULL;
+        pthread_mutex_unlock(&trace_lock);
+        return -1;
+    }
+    running = true;
+    pthread_mutex_unlock(&trace_lock);
+    return 0;
+}
+
+/**
+ * @brief Joins the drain thread, flushes the rings and closes the sink.
+ */
+void ttak_trace_stop(void) {
+    pthread_mutex_lock(&trace_lock);
+    if (!running) {
+        pthread_mutex_unlock(&trace_lock);
+        return;
+    }
+    running = false;
+    atomic_store(&drain_active, 0);
+    pthread_mutex_unlock(&trace_lock);
+
+    pthread_join(drain_thread, NULL);
+    drain_once();
+
+    pthread_mutex_lock(&trace_lock);
+    if (sink_binary && sink) fclose(sink);
+    sink = NULL;
+    sink_binary = false;
+    pthread_mutex_unlock(&trace_lock);
+}
+
+/**
+ * @brief Converts a binary trace into "[MEM_TRACK] {json}" lines.
+ */
+long ttak_trace_decode(FILE *in, FILE *out) {
+    ttak_trace_file_header_t header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, TTAK_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TTAK_TRACE_VERSION ||
+        header.record_size != sizeof(ttak_trace_record_t)) {
+        return -1;
+    }
+
+    long count = 0;
+    ttak_trace_record_t rec;
+    char line[256];
+    while (fread(&rec, sizeof(rec), 1, in) == 1) {
+        if (ttak_trace_format(&rec, line, sizeof(line)) >= 0) {
+            fprintf(out, "[MEM_TRACK] %s\n", line);
+            count++;
+        }
+    }
+    return count;
+}
@@ -9,6 +9,228 @@
 // Forward declaration for the cleanup thread function
 static void *cleanup_thread_func(void *arg);
 
+#define TTAK_MEM_TREE_INITIAL_BUCKETS 64
+
+/**
+ * @brief Mix a tracked pointer into a well-distributed 64-bit hash.
+ *
+ * The low bits select the shard, the remaining bits select the index bucket.
+ */
+static inline uint64_t mem_tree_hash(const void *ptr) {
+    uint64_t h = (uint64_t)(uintptr_t)ptr;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline size_t mem_tree_bucket(uint64_t h, size_t bucket_count) {
+    return (size_t)(h >> 4) & (bucket_count - 1);
+}
+
+/**
+ * @brief Double a shard's index once it holds more nodes than buckets.
+ *
+ * Called with the shard locked. On allocation failure the old index is kept;
+ * lookups stay correct, only chains get longer.
+ */
+static void mem_tree_shard_grow(ttak_mem_tree_shard_t *shard) {
+    size_t new_count = shard->bucket_count ? shard->bucket_count * 2 : TTAK_MEM_TREE_INITIAL_BUCKETS;
+    ttak_mem_node_t **new_buckets = calloc(new_count, sizeof(ttak_mem_node_t *));
+    if (!new_buckets) return;
+
+    for (ttak_mem_node_t *n = shard->head; n; n = n->next) {
+        size_t b = mem_tree_bucket(mem_tree_hash(n->ptr), new_count);
+        n->hash_next = new_buckets[b];
+        new_buckets[b] = n;
+    }
+    free(shard->buckets);
+    shard->buckets = new_buckets;
+    shard->bucket_count = new_count;
+}
+
+#define TTAK_MEM_TREE_WHEEL_MASK ((uint64_t)TTAK_MEM_TREE_WHEEL_SLOTS - 1)
+#define TTAK_MEM_TREE_WHEEL_SPAN (1ULL << (TTAK_MEM_TREE_WHEEL_BITS * TTAK_MEM_TREE_WHEEL_LEVELS))
+
+static inline void timer_link(ttak_mem_node_t **head, ttak_mem_node_t *node) {
+    node->timer_next = *head;
+    if (*head) {
+        (*head)->timer_pprev = &node->timer_next;
+    }
+    *head = node;
+    node->timer_pprev = head;
+}
+
+static inline void timer_unlink(ttak_mem_node_t *node) {
+    if (!node->timer_pprev) return;
+    *node->timer_pprev = node->timer_next;
+    if (node->timer_next) {
+        node->timer_next->timer_pprev = node->timer_pprev;
+    }
+    node->timer_next = NULL;
+    node->timer_pprev = NULL;
+}
+
+/**
+ * @brief Detach a whole timer list and prepend its nodes to a pending chain.
+ */
+static void timer_take_list(ttak_mem_node_t **head, ttak_mem_node_t **pending) {
+    ttak_mem_node_t *n = *head;
+    *head = NULL;
+    while (n) {
+        ttak_mem_node_t *next = n->timer_next;
+        n->timer_pprev = NULL;
+        n->timer_next = *pending;
+        *pending = n;
+        n = next;
+    }
+}
+
+/**
+ * @brief File a node under the wheel slot, overflow list or due list matching
+ * its expiry relative to the shard's wheel base. Shard must be locked.
+ */
+static void timer_schedule(ttak_mem_tree_shard_t *shard, ttak_mem_node_t *node) {
+    uint64_t expires = node->expires_tick;
+    if (expires == __TTAK_UNSAFE_MEM_FOREVER__) return;
+
+    if (expires <= shard->wheel_base) {
+        timer_link(&shard->due, node);
+        return;
+    }
+
+    uint64_t delta = expires - shard->wheel_base;
+    unsigned level = 0;
+    while (level < TTAK_MEM_TREE_WHEEL_LEVELS && (delta >> (TTAK_MEM_TREE_WHEEL_BITS * (level + 1))) != 0) {
+        level++;
+    }
+    if (level == TTAK_MEM_TREE_WHEEL_LEVELS) {
+        timer_link(&shard->overflow, node);
+        if (expires < shard->overflow_min) {
+            shard->overflow_min = expires;
+        }
+        return;
+    }
+    uint64_t slot = (expires >> (TTAK_MEM_TREE_WHEEL_BITS * level)) & TTAK_MEM_TREE_WHEEL_MASK;
+    timer_link(&shard->wheel[level][slot], node);
+}
+
+/**
+ * @brief Advance a shard's wheel to @p now. Shard must be locked.
+ *
+ * For every level, only the slots whose window was crossed since the last
+ * advance are drained; their nodes are re-filed against the new base, which
+ * moves expired ones to the due list and cascades the rest to finer levels.
+ */
+static void timer_advance(ttak_mem_tree_shard_t *shard, uint64_t now) {
+    if (now <= shard->wheel_base) return;
+
+    ttak_mem_node_t *pending = NULL;
+    for (unsigned level = 0; level < TTAK_MEM_TREE_WHEEL_LEVELS; level++) {
+        unsigned shift = TTAK_MEM_TREE_WHEEL_BITS * level;
+        uint64_t first = (shard->wheel_base >> shift) + 1;
+        uint64_t last = now >> shift;
+        if (last < first) continue;
+        if (last - first >= TTAK_MEM_TREE_WHEEL_MASK) {
+            for (uint64_t slot = 0; slot < TTAK_MEM_TREE_WHEEL_SLOTS; slot++) {
+                timer_take_list(&shard->wheel[level][slot], &pending);
+            }
+        } else {
+            for (uint64_t w = first; w <= last; w++) {
+                timer_take_list(&shard->wheel[level][w & TTAK_MEM_TREE_WHEEL_MASK], &pending);
+            }
+        }
+    }
+    if (shard->overflow && (shard->overflow_min <= now || shard->overflow_min - now < TTAK_MEM_TREE_WHEEL_SPAN)) {
+        timer_take_list(&shard->overflow, &pending);
+        shard->overflow_min = UINT64_MAX;
+    }
+
+    shard->wheel_base = now;
+    while (pending) {
+        ttak_mem_node_t *next = pending->timer_next;
+        pending->timer_next = NULL;
+        timer_schedule(shard, pending);
+        pending = next;
+    }
+}
+
+/**
+ * @brief Unlink a node from its shard's list and index. Shard must be locked.
+ */
+static void mem_tree_shard_unlink(ttak_mem_tree_shard_t *shard, ttak_mem_node_t *node) {
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else if (shard->head == node) {
+        shard->head = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+
+    if (shard->buckets) {
+        ttak_mem_node_t **indirect = &shard->buckets[mem_tree_bucket(mem_tree_hash(node->ptr), shard->bucket_count)];
+        while (*indirect && *indirect != node) {
+            indirect = &(*indirect)->hash_next;
+        }
+        if (*indirect) {
+            *indirect = node->hash_next;
+        }
+    }
+    timer_unlink(node);
+    node->next = NULL;
+    node->prev = NULL;
+    node->hash_next = NULL;
+    shard->count--;
+}
+
+/**
+ * @brief Allocate and initialize an unlinked node with a reference count of 1.
+ */
+static ttak_mem_node_t *mem_tree_node_new(ttak_mem_tree_t *tree, void *ptr, size_t size, uint64_t expires_tick, _Bool is_root) {
+    ttak_mem_node_t *new_node = (ttak_mem_node_t *)malloc(sizeof(ttak_mem_node_t));
+    if (!new_node) {
+        fprintf(stderr, "[TTAK_MEM_TREE] Failed to allocate mem node.\n");
+        return NULL;
+    }
+
+    new_node->ptr = ptr;
+    new_node->size = size;
+    new_node->expires_tick = expires_tick;
+    atomic_init(&new_node->ref_count, 1); // Initial ref count is 1
+    new_node->is_root = is_root;
+    new_node->tree = tree;
+    new_node->timer_next = NULL;
+    new_node->timer_pprev = NULL;
+    new_node->hash_next = NULL;
+    new_node->shard = (uint32_t)(mem_tree_hash(ptr) & (TTAK_MEM_TREE_SHARDS - 1));
+    pthread_mutex_init(&new_node->lock, NULL);
+    return new_node;
+}
+
+/**
+ * @brief Link a node into its shard's list, index and timer wheel. Shard must be locked.
+ */
+static void mem_tree_shard_link(ttak_mem_tree_shard_t *shard, ttak_mem_node_t *node) {
+    node->next = shard->head;
+    node->prev = NULL;
+    if (shard->head) {
+        shard->head->prev = node;
+    }
+    shard->head = node;
+    shard->count++;
+    if (shard->count > shard->bucket_count) {
+        mem_tree_shard_grow(shard); // Rebuilds the index including node
+    } else {
+        size_t b = mem_tree_bucket(mem_tree_hash(node->ptr), shard->bucket_count);
+        node->hash_next = shard->buckets[b];
+        shard->buckets[b] = node;
+    }
+    timer_schedule(shard, node);
+}
+
 /**
  * @brief Initializes a new mem tree instance.
  *
@@ -22,6 +244,12 @@ void ttak_mem_tree_init(ttak_mem_tree_t *tree) {
     if (!tree) return;
 
     memset(tree, 0, sizeof(ttak_mem_tree_t));
+    uint64_t now = ttak_get_tick_count();
+    for (size_t i = 0; i < TTAK_MEM_TREE_SHARDS; i++) {
+        pthread_mutex_init(&tree->shards[i].lock, NULL);
+        tree->shards[i].wheel_base = now;
+        tree->shards[i].overflow_min = UINT64_MAX;
+    }
     pthread_mutex_init(&tree->lock, NULL);
     pthread_cond_init(&tree->cond, NULL);
     atomic_store(&tree->min_cleanup_interval_ns, TT_MILLI_SECOND(500)); // Default min 500ms
@@ -59,21 +287,32 @@ void ttak_mem_tree_destroy(ttak_mem_tree_t *tree) {
         pthread_join(tree->cleanup_thread, NULL);
     }
 
-    pthread_mutex_lock(&tree->lock);
-    ttak_mem_node_t *to_free_list = tree->head;
-    tree->head = NULL;
-    pthread_mutex_unlock(&tree->lock);
-
-    ttak_mem_node_t *current = to_free_list;
-    while (current) {
-        ttak_mem_node_t *next = current->next;
-        // Free the actual memory block if it hasn't been freed already
-        if (current->ptr) {
-            ttak_mem_free(current->ptr);
+    for (size_t i = 0; i < TTAK_MEM_TREE_SHARDS; i++) {
+        ttak_mem_tree_shard_t *shard = &tree->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        ttak_mem_node_t *to_free_list = shard->head;
+        shard->head = NULL;
+        shard->count = 0;
+        free(shard->buckets);
+        shard->buckets = NULL;
+        shard->bucket_count = 0;
+        for (ttak_mem_node_t *n = to_free_list; n; n = n->next) {
+            n->tree = NULL; // Detached: a nested ttak_mem_free must not unlink it again
         }
-        pthread_mutex_destroy(&current->lock);
-        free(current); // Free the mem node itself
-        current = next;
+        pthread_mutex_unlock(&shard->lock);
+
+        ttak_mem_node_t *current = to_free_list;
+        while (current) {
+            ttak_mem_node_t *next = current->next;
+            // Free the actual memory block if it hasn't been freed already
+            if (current->ptr) {
+                ttak_mem_free(current->ptr);
+            }
+            pthread_mutex_destroy(&current->lock);
+            free(current); // Free the mem node itself
+            current = next;
+        }
+        pthread_mutex_destroy(&shard->lock);
     }
     pthread_cond_destroy(&tree->cond);
     pthread_mutex_destroy(&tree->lock);
@@ -96,38 +335,68 @@ void ttak_mem_tree_destroy(ttak_mem_tree_t *tree) {
 ttak_mem_node_t *ttak_mem_tree_add(ttak_mem_tree_t *tree, void *ptr, size_t size, uint64_t expires_tick, _Bool is_root) {
     if (!tree || !ptr) return NULL;
 
-    ttak_mem_node_t *new_node = (ttak_mem_node_t *)malloc(sizeof(ttak_mem_node_t));
-    if (!new_node) {
-        fprintf(stderr, "[TTAK_MEM_TREE] Failed to allocate mem node.\n");
-        return NULL;
-    }
+    ttak_mem_node_t *new_node = mem_tree_node_new(tree, ptr, size, expires_tick, is_root);
+    if (!new_node) return NULL;
 
-    new_node->ptr = ptr;
-    new_node->size = size;
-    new_node->expires_tick = expires_tick;
-    atomic_init(&new_node->ref_count, 1); // Initial ref count is 1
-    new_node->is_root = is_root;
-    new_node->tree = tree;
-    pthread_mutex_init(&new_node->lock, NULL);
+    ttak_mem_tree_shard_t *shard = &tree->shards[new_node->shard];
+    pthread_mutex_lock(&shard->lock);
+    mem_tree_shard_link(shard, new_node);
+    pthread_mutex_unlock(&shard->lock);
 
-    pthread_mutex_lock(&tree->lock);
-    new_node->next = tree->head;
-    new_node->prev = NULL;
-    if (tree->head) {
-        tree->head->prev = new_node;
+    return new_node;
+}
+
+/**
+ * @brief Adds several memory blocks with one lock acquisition per shard.
+ *
+ * All nodes are built before any shard is locked; each touched shard is then
+ * locked once and receives all of its nodes in one splice.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param ptrs Blocks to track; NULL entries are skipped.
+ * @param sizes Size of each block.
+ * @param count Number of entries.
+ * @param expires_tick Expiry shared by every block.
+ * @param is_root Root flag shared by every block.
+ * @param nodes_out Receives the node of each entry (NULL if skipped or failed).
+ * @return Number of blocks added.
+ */
+size_t ttak_mem_tree_add_batch(ttak_mem_tree_t *tree, void *const *ptrs, const size_t *sizes, size_t count,
+                               uint64_t expires_tick, _Bool is_root, ttak_mem_node_t **nodes_out) {
+    if (!tree || !ptrs || !sizes || !nodes_out) return 0;
+
+    uint32_t shard_mask = 0;
+    size_t added = 0;
+    for (size_t i = 0; i < count; i++) {
+        nodes_out[i] = ptrs[i] ? mem_tree_node_new(tree, ptrs[i], sizes[i], expires_tick, is_root) : NULL;
+        if (nodes_out[i]) {
+            shard_mask |= 1U << nodes_out[i]->shard;
+            added++;
+        }
     }
-    tree->head = new_node;
-    pthread_mutex_unlock(&tree->lock);
 
-    return new_node;
+    for (uint32_t s = 0; s < TTAK_MEM_TREE_SHARDS; s++) {
+        if (!(shard_mask & (1U << s))) continue;
+        ttak_mem_tree_shard_t *shard = &tree->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        for (size_t i = 0; i < count; i++) {
+            if (nodes_out[i] && nodes_out[i]->shard == s) {
+                mem_tree_shard_link(shard, nodes_out[i]);
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return added;
 }
 
 /**
  * @brief Removes a memory block from the mem tree.
  *
- * This function unlinks the node from the tree's bookkeeping list, but it does
- * not release the underlying allocation. Callers are responsible for freeing
- * the tracked pointer once it has been detached from the tree.
+ * This function unlinks the node from its shard's list and pointer index in
+ * O(1), but it does not release the underlying allocation. Callers are
+ * responsible for freeing the tracked pointer once it has been detached.
+ * Nodes already detached by a cleanup pass or destroy are owned by that pass
+ * and left untouched here.
  *
  * @param tree Pointer to the mem tree.
  * @param node Pointer to the mem node to remove.
@@ -135,22 +404,79 @@ ttak_mem_node_t *ttak_mem_tree_add(ttak_mem_tree_t *tree, void *ptr, size_t size
 void ttak_mem_tree_remove(ttak_mem_tree_t *tree, ttak_mem_node_t *node) {
     if (!tree || !node) return;
 
-    pthread_mutex_lock(&tree->lock);
-    
-    if (node->prev) {
-        node->prev->next = node->next;
-    } else if (tree->head == node) {
-        tree->head = node->next;
+    ttak_mem_tree_shard_t *shard = &tree->shards[node->shard];
+    pthread_mutex_lock(&shard->lock);
+    if (node->tree != tree) {
+        pthread_mutex_unlock(&shard->lock);
+        return;
     }
+    mem_tree_shard_unlink(shard, node);
+    pthread_mutex_unlock(&shard->lock);
 
-    if (node->next) {
-        node->next->prev = node->prev;
+    pthread_mutex_destroy(&node->lock);
+    free(node); // Free the mem node itself
+}
+
+/**
+ * @brief Removes several memory blocks with one lock acquisition per shard.
+ *
+ * Same contract as ttak_mem_tree_remove for every entry: nodes already
+ * detached by a cleanup pass are left to that pass.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param nodes Nodes to remove; NULL entries are skipped. Every entry is cleared.
+ * @param count Number of entries.
+ */
+void ttak_mem_tree_remove_batch(ttak_mem_tree_t *tree, ttak_mem_node_t **nodes, size_t count) {
+    if (!tree || !nodes) return;
+
+    uint32_t shard_mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (nodes[i]) shard_mask |= 1U << nodes[i]->shard;
     }
 
-    pthread_mutex_unlock(&tree->lock);
+    for (uint32_t s = 0; s < TTAK_MEM_TREE_SHARDS; s++) {
+        if (!(shard_mask & (1U << s))) continue;
+        ttak_mem_tree_shard_t *shard = &tree->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        for (size_t i = 0; i < count; i++) {
+            ttak_mem_node_t *node = nodes[i];
+            if (!node || node->shard != s) continue;
+            nodes[i] = NULL; // Later shards must not read a freed node
+            if (node->tree != tree) continue;
+            mem_tree_shard_unlink(shard, node);
+            pthread_mutex_destroy(&node->lock);
+            free(node);
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
 
-    pthread_mutex_destroy(&node->lock);
-    free(node); // Free the mem node itself
+/**
+ * @brief Updates the size and expiry of a block resized in place.
+ *
+ * The node keeps its shard and index slot. If the expiry changed, it is
+ * moved to the timer slot of the new expiry.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param node Node of the block.
+ * @param size New size of the block.
+ * @param expires_tick New expiry of the block.
+ */
+void ttak_mem_tree_resize(ttak_mem_tree_t *tree, ttak_mem_node_t *node, size_t size, uint64_t expires_tick) {
+    if (!tree || !node) return;
+
+    ttak_mem_tree_shard_t *shard = &tree->shards[node->shard];
+    pthread_mutex_lock(&shard->lock);
+    if (node->tree == tree) {
+        node->size = size;
+        if (node->expires_tick != expires_tick) {
+            timer_unlink(node);
+            node->expires_tick = expires_tick;
+            timer_schedule(shard, node);
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
 }
 
 /**
@@ -190,6 +516,7 @@ void ttak_mem_node_release(ttak_mem_node_t *node) {
  *
  * The cleanup thread uses an adaptive interval based on memory pressure.
  * It will back off towards the max interval if no garbage is detected.
+ * The thread is woken so the new intervals apply to its current wait.
  *
  * @param tree Pointer to the mem tree.
  * @param min_ns The minimum cleanup interval in nanoseconds (e.g., 10s).
@@ -199,6 +526,11 @@ void ttak_mem_tree_set_cleaning_intervals(ttak_mem_tree_t *tree, uint64_t min_ns
     if (!tree) return;
     atomic_store(&tree->min_cleanup_interval_ns, min_ns);
     atomic_store(&tree->max_cleanup_interval_ns, max_ns);
+
+    // Cut short a wait computed from the old intervals.
+    pthread_mutex_lock(&tree->lock);
+    pthread_cond_signal(&tree->cond);
+    pthread_mutex_unlock(&tree->lock);
 }
 
 /**
@@ -247,69 +579,78 @@ void ttak_mem_tree_set_manual_cleanup(ttak_mem_tree_t *tree, _Bool manual_cleanu
 }
 
 /**
- * @brief Performs a manual cleanup pass, freeing expired and unreferenced memory blocks.
+ * @brief Examine one timer list of a locked shard and detach the nodes that can be freed.
  *
- * This function iterates through all tracked mem nodes. If a node's reference count
- * is zero and its expiration time has passed (or it's marked for immediate cleanup),
- * its associated memory is freed, and the node is removed from the tree.
- *
- * @param tree Pointer to the mem tree.
- * @param now Current monotonic tick.
+ * Freeable nodes (unreferenced, expired by @p now and claimed with
+ * ttak_mem_try_claim) are fully unlinked and appended to the caller's free
+ * chain. Unreferenced nodes that cannot be claimed yet (not expired by the
+ * clock of this pass, or pinned) stay due for the next pass; everything
+ * else is moved to the shard's parked list.
  */
-void ttak_mem_tree_perform_cleanup(ttak_mem_tree_t *tree, uint64_t now) {
-    if (!tree) return;
+static void collect_timer_list(ttak_mem_tree_shard_t *shard, ttak_mem_node_t **list, uint64_t now,
+                               ttak_mem_node_t **to_free_head, ttak_mem_node_t **to_free_tail) {
+    ttak_mem_node_t *pending = NULL;
+    timer_take_list(list, &pending);
+
+    while (pending) {
+        ttak_mem_node_t *node = pending;
+        pending = node->timer_next;
+        node->timer_next = NULL;
+
+        _Bool owned = atomic_load(&node->ref_count) == 0 && node->expires_tick != __TTAK_UNSAFE_MEM_FOREVER__;
+        // The claim sets the block's freed bit; a block already being freed
+        // by its owner, or pinned by a reader, stays linked for them.
+        if (owned && now >= node->expires_tick && (!node->ptr || ttak_mem_try_claim(node->ptr))) {
+            mem_tree_shard_unlink(shard, node);
+            node->tree = NULL; // Owned by this pass from now on
 
-    // Check pressure first (Early Return)
-    if (atomic_load(&tree->garbage_pressure) == 0 && !atomic_load(&tree->use_manual_cleanup)) {
-        return;
+            // Add to temporary free list
+            if (!*to_free_head) {
+                *to_free_head = node;
+            } else {
+                (*to_free_tail)->next = node;
+            }
+            *to_free_tail = node;
+        } else if (owned) {
+            // A scan at a later tick fired the timer early, or a reader
+            // holds a pin; parking it would wait for pressure.
+            timer_link(&shard->due, node);
+        } else {
+            timer_link(&shard->parked, node);
+        }
     }
+}
 
-    pthread_mutex_lock(&tree->lock);
-    ttak_mem_node_t **indirect = &tree->head;
+/**
+ * @brief Collect and free every due, unreferenced node.
+ *
+ * @return Total size of the blocks that were freed.
+ */
+static size_t mem_tree_collect(ttak_mem_tree_t *tree, uint64_t now, _Bool scan_parked) {
     ttak_mem_node_t *to_free_head = NULL;
     ttak_mem_node_t *to_free_tail = NULL;
 
-    while (*indirect) {
-        ttak_mem_node_t *node = *indirect;
-        pthread_mutex_lock(&node->lock); // Lock node before checking its state
-
-        _Bool should_free = false;
-        if (atomic_load(&node->ref_count) == 0 && node->expires_tick != __TTAK_UNSAFE_MEM_FOREVER__ && now >= node->expires_tick) {
-            should_free = true;
+    for (size_t i = 0; i < TTAK_MEM_TREE_SHARDS; i++) {
+        ttak_mem_tree_shard_t *shard = &tree->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        timer_advance(shard, now);
+        if (scan_parked && shard->parked) {
+            collect_timer_list(shard, &shard->parked, now, &to_free_head, &to_free_tail);
         }
-
-        pthread_mutex_unlock(&node->lock); // Unlock node
-
-        if (should_free) {
-            *indirect = node->next; // Remove from main list
-            if (node->next) {
-                node->next->prev = node->prev;
-            }
-            
-            // Add to temporary free list
-            node->next = NULL;
-            node->prev = NULL;
-            if (!to_free_head) {
-                to_free_head = node;
-                to_free_tail = node;
-            } else {
-                to_free_tail->next = node;
-                to_free_tail = node;
-            }
-        } else {
-            indirect = &(*indirect)->next;
+        if (shard->due) {
+            collect_timer_list(shard, &shard->due, now, &to_free_head, &to_free_tail);
         }
+        pthread_mutex_unlock(&shard->lock);
     }
-    pthread_mutex_unlock(&tree->lock);
 
-    // Free collected nodes outside the tree lock
+    // Free collected nodes outside the shard locks
     size_t total_freed = 0;
     ttak_mem_node_t *current = to_free_head;
     while (current) {
         ttak_mem_node_t *next = current->next;
         total_freed += current->size;
         if (current->ptr) {
-            ttak_mem_free(current->ptr);
+            ttak_mem_reap(current->ptr);
             current->ptr = NULL;
         }
         pthread_mutex_destroy(&current->lock);
@@ -325,13 +666,33 @@ void ttak_mem_tree_perform_cleanup(ttak_mem_tree_t *tree, uint64_t now) {
             atomic_store(&tree->garbage_pressure, 0);
         }
     }
+    return total_freed;
+}
+
+/**
+ * @brief Performs a manual cleanup pass, freeing expired and unreferenced memory blocks.
+ *
+ * This function advances each shard's timer wheel to @p now and only examines
+ * the nodes whose expiry has been reached. If a node's reference count is zero
+ * and its expiration time has passed, its associated memory is freed, and the
+ * node is removed from the tree. Referenced nodes are parked and revisited
+ * once pressure is reported (or on every manual pass).
+ *
+ * @param tree Pointer to the mem tree.
+ * @param now Current monotonic tick.
+ */
+void ttak_mem_tree_perform_cleanup(ttak_mem_tree_t *tree, uint64_t now) {
+    if (!tree) return;
+
+    _Bool scan_parked = atomic_load(&tree->garbage_pressure) > 0 || atomic_load(&tree->use_manual_cleanup);
+    mem_tree_collect(tree, now, scan_parked);
 }
 
 /**
  * @brief Background thread function for automatic memory cleanup.
  *
  * This thread periodically wakes up, checks if automatic cleanup is enabled,
- * and if so, performs a cleanup pass on the mem tree. It respects the configured
+ * and if so, advances the timer wheels and frees the nodes that came due. It respects the configured
  * cleanup interval and terminates when a shutdown request is received.
  *
  * @param arg A pointer to the ttak_mem_tree_t instance.
@@ -348,9 +709,10 @@ static void *cleanup_thread_func(void *arg) {
 
         if (!manual_cleanup_enabled) {
             size_t pressure = atomic_load(&tree->garbage_pressure);
-            
-            if (pressure > 0) {
-                ttak_mem_tree_perform_cleanup(tree, ttak_get_tick_count());
+
+            // Advancing the wheels is cheap; only fired timers are examined.
+            size_t freed = mem_tree_collect(tree, ttak_get_tick_count(), pressure > 0);
+            if (pressure > 0 || freed > 0) {
                 // Reset sleep interval to min after work is done
                 current_sleep_ns = atomic_load(&tree->min_cleanup_interval_ns);
             } else {
@@ -386,9 +748,9 @@ static void *cleanup_thread_func(void *arg) {
 /**
  * @brief Finds a mem node associated with a given memory pointer.
  *
- * This function traverses the mem tree's internal list to find the node
- * that tracks the specified memory pointer. It ensures thread-safe access
- * to the tree structure.
+ * This function hashes the pointer to its shard and walks the matching
+ * index bucket, so the cost does not depend on the number of live nodes.
+ * Only the owning shard is locked.
  *
  * @param tree Pointer to the mem tree.
  * @param ptr The memory pointer to search for.
@@ -397,15 +759,141 @@ static void *cleanup_thread_func(void *arg) {
 ttak_mem_node_t *ttak_mem_tree_find_node(ttak_mem_tree_t *tree, void *ptr) {
     if (!tree || !ptr) return NULL;
 
-    pthread_mutex_lock(&tree->lock);
-    ttak_mem_node_t *current = tree->head;
-    while (current) {
-        if (current->ptr == ptr) {
-            pthread_mutex_unlock(&tree->lock);
-            return current;
+    uint64_t h = mem_tree_hash(ptr);
+    ttak_mem_tree_shard_t *shard = &tree->shards[h & (TTAK_MEM_TREE_SHARDS - 1)];
+
+    pthread_mutex_lock(&shard->lock);
+    ttak_mem_node_t *current = NULL;
+    if (shard->buckets) {
+        current = shard->buckets[mem_tree_bucket(h, shard->bucket_count)];
+        while (current && current->ptr != ptr) {
+            current = current->hash_next;
         }
-        current = current->next;
     }
-    pthread_mutex_unlock(&tree->lock);
-    return NULL;
+    pthread_mutex_unlock(&shard->lock);
+    return current;
+}
+
+/**
+ * @brief Visits every tracked node, one shard at a time.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param visit Callback invoked for each node with its shard locked.
+ * @param arg User argument forwarded to the callback.
+ */
+void ttak_mem_tree_for_each(ttak_mem_tree_t *tree, ttak_mem_tree_visit_t visit, void *arg) {
+    if (!tree || !visit) return;
+
+    for (size_t i = 0; i < TTAK_MEM_TREE_SHARDS; i++) {
+        ttak_mem_tree_shard_t *shard = &tree->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        for (ttak_mem_node_t *n = shard->head; n; n = n->next) {
+            visit(n, arg);
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+/**
+ * @brief Advances the timer wheels to @p now and visits every due or parked node.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param now Current monotonic tick.
+ * @param visit Callback invoked for each due node with its shard locked.
+ * @param arg User argument forwarded to the callback.
+ */
+void ttak_mem_tree_for_each_due(ttak_mem_tree_t *tree, uint64_t now, ttak_mem_tree_visit_t visit, void *arg) {
+    if (!tree || !visit) return;
+
+    for (size_t i = 0; i < TTAK_MEM_TREE_SHARDS; i++) {
+        ttak_mem_tree_shard_t *shard = &tree->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        timer_advance(shard, now);
+        for (ttak_mem_node_t *n = shard->due; n; n = n->timer_next) {
+            visit(n, arg);
+        }
+        for (ttak_mem_node_t *n = shard->parked; n; n = n->timer_next) {
+            visit(n, arg);
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+/**
+ * @brief Visits a bounded slice of one shard's due and parked nodes.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param cursor Sweep position, updated in place.
+ * @param now Current monotonic tick.
+ * @param max_nodes Upper bound on visited nodes.
+ * @param visit Callback invoked for each node with its shard locked.
+ * @param arg User argument forwarded to the callback.
+ * @return Number of nodes visited.
+ */
+size_t ttak_mem_tree_sweep_due(ttak_mem_tree_t *tree, ttak_mem_tree_cursor_t *cursor, uint64_t now, size_t max_nodes,
+                               ttak_mem_tree_visit_t visit, void *arg) {
+    if (!tree || !cursor || !visit || max_nodes == 0) return 0;
+
+    cursor->shard &= TTAK_MEM_TREE_SHARDS - 1;
+    ttak_mem_tree_shard_t *shard = &tree->shards[cursor->shard];
+    pthread_mutex_lock(&shard->lock);
+    if (cursor->offset == 0) {
+        timer_advance(shard, now);
+    }
+
+    // Due nodes come first, then parked ones; skip what earlier calls covered.
+    ttak_mem_node_t *n = shard->due;
+    _Bool in_due = true;
+    size_t skipped = 0;
+    while (skipped < cursor->offset) {
+        if (!n && in_due) {
+            n = shard->parked;
+            in_due = false;
+            continue;
+        }
+        if (!n) break;
+        n = n->timer_next;
+        skipped++;
+    }
+
+    size_t visited = 0;
+    while (visited < max_nodes) {
+        if (!n && in_due) {
+            n = shard->parked;
+            in_due = false;
+            continue;
+        }
+        if (!n) break;
+        ttak_mem_node_t *next = n->timer_next;
+        visit(n, arg);
+        visited++;
+        n = next;
+    }
+
+    if (!n && (!in_due || !shard->parked)) {
+        cursor->shard = (cursor->shard + 1) & (TTAK_MEM_TREE_SHARDS - 1);
+        cursor->offset = 0;
+    } else {
+        cursor->offset = skipped + visited;
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return visited;
+}
+
+/**
+ * @brief Moves a node onto its shard's due list ahead of its expiry.
+ *
+ * @param tree Pointer to the mem tree.
+ * @param node Pointer to the mem node.
+ */
+void ttak_mem_tree_mark_due(ttak_mem_tree_t *tree, ttak_mem_node_t *node) {
+    if (!tree || !node) return;
+
+    ttak_mem_tree_shard_t *shard = &tree->shards[node->shard];
+    pthread_mutex_lock(&shard->lock);
+    if (node->tree == tree) {
+        timer_unlink(node);
+        timer_link(&shard->due, node);
+    }
+    pthread_mutex_unlock(&shard->lock);
 }
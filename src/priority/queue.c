@@ -46,6 +46,7 @@ static ttak_task_t *q_pop(struct __internal_ttak_proc_priority_queue_t *q, uint6
     ttak_task_t *task = node->task;
     q->head = node->next;
     q->size--;
+    ttak_mem_unpin(node);
     ttak_mem_free(node);
     return task;
 }
@@ -1,25 +1,36 @@
 #include <ttak/priority/scheduler.h>
 #include <ttak/mem/mem.h>
-#include <ttak/ht/map.h>
+#include <ttak/ht/concurrent_map.h>
 #include <ttak/timing/timing.h>
 #include <ttak/priority/nice.h>
 #include <pthread.h>
 #include <stddef.h>
 
-static tt_map_t *history_map = NULL;
+// Workers record and query runtimes concurrently; lookups take no lock and
+// updates only lock the shard that holds the task's hash.
+static ttak_concurrent_map_t *_Atomic history_map = NULL;
 static pthread_mutex_t history_lock = PTHREAD_MUTEX_INITIALIZER;
-static _Bool history_initialized = 0;
 
 void ttak_scheduler_init(void) {
     pthread_mutex_lock(&history_lock);
-    if (!history_initialized) {
-        // Initial capacity 128, current time for allocation
-        history_map = ttak_create_map(128, ttak_get_tick_count());
-        history_initialized = 1;
+    if (!atomic_load_explicit(&history_map, memory_order_relaxed)) {
+        // Initial capacity 128, one shard per CPU, current time for allocation
+        atomic_store_explicit(&history_map, ttak_concurrent_map_create(0, 128, ttak_get_tick_count()),
+                              memory_order_release);
     }
     pthread_mutex_unlock(&history_lock);
 }
 
+/**
+ * @brief Fold one runtime sample into a task's average.
+ */
+static size_t history_update(size_t old_avg, _Bool found, void *arg) {
+    uint64_t duration_ms = *(const uint64_t *)arg;
+    if (!found) return (size_t)duration_ms;
+    // EMA: New = Old * 0.7 + Current * 0.3
+    return (size_t)((old_avg * 0.7) + (duration_ms * 0.3));
+}
+
 void ttak_scheduler_record_execution(ttak_task_t *task, uint64_t duration_ms) {
     if (!task) return;
     
@@ -28,18 +39,17 @@ void ttak_scheduler_record_execution(ttak_task_t *task, uint64_t duration_ms) {
 
     uint64_t now = ttak_get_tick_count();
     
-    pthread_mutex_lock(&history_lock);
-    if (history_map) {
-        size_t old_avg = 0;
-        if (ttak_map_get_key(history_map, (uintptr_t)hash, &old_avg, now)) {
-            // EMA: New = Old * 0.7 + Current * 0.3
-            size_t new_avg = (size_t)((old_avg * 0.7) + (duration_ms * 0.3));
-            ttak_insert_to_map(history_map, (uintptr_t)hash, new_avg, now);
-        } else {
-            ttak_insert_to_map(history_map, (uintptr_t)hash, (size_t)duration_ms, now);
-        }
+    ttak_concurrent_map_t *history = atomic_load_explicit(&history_map, memory_order_acquire);
+    if (history) {
+        ttak_concurrent_map_compute(history, (uintptr_t)hash, history_update, &duration_ms, NULL, now);
+    }
+}
+
+void ttak_scheduler_unregister_thread(void) {
+    ttak_concurrent_map_t *history = atomic_load_explicit(&history_map, memory_order_acquire);
+    if (history) {
+        ttak_concurrent_map_unregister_thread(history);
     }
-    pthread_mutex_unlock(&history_lock);
 }
 
 int ttak_scheduler_get_adjusted_priority(ttak_task_t *task, int base_priority) {
@@ -49,15 +59,13 @@ int ttak_scheduler_get_adjusted_priority(ttak_task_t *task, int base_priority) {
     if (hash == 0) return base_priority;
 
     int adj_priority = base_priority;
-    uint64_t now = ttak_get_tick_count();
     size_t avg_runtime = 0;
     _Bool found = 0;
 
-    pthread_mutex_lock(&history_lock);
-    if (history_map) {
-        found = ttak_map_get_key(history_map, (uintptr_t)hash, &avg_runtime, now);
+    ttak_concurrent_map_t *history = atomic_load_explicit(&history_map, memory_order_acquire);
+    if (history) {
+        found = ttak_concurrent_map_get(history, (uintptr_t)hash, &avg_runtime);
     }
-    pthread_mutex_unlock(&history_lock);
 
     if (found) {
         if (avg_runtime < 10) { 
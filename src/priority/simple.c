@@ -35,6 +35,7 @@ void ttak_simple_queue_push(ttak_simple_queue_t *q, void *data, uint64_t now) {
         // Access tail to be safe, though we just own it.
         if (ttak_mem_access(q->tail, now)) {
             q->tail->next = node;
+            ttak_mem_unpin(q->tail);
         } else {
             // Tail is invalid? This should not happen if we own the queue.
             // But if it does, we recover by resetting or just appending.
@@ -74,6 +75,7 @@ void *ttak_simple_queue_pop(ttak_simple_queue_t *q, uint64_t now) {
     }
     q->size--;
 
+    ttak_mem_unpin(node);
     ttak_mem_free(node);
     return data;
 }
@@ -106,9 +108,23 @@ size_t ttak_simple_queue_size(const ttak_simple_queue_t *q) {
  */
 void ttak_simple_queue_destroy(ttak_simple_queue_t *q, uint64_t now) {
     if (!q) return;
+    // Nodes are unlinked from the registry a batch at a time.
+    void *batch[64];
+    size_t n = 0;
     while (q->head) {
-        ttak_simple_queue_pop(q, now);
+        ttak_simple_node_t *node = q->head;
+        if (!ttak_mem_access(node, now)) break;
+        q->head = node->next;
+        q->size--;
+        ttak_mem_unpin(node);
+        batch[n++] = node;
+        if (n == sizeof(batch) / sizeof(batch[0])) {
+            ttak_mem_free_batch(batch, n);
+            n = 0;
+        }
     }
+    ttak_mem_free_batch(batch, n);
+    if (!q->head) q->tail = NULL;
 }
 
 /* Stack Implementation */
@@ -161,6 +177,7 @@ void *ttak_simple_stack_pop(ttak_simple_stack_t *s, uint64_t now) {
     s->top = node->next;
     s->size--;
 
+    ttak_mem_unpin(node);
     ttak_mem_free(node);
     return data;
 }
@@ -193,7 +210,19 @@ size_t ttak_simple_stack_size(const ttak_simple_stack_t *s) {
  */
 void ttak_simple_stack_destroy(ttak_simple_stack_t *s, uint64_t now) {
     if (!s) return;
+    void *batch[64];
+    size_t n = 0;
     while (s->top) {
-        ttak_simple_stack_pop(s, now);
+        ttak_simple_node_t *node = s->top;
+        if (!ttak_mem_access(node, now)) break;
+        s->top = node->next;
+        s->size--;
+        ttak_mem_unpin(node);
+        batch[n++] = node;
+        if (n == sizeof(batch) / sizeof(batch[0])) {
+            ttak_mem_free_batch(batch, n);
+            n = 0;
+        }
     }
+    ttak_mem_free_batch(batch, n);
 }
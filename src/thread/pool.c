@@ -9,6 +9,12 @@
 
 #include <ttak/priority/scheduler.h>
 
+/**
+ * @brief Per-step budget of the dirty-pointer sweeper run alongside a pool.
+ */
+#define TTAK_POOL_SWEEP_NODES 256
+#define TTAK_POOL_SWEEP_NS    (100 * 1000ULL)
+
 /**
  * @brief Stop all workers and signal shutdown.
  *
@@ -53,18 +59,42 @@ ttak_thread_pool_t *ttak_thread_pool_create(size_t num_threads, int default_nice
 
     pool->workers = (ttak_worker_t **)ttak_mem_alloc(sizeof(ttak_worker_t *) * num_threads, __TTAK_UNSAFE_MEM_FOREVER__, now);
 
+    // Every worker and its wrapper are allocated and registered in one batch.
+    size_t block_count = num_threads * 2;
+    size_t *sizes = malloc(sizeof(size_t) * block_count);
+    void **blocks = malloc(sizeof(void *) * block_count);
+    bool ok = pool->workers && sizes && blocks;
+    for (size_t i = 0; ok && i < num_threads; i++) {
+        sizes[2 * i] = sizeof(ttak_worker_t);
+        sizes[2 * i + 1] = sizeof(ttak_worker_wrapper_t);
+    }
+    if (ok) ok = ttak_mem_alloc_batch(blocks, sizes, block_count, __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT);
+    free(sizes);
+    if (!ok) {
+        free(blocks);
+        ttak_mem_free(pool->workers);
+        pthread_mutex_destroy(&pool->pool_lock);
+        pthread_cond_destroy(&pool->task_cond);
+        ttak_mem_free(pool);
+        return NULL;
+    }
+
     for (size_t i = 0; i < num_threads; i++) {
-        pool->workers[i] = (ttak_worker_t *)ttak_mem_alloc(sizeof(ttak_worker_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        pool->workers[i] = (ttak_worker_t *)blocks[2 * i];
         pool->workers[i]->pool = pool;
         pool->workers[i]->should_stop = false;
         pool->workers[i]->exit_code = 0;
         
-        pool->workers[i]->wrapper = (ttak_worker_wrapper_t *)ttak_mem_alloc(sizeof(ttak_worker_wrapper_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        pool->workers[i]->wrapper = (ttak_worker_wrapper_t *)blocks[2 * i + 1];
         pool->workers[i]->wrapper->nice_val = default_nice;
         pool->workers[i]->wrapper->ts = now;
 
         pthread_create(&pool->workers[i]->thread, NULL, ttak_worker_routine, pool->workers[i]);
     }
+    free(blocks);
+
+    // Reclaim dirty pointers off the dispatch path, a bounded slice at a time.
+    pool->sweeping = ttak_mem_sweeper_start(0, TTAK_POOL_SWEEP_NODES, TTAK_POOL_SWEEP_NS);
 
     return pool;
 }
@@ -87,8 +117,8 @@ ttak_future_t *ttak_thread_pool_submit_task(ttak_thread_pool_t *pool, void *(*fu
 
     ttak_task_t *task = ttak_task_create((ttak_task_func_t)func, arg, promise, now);
     if (!task) {
-        ttak_mem_free(promise->future);
-        ttak_mem_free(promise); // destroys promise here.
+        void *blocks[2] = { promise->future, promise };
+        ttak_mem_free_batch(blocks, 2); // destroys promise here.
         return NULL; 
     }
 
@@ -97,8 +127,8 @@ ttak_future_t *ttak_thread_pool_submit_task(ttak_thread_pool_t *pool, void *(*fu
 
     if (!ttak_thread_pool_schedule_task(pool, task, adjusted_priority, now)) {
         ttak_task_destroy(task, now);
-        ttak_mem_free(promise->future);
-        ttak_mem_free(promise);
+        void *blocks[2] = { promise->future, promise };
+        ttak_mem_free_batch(blocks, 2);
         return NULL;
     }
 
@@ -139,14 +169,30 @@ void ttak_thread_pool_destroy(ttak_thread_pool_t *pool) {
     if (!pool) return;
 
     pool_force_shutdown(pool);
+    if (pool->sweeping) {
+        ttak_mem_sweeper_stop();
+        pool->sweeping = false;
+    }
 
+    void **blocks = malloc(sizeof(void *) * (pool->num_threads * 2 + 1));
     for (size_t i = 0; i < pool->num_threads; i++) {
         pthread_join(pool->workers[i]->thread, NULL);
-        ttak_mem_free(pool->workers[i]->wrapper);
-        ttak_mem_free(pool->workers[i]);
+        if (blocks) {
+            blocks[2 * i] = pool->workers[i]->wrapper;
+            blocks[2 * i + 1] = pool->workers[i];
+        } else {
+            ttak_mem_free(pool->workers[i]->wrapper);
+            ttak_mem_free(pool->workers[i]);
+        }
     }
 
-    ttak_mem_free(pool->workers);
+    if (blocks) {
+        blocks[pool->num_threads * 2] = pool->workers;
+        ttak_mem_free_batch(blocks, pool->num_threads * 2 + 1);
+        free(blocks);
+    } else {
+        ttak_mem_free(pool->workers);
+    }
     pthread_mutex_destroy(&pool->pool_lock);
     pthread_cond_destroy(&pool->task_cond);
     
@@ -8,21 +8,14 @@
 #include <stdlib.h>
 
 /**
- * @brief Threaded function wrapper that validates memory every tick.
+ * @brief Threaded function wrapper that runs a task and records its duration.
+ *
+ * Dirty pointers are reclaimed by the pool's budgeted background sweeper, so
+ * dispatch latency does not depend on heap size.
  */
 static void threaded_function_wrapper(ttak_worker_t *worker, ttak_task_t *task) {
     (void)worker;
     uint64_t now = ttak_get_tick_count();
-    
-    // Validate all tracked pointers for this task (demonstration)
-    size_t count = 0;
-    void **dirty = tt_inspect_dirty_pointers(now, &count);
-    if (dirty) {
-        // If critical memory for task is dirty, we might need to longjmp
-        // For now, autoclean
-        tt_autoclean_dirty_pointers(now);
-        free(dirty);
-    }
 
     if (task) {
         uint64_t start_time = ttak_get_tick_count();
@@ -77,5 +70,7 @@ void *ttak_worker_routine(void *arg) {
         }
     }
 
+    // Workers come and go with their pool; leave nothing bound to this thread.
+    ttak_scheduler_unregister_thread();
     return (void *)(uintptr_t)self->exit_code;
 }
@@ -87,6 +87,7 @@ static void recursive_destroy_node(ttak_ast_node_t *node, void (*free_value)(voi
             free_value(node->value);
         }
         
+        ttak_mem_unpin(node);
         ttak_mem_free(node);
     }
 }
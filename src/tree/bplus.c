@@ -14,26 +14,32 @@
  * @return Pointer to the node or NULL on failure.
  */
 static ttak_bplus_node_t *create_node(int order, bool leaf, uint64_t now) {
-    ttak_bplus_node_t *node = (ttak_bplus_node_t *)ttak_mem_alloc(sizeof(ttak_bplus_node_t), __TTAK_UNSAFE_MEM_FOREVER__, now);
-    if (!node) return NULL;
-    
+    // Allocate max size (order is max children, so max keys = order-1, but we allow order for overflow handling before split)
+    // Actually safe implementation allocates order+1 slots to simplify "insert then split".
+    size_t cap = (size_t)order + 1;
+    size_t sizes[3] = {
+        sizeof(ttak_bplus_node_t),
+        sizeof(void *) * cap,
+        leaf ? sizeof(void *) * cap : sizeof(struct ttak_bplus_node *) * (cap + 1)
+    };
+    void *blocks[3];
+    // Node, keys and values/children are registered together.
+    if (!ttak_mem_alloc_batch(blocks, sizes, 3, __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT)) return NULL;
+
+    ttak_bplus_node_t *node = (ttak_bplus_node_t *)blocks[0];
     node->is_leaf = leaf;
     node->n = 0;
     node->next = NULL;
-    
-    // Allocate max size (order is max children, so max keys = order-1, but we allow order for overflow handling before split)
-    // Actually safe implementation allocates order+1 slots to simplify "insert then split".
-    int cap = order + 1;
-    node->keys = (void **)ttak_mem_alloc(sizeof(void *) * cap, __TTAK_UNSAFE_MEM_FOREVER__, now);
-    
+    node->keys = (void **)blocks[1];
+
     if (leaf) {
-        node->values = (void **)ttak_mem_alloc(sizeof(void *) * cap, __TTAK_UNSAFE_MEM_FOREVER__, now);
+        node->values = (void **)blocks[2];
         node->children = NULL;
     } else {
-        node->children = (struct ttak_bplus_node **)ttak_mem_alloc(sizeof(struct ttak_bplus_node *) * (cap + 1), __TTAK_UNSAFE_MEM_FOREVER__, now);
+        node->children = (struct ttak_bplus_node **)blocks[2];
         node->values = NULL;
     }
-    
+
     return node;
 }
 
@@ -73,16 +79,21 @@ void *ttak_bplus_get(ttak_bplus_tree_t *tree, const void *key, uint64_t now) {
         while (i < c->n && tree->cmp(key, c->keys[i]) >= 0) {
             i++;
         }
-        c = c->children[i];
+        ttak_bplus_node_t *child = c->children[i];
+        ttak_mem_unpin(c);
+        c = child;
     }
     
     if (!ttak_mem_access(c, now)) return NULL;
+    void *value = NULL;
     for (int i = 0; i < c->n; i++) {
         if (tree->cmp(key, c->keys[i]) == 0) {
-            return c->values[i];
+            value = c->values[i];
+            break;
         }
     }
-    return NULL;
+    ttak_mem_unpin(c);
+    return value;
 }
 
 /**
@@ -241,14 +252,10 @@ static void recursive_destroy(ttak_bplus_node_t *node, void (*kf)(void*), void (
         for (int i = 0; i <= node->n; i++) {
             recursive_destroy(node->children[i], kf, vf, now);
         }
-        ttak_mem_free(node->children);
-    } else {
-        if (vf) {
-            for (int i = 0; i < node->n; i++) {
-                 vf(node->values[i]);
-            }
+    } else if (vf) {
+        for (int i = 0; i < node->n; i++) {
+             vf(node->values[i]);
         }
-        ttak_mem_free(node->values);
     }
     
     if (kf) {
@@ -256,8 +263,8 @@ static void recursive_destroy(ttak_bplus_node_t *node, void (*kf)(void*), void (
             kf(node->keys[i]);
         }
     }
-    ttak_mem_free(node->keys);
-    ttak_mem_free(node);
+    void *blocks[3] = { node->is_leaf ? (void *)node->values : (void *)node->children, node->keys, node };
+    ttak_mem_free_batch(blocks, 3);
 }
 
 /**
@@ -181,13 +181,18 @@ static void *search_recursive(ttak_btree_t *tree, ttak_btree_node_t *x, const vo
         i++;
     }
     
+    void *value = NULL;
+    ttak_btree_node_t *child = NULL;
     if (i < x->n && tree->cmp(k, x->keys[i]) == 0) {
-        return x->values[i];
+        value = x->values[i];
+    } else if (!x->leaf) {
+        child = x->children[i];
     }
+    ttak_mem_unpin(x);
     
-    if (x->leaf) return NULL;
+    if (!child) return value;
     
-    return search_recursive(tree, x->children[i], k, now);
+    return search_recursive(tree, child, k, now);
 }
 
 /**
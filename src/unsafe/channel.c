@@ -0,0 +1,93 @@
+#include <ttak/unsafe/channel.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool channel_can_deliver(const ttak_region_channel_t *ch, const ttak_unsafe_region_t *dst) {
+    if (!dst || dst->pin_count != 0 || dst->ctx_id != ch->recv_ctx) return false;
+    return dst->ptr == NULL && dst->size == 0;
+}
+
+bool ttak_region_channel_init(ttak_region_channel_t *ch, size_t capacity,
+                              uint32_t send_ctx, const char *send_tag,
+                              uint32_t recv_ctx, const char *recv_tag) {
+    if (!ch) return false;
+    size_t slots = 2;
+    while (slots < capacity) {
+        if (slots > SIZE_MAX / 2 / sizeof(ttak_unsafe_region_t)) return false;
+        slots <<= 1;
+    }
+
+    memset(ch, 0, sizeof(*ch));
+    ch->slots = calloc(slots, sizeof(ttak_unsafe_region_t));
+    if (!ch->slots) return false;
+    ch->mask = slots - 1;
+    ch->send_ctx = send_ctx;
+    ch->recv_ctx = recv_ctx;
+    ch->send_tag = send_tag ? send_tag : __TTAK_REGION_CANONICAL_ALLOC__;
+    ch->recv_tag = recv_tag ? recv_tag : __TTAK_REGION_CANONICAL_ALLOC__;
+    atomic_init(&ch->head, 0);
+    atomic_init(&ch->tail, 0);
+    return true;
+}
+
+void ttak_region_channel_destroy(ttak_region_channel_t *ch) {
+    if (!ch) return;
+    free(ch->slots);
+    memset(ch, 0, sizeof(*ch));
+}
+
+bool ttak_region_channel_send(ttak_region_channel_t *ch, ttak_unsafe_region_t *src) {
+    if (!ch || !ch->slots || ttak_unsafe_region_is_empty(src)) return false;
+    size_t tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    if (tail - ch->head_cache > ch->mask) {
+        ch->head_cache = atomic_load_explicit(&ch->head, memory_order_acquire);
+        if (tail - ch->head_cache > ch->mask) return false;
+    }
+
+    // The slot is bound to the sending side, so the move itself checks pin, ctx and tag.
+    ttak_unsafe_region_t *slot = &ch->slots[tail & ch->mask];
+    ttak_unsafe_region_init(slot, ch->send_ctx, ch->send_tag);
+    if (!ttak_unsafe_region_move(slot, src)) return false;
+    atomic_store_explicit(&ch->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Number of regions the consumer can take without another look at tail.
+ */
+static size_t channel_ready(ttak_region_channel_t *ch, size_t head, size_t want) {
+    size_t ready = ch->tail_cache - head;
+    if (ready < want) {
+        ch->tail_cache = atomic_load_explicit(&ch->tail, memory_order_acquire);
+        ready = ch->tail_cache - head;
+    }
+    return ready < want ? ready : want;
+}
+
+bool ttak_region_channel_recv(ttak_region_channel_t *ch, ttak_unsafe_region_t *dst) {
+    return ttak_region_channel_recv_batch(ch, dst, 1) == 1;
+}
+
+size_t ttak_region_channel_recv_batch(ttak_region_channel_t *ch, ttak_unsafe_region_t *dst, size_t max) {
+    if (!ch || !ch->slots || !dst || max == 0) return 0;
+    size_t head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+    size_t ready = channel_ready(ch, head, max);
+
+    size_t taken = 0;
+    while (taken < ready && channel_can_deliver(ch, &dst[taken])) {
+        ttak_unsafe_region_t *slot = &ch->slots[(head + taken) & ch->mask];
+        if (!ttak_unsafe_region_move_cross_ctx(&dst[taken], slot, ch->recv_ctx, ch->recv_tag)) break;
+        taken++;
+    }
+    if (taken) {
+        atomic_store_explicit(&ch->head, head + taken, memory_order_release);
+    }
+    return taken;
+}
+
+size_t ttak_region_channel_count(ttak_region_channel_t *ch) {
+    if (!ch) return 0;
+    size_t tail = atomic_load_explicit(&ch->tail, memory_order_acquire);
+    size_t head = atomic_load_explicit(&ch->head, memory_order_acquire);
+    return tail - head;
+}
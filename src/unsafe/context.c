@@ -19,8 +19,8 @@ bool ttak_context_init(ttak_context_t *ctx,
     ctx->shared_mem = shared_mem;
     ctx->shared_size = shared_size;
     ctx->ownership_side = (inherit_side == __TTAK_CTX_USE_SECOND__) ? __TTAK_CTX_USE_SECOND__ : __TTAK_CTX_USE_FIRST__;
-    ctx->last_request = ctx->ownership_side;
-    if (ttak_mutex_init(&ctx->bridge_lock) != 0) return false;
+    atomic_init(&ctx->last_request, ctx->ownership_side);
+    if (ttak_rwlock_init(&ctx->bridge_lock) != 0) return false;
     ctx->initialized = true;
     return true;
 }
@@ -28,27 +28,85 @@ bool ttak_context_init(ttak_context_t *ctx,
 void ttak_context_destroy(ttak_context_t *ctx) {
     if (!ctx) return;
     if (ctx->initialized) {
-        ttak_mutex_destroy(&ctx->bridge_lock);
+        ttak_rwlock_destroy(&ctx->bridge_lock);
     }
     memset(ctx, 0, sizeof(*ctx));
 }
 
+/**
+ * @brief Pins the active side and locks its owner for @p access.
+ *
+ * @return false if bridge_lock could not be taken. Otherwise bridge_lock is
+ *         held shared and @p owner_out holds the locked owner (NULL if none).
+ */
+static bool ttak_context_enter(ttak_context_t *ctx, ttak_context_inherit_t side,
+                               ttak_context_access_t access, ttak_owner_t **owner_out) {
+    if (ttak_rwlock_rdlock(&ctx->bridge_lock) != 0) return false;
+    atomic_store_explicit(&ctx->last_request,
+                          (side == __TTAK_CTX_USE_SECOND__) ? __TTAK_CTX_USE_SECOND__ : __TTAK_CTX_USE_FIRST__,
+                          memory_order_relaxed);
+    ttak_owner_t *owner = ttak_context_pick_owner(ctx, ctx->ownership_side);
+    if (owner) {
+        if (access == TTAK_CONTEXT_WRITE) {
+            ttak_rwlock_wrlock(&owner->lock);
+        } else {
+            ttak_rwlock_rdlock(&owner->lock);
+        }
+    }
+    *owner_out = owner;
+    return true;
+}
+
+static void ttak_context_leave(ttak_context_t *ctx, ttak_owner_t *owner) {
+    if (owner) {
+        ttak_rwlock_unlock(&owner->lock);
+    }
+    ttak_rwlock_unlock(&ctx->bridge_lock);
+}
+
 bool ttak_context_run(ttak_context_t *ctx,
                       ttak_context_inherit_t side,
                       ttak_context_callback_t cb,
                       void *arg) {
+    return ttak_context_run_write(ctx, side, cb, arg);
+}
+
+bool ttak_context_run_write(ttak_context_t *ctx,
+                            ttak_context_inherit_t side,
+                            ttak_context_callback_t cb,
+                            void *arg) {
+    ttak_context_op_t op = { .cb = cb, .arg = arg };
+    return ttak_context_run_batch(ctx, side, TTAK_CONTEXT_WRITE, &op, 1);
+}
+
+bool ttak_context_run_read(ttak_context_t *ctx,
+                           ttak_context_inherit_t side,
+                           ttak_context_read_callback_t cb,
+                           void *arg) {
     if (!ctx || !cb || !ctx->initialized) return false;
-    if (ttak_mutex_lock(&ctx->bridge_lock) != 0) return false;
-    ctx->last_request = (side == __TTAK_CTX_USE_SECOND__) ? __TTAK_CTX_USE_SECOND__ : __TTAK_CTX_USE_FIRST__;
-    ttak_owner_t *owner = ttak_context_pick_owner(ctx, ctx->ownership_side);
-    if (owner) {
-        ttak_rwlock_wrlock(&owner->lock);
-    }
+    ttak_owner_t *owner;
+    if (!ttak_context_enter(ctx, side, TTAK_CONTEXT_READ, &owner)) return false;
     cb(ctx->shared_mem, ctx->shared_size, arg);
-    if (owner) {
-        ttak_rwlock_unlock(&owner->lock);
+    ttak_context_leave(ctx, owner);
+    return true;
+}
+
+bool ttak_context_run_batch(ttak_context_t *ctx,
+                            ttak_context_inherit_t side,
+                            ttak_context_access_t access,
+                            const ttak_context_op_t *ops,
+                            size_t count) {
+    if (!ctx || !ctx->initialized || (count && !ops)) return false;
+    for (size_t i = 0; i < count; i++) {
+        if (!ops[i].cb) return false;
+    }
+
+    ttak_owner_t *owner;
+    if (!ttak_context_enter(ctx, side, access, &owner)) return false;
+    for (size_t i = 0; i < count; i++) {
+        ops[i].cb(ctx->shared_mem, ctx->shared_size, ops[i].arg);
     }
-    ttak_mutex_unlock(&ctx->bridge_lock);
+    ttak_context_leave(ctx, owner);
     return true;
 }
 
@@ -58,9 +116,10 @@ ttak_owner_t *ttak_context_owner(const ttak_context_t *ctx, ttak_context_inherit
 
 bool ttak_context_reassign(ttak_context_t *ctx, ttak_context_inherit_t side) {
     if (!ctx || !ctx->initialized) return false;
-    if (ttak_mutex_lock(&ctx->bridge_lock) != 0) return false;
+    // Waits for every run on the old side to finish.
+    if (ttak_rwlock_wrlock(&ctx->bridge_lock) != 0) return false;
     ctx->ownership_side = (side == __TTAK_CTX_USE_SECOND__) ? __TTAK_CTX_USE_SECOND__ : __TTAK_CTX_USE_FIRST__;
-    ttak_mutex_unlock(&ctx->bridge_lock);
+    ttak_rwlock_unlock(&ctx->bridge_lock);
     return true;
 }
 
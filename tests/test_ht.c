@@ -1,4 +1,7 @@
 #include <ttak/ht/map.h>
+#include <ttak/ht/concurrent_map.h>
+#include <pthread.h>
+#include <stddef.h>
 #include "test_macros.h"
 
 void test_map_basic() {
@@ -17,7 +20,281 @@ void test_map_basic() {
     // For now, we assume it might be leaked or we need to find the destroy function.
 }
 
+#define MAP_KEYS 20000
+
+void test_map_group_probing() {
+    uint64_t now = 500;
+    tt_map_t *map = ttak_create_map(4, now);
+    ASSERT(map != NULL);
+    ASSERT(map->cap == TTAK_MAP_GROUP_WIDTH);
+
+    // Pointer-like keys share their low bits, which the hash must spread.
+    for (uintptr_t i = 1; i <= MAP_KEYS; i++) {
+        ttak_insert_to_map(map, i << 12, (size_t)i, now);
+    }
+    ASSERT(map->size == MAP_KEYS);
+    ASSERT(map->size <= map->cap - map->cap / 8);
+    size_t val = 0;
+    for (uintptr_t i = 1; i <= MAP_KEYS; i++) {
+        ASSERT(ttak_map_get_key(map, i << 12, &val, now) && val == (size_t)i);
+    }
+    ASSERT(!ttak_map_get_key(map, 0, &val, now));
+    ASSERT(!ttak_map_get_key(map, (uintptr_t)(MAP_KEYS + 1) << 12, NULL, now));
+
+    // Updates keep one entry per key.
+    ttak_insert_to_map(map, 5 << 12, 55, now);
+    ASSERT(map->size == MAP_KEYS);
+    ASSERT(ttak_map_get_key(map, 5 << 12, &val, now) && val == 55);
+
+    for (uintptr_t i = 2; i <= MAP_KEYS; i += 2) {
+        ttak_delete_from_map(map, i << 12, now);
+    }
+    ASSERT(map->size == MAP_KEYS / 2);
+    for (uintptr_t i = 1; i <= MAP_KEYS; i++) {
+        ASSERT(ttak_map_get_key(map, i << 12, NULL, now) == (i % 2 == 1));
+    }
+
+    // Churn on a steady working set reuses tombstones instead of growing.
+    size_t cap = map->cap;
+    for (int round = 0; round < 20; round++) {
+        for (uintptr_t i = 2; i <= MAP_KEYS; i += 2) {
+            ttak_insert_to_map(map, i << 12, (size_t)round, now);
+        }
+        for (uintptr_t i = 2; i <= MAP_KEYS; i += 2) {
+            ttak_delete_from_map(map, i << 12, now);
+        }
+    }
+    ASSERT(map->cap == cap);
+    ASSERT(map->size == MAP_KEYS / 2);
+    for (uintptr_t i = 1; i <= MAP_KEYS; i += 2) {
+        ASSERT(ttak_map_get_key(map, i << 12, NULL, now));
+    }
+    ttak_destroy_map(map);
+}
+
+void test_map_delete_and_shrink() {
+    uint64_t now = 500;
+    tt_map_t *map = ttak_create_map(16, now);
+    ASSERT(map != NULL);
+
+    // A group that never filled up takes its slots back as EMPTY.
+    size_t growth = map->growth_left;
+    for (uintptr_t i = 1; i <= 4; i++) ttak_insert_to_map(map, i << 12, (size_t)i, now);
+    for (uintptr_t i = 1; i <= 4; i++) ttak_delete_from_map(map, i << 12, now);
+    ASSERT(map->size == 0);
+    ASSERT(map->growth_left == growth);
+
+    for (uintptr_t i = 1; i <= MAP_KEYS; i++) {
+        ttak_insert_to_map(map, i << 12, (size_t)i, now);
+    }
+    size_t cap = map->cap;
+
+    // Deleting down to a sparse table starts a shrink that drains gradually.
+    uintptr_t i = MAP_KEYS;
+    while (!map->old_ctrl && i > 1) {
+        ttak_delete_from_map(map, i << 12, now);
+        i--;
+    }
+    ASSERT(map->old_ctrl != NULL);
+    ASSERT(map->cap == cap / 2);
+    ASSERT(map->old_next < map->old_cap);
+    size_t live = (size_t)i;
+    ASSERT(map->size == live);
+
+    // Lookups, updates and deletes see entries on both sides of the drain.
+    for (uintptr_t k = 1; k <= live; k++) {
+        size_t val = 0;
+        ASSERT(ttak_map_get_key(map, k << 12, &val, now) && val == (size_t)k);
+    }
+    ttak_insert_to_map(map, 1 << 12, 100, now);
+    ttak_delete_from_map(map, 2 << 12, now);
+    ttak_delete_from_map(map, (uintptr_t)live << 12, now);
+    ASSERT(map->size == live - 2);
+
+    // Churn finishes the drain and frees the old table.
+    for (size_t round = 0; round < cap / 2 && map->old_ctrl; round++) {
+        ttak_insert_to_map(map, (uintptr_t)(MAP_KEYS + 1) << 12, 0, now);
+        ttak_delete_from_map(map, (uintptr_t)(MAP_KEYS + 1) << 12, now);
+    }
+    ASSERT(map->old_ctrl == NULL);
+    ASSERT(map->size == live - 2);
+    size_t val = 0;
+    ASSERT(ttak_map_get_key(map, 1 << 12, &val, now) && val == 100);
+    ASSERT(!ttak_map_get_key(map, 2 << 12, NULL, now));
+    ASSERT(!ttak_map_get_key(map, (uintptr_t)live << 12, NULL, now));
+    for (uintptr_t k = 3; k < live; k++) {
+        ASSERT(ttak_map_get_key(map, k << 12, &val, now) && val == (size_t)k);
+    }
+    ttak_destroy_map(map);
+}
+
+void test_map_hash_policies() {
+    const ttak_hash_policy_t policies[] = {TTAK_HASH_SIPHASH, TTAK_HASH_MIX, TTAK_HASH_WYHASH};
+    uint64_t now = 500;
+    for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+        tt_map_t *map = ttak_create_map_with_hash(16, policies[p], now);
+        ASSERT(map != NULL);
+        ASSERT(map->hash_policy == policies[p]);
+        for (uintptr_t i = 1; i <= MAP_KEYS; i++) {
+            ttak_insert_to_map(map, i << 4, (size_t)i, now);
+        }
+        for (uintptr_t i = 1; i <= MAP_KEYS; i += 3) {
+            ttak_delete_from_map(map, i << 4, now);
+        }
+        for (uintptr_t i = 1; i <= MAP_KEYS; i++) {
+            size_t val = 0;
+            _Bool found = ttak_map_get_key(map, i << 4, &val, now);
+            ASSERT(found == ((i - 1) % 3 != 0));
+            ASSERT(!found || val == (size_t)i);
+        }
+        ttak_destroy_map(map);
+    }
+
+    // The process keys are drawn once and seed every map.
+    uint64_t k0, k1, again0, again1;
+    ttak_hash_process_keys(&k0, &k1);
+    ttak_hash_process_keys(&again0, &again1);
+    ASSERT(k0 == again0 && k1 == again1);
+    ASSERT(k0 != 0x0706050403020100ULL || k1 != 0x0f0e0d0c0b0a0908ULL);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // The word hash is the 8-byte case of the byte hash.
+    uint64_t word = 0x0123456789abcdefULL;
+    ASSERT(ttak_hash_wy(&word, sizeof(word), 7) == ttak_hash_wy_word(word, 7));
+#endif
+    ASSERT(ttak_hash_wy("libttak", 7, 0) != ttak_hash_wy("libttal", 7, 0));
+    ASSERT(ttak_hash_wy("", 0, 1) != ttak_hash_wy("", 0, 2));
+    ASSERT(ttak_hash_mix(1, 0) != ttak_hash_mix(2, 0));
+}
+
+#define CMAP_STABLE 4096
+#define CMAP_CHURN 4096
+#define CMAP_WRITERS 4
+#define CMAP_READERS 4
+
+typedef struct {
+    ttak_concurrent_map_t *map;
+    uintptr_t id;
+    _Atomic int *stop;
+    int errors;
+} cmap_worker_t;
+
+static size_t cmap_add(size_t old, _Bool found, void *arg) {
+    return (found ? old : 0) + *(size_t *)arg;
+}
+
+static void *cmap_writer(void *p) {
+    cmap_worker_t *w = p;
+    // Each writer owns the churn keys congruent to its id and grows/shrinks them repeatedly.
+    for (int round = 0; round < 20; round++) {
+        for (uintptr_t k = w->id; k < CMAP_CHURN; k += CMAP_WRITERS) {
+            ttak_concurrent_map_insert(w->map, (CMAP_STABLE + k) << 4, k, 1);
+        }
+        for (uintptr_t k = w->id; k < CMAP_CHURN; k += CMAP_WRITERS) {
+            if (!ttak_concurrent_map_delete(w->map, (CMAP_STABLE + k) << 4)) w->errors++;
+        }
+        size_t one = 1;
+        for (uintptr_t k = 0; k < 64; k++) {
+            ttak_concurrent_map_compute(w->map, (uintptr_t)1 << 40 | k, cmap_add, &one, NULL, 1);
+        }
+    }
+    return NULL;
+}
+
+static void *cmap_reader(void *p) {
+    cmap_worker_t *w = p;
+    while (!atomic_load(w->stop)) {
+        for (uintptr_t k = 0; k < CMAP_STABLE; k++) {
+            size_t val = 0;
+            if (!ttak_concurrent_map_get(w->map, k << 4, &val) || val != k * 3) w->errors++;
+        }
+        size_t val = 0;
+        uintptr_t k = CMAP_STABLE + (w->id * 977) % CMAP_CHURN;
+        if (ttak_concurrent_map_get(w->map, k << 4, &val) && val != k - CMAP_STABLE) w->errors++;
+    }
+    ttak_concurrent_map_unregister_thread(w->map);
+    return NULL;
+}
+
+void test_concurrent_map() {
+    ttak_concurrent_map_t *map = ttak_concurrent_map_create(8, 16, 1);
+    ASSERT(map != NULL);
+    ASSERT(map->shard_mask == 7);
+    for (uintptr_t k = 0; k < CMAP_STABLE; k++) {
+        ASSERT(ttak_concurrent_map_insert(map, k << 4, k * 3, 1));
+    }
+    ASSERT(ttak_concurrent_map_size(map) == CMAP_STABLE);
+
+    // Readers must always see every stable key while writers resize the shards around them.
+    _Atomic int stop = 0;
+    pthread_t writers[CMAP_WRITERS], readers[CMAP_READERS];
+    cmap_worker_t wctx[CMAP_WRITERS], rctx[CMAP_READERS];
+    for (uintptr_t i = 0; i < CMAP_READERS; i++) {
+        rctx[i] = (cmap_worker_t){map, i, &stop, 0};
+        pthread_create(&readers[i], NULL, cmap_reader, &rctx[i]);
+    }
+    for (uintptr_t i = 0; i < CMAP_WRITERS; i++) {
+        wctx[i] = (cmap_worker_t){map, i, &stop, 0};
+        pthread_create(&writers[i], NULL, cmap_writer, &wctx[i]);
+    }
+    for (int i = 0; i < CMAP_WRITERS; i++) {
+        pthread_join(writers[i], NULL);
+        ASSERT(wctx[i].errors == 0);
+    }
+    atomic_store(&stop, 1);
+    for (int i = 0; i < CMAP_READERS; i++) {
+        pthread_join(readers[i], NULL);
+        ASSERT(rctx[i].errors == 0);
+    }
+
+    // Concurrent read-modify-writes of the same keys are never lost.
+    size_t val = 0;
+    for (uintptr_t k = 0; k < 64; k++) {
+        ASSERT(ttak_concurrent_map_get(map, (uintptr_t)1 << 40 | k, &val) && val == 20 * CMAP_WRITERS);
+    }
+    ASSERT(ttak_concurrent_map_size(map) == CMAP_STABLE + 64);
+    ASSERT(!ttak_concurrent_map_get(map, (uintptr_t)CMAP_STABLE << 4, NULL));
+    ASSERT(!ttak_concurrent_map_delete(map, (uintptr_t)CMAP_STABLE << 4));
+    ttak_concurrent_map_destroy(map);
+}
+
+void test_concurrent_map_resize_reclaim() {
+    ttak_concurrent_map_t *map = ttak_concurrent_map_create(1, 8, 1);
+    ASSERT(map != NULL);
+    for (uintptr_t k = 0; k < 4096; k++) {
+        ASSERT(ttak_concurrent_map_insert(map, k, k, 1));
+    }
+
+    // Without readers, every table replaced by a resize is freed on the spot.
+    size_t retired = 0;
+    for (ttak_hazard_record_t *rec = atomic_load(&map->hazard.records); rec; rec = rec->next) {
+        retired += rec->retired_count;
+    }
+    ASSERT(retired == 0);
+
+    // A reader's hazard keeps its table alive across the writer's scan.
+    ttak_cmap_shard_t *sh = map->shards[0].data;
+    void *held = ttak_hazard_protect(&map->hazard, 1, (void *_Atomic *)&sh->table);
+    for (uintptr_t k = 4096; k < 16384; k++) {
+        ASSERT(ttak_concurrent_map_insert(map, k, k, 1));
+    }
+    ASSERT(atomic_load(&sh->table) != held);
+    retired = 0;
+    for (ttak_hazard_record_t *rec = atomic_load(&map->hazard.records); rec; rec = rec->next) {
+        retired += rec->retired_count;
+    }
+    ASSERT(retired == 1);
+    ttak_hazard_clear(&map->hazard, 1);
+    ttak_concurrent_map_unregister_thread(map);
+    ttak_concurrent_map_destroy(map);
+}
+
 int main() {
     RUN_TEST(test_map_basic);
+    RUN_TEST(test_map_group_probing);
+    RUN_TEST(test_map_delete_and_shrink);
+    RUN_TEST(test_map_hash_policies);
+    RUN_TEST(test_concurrent_map);
+    RUN_TEST(test_concurrent_map_resize_reclaim);
     return 0;
 }
@@ -1,6 +1,32 @@
 #include <ttak/mem/mem.h>
+#include <ttak/mem/arena.h>
+#include <ttak/mem/huge.h>
+#include <ttak/mem/generation.h>
+#include <ttak/mem/trace.h>
+#include <ttak/mem/profile.h>
+#include <ttak/mem_tree/mem_tree.h>
+#include <ttak/timing/timing.h>
 #include "test_macros.h"
 #include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static size_t count_dirty_matches(void **ptrs, size_t n, uint64_t now) {
+    size_t count = 0, seen = 0;
+    void **dirty = tt_inspect_dirty_pointers(now, &count);
+    for (size_t d = 0; d < count; d++) {
+        for (size_t i = 0; i < n; i++) {
+            if (dirty[d] == ptrs[i]) {
+                seen++;
+                break;
+            }
+        }
+    }
+    free(dirty);
+    return seen;
+}
 
 void test_mem_alloc_free() {
     uint64_t now = 100;
@@ -9,6 +35,7 @@ void test_mem_alloc_free() {
     
     void *accessed = ttak_mem_access(ptr, now + 500);
     ASSERT(accessed == ptr);
+    ttak_mem_unpin(accessed);
     
     // Test expiration
     void *expired = ttak_mem_access(ptr, now + 1500);
@@ -36,8 +63,764 @@ void test_mem_realloc() {
     ttak_mem_free(new_ptr);
 }
 
+void test_mem_realloc_in_place() {
+    uint64_t now = 250;
+
+    // Shrinking never moves, and growing back into the slack stays put.
+    char *p = ttak_mem_alloc(1000, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(p != NULL);
+    memset(p, 0x5A, 1000);
+    ASSERT(ttak_mem_realloc(p, 600, __TTAK_UNSAFE_MEM_FOREVER__, now) == p);
+    char *q = ttak_mem_realloc(p, 1000, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(q == p);
+    ASSERT(q[599] == 0x5A && q[600] == 0 && q[999] == 0);
+    ASSERT(ttak_mem_access(q, now) == q);
+    ttak_mem_unpin(q);
+
+    // A registered heap block keeps its registry entry when resized in place.
+    char *big = ttak_mem_alloc(8000, 10, now);
+    ASSERT(big != NULL);
+    ASSERT(ttak_mem_realloc(big, 4000, 10, now) == big);
+    ASSERT(count_dirty_matches((void **)&big, 1, now + 100) == 1);
+
+    // A new finite lifetime is applied in place: the expiry and its timer move.
+    ASSERT(ttak_mem_realloc(big, 6000, 500, now + 50) == big);
+    ASSERT(count_dirty_matches((void **)&big, 1, now + 100) == 0);
+    ASSERT(ttak_mem_access(big, now + 500) == big);
+    ttak_mem_unpin(big);
+    ASSERT(ttak_mem_access(big, now + 600) == NULL);
+    ASSERT(count_dirty_matches((void **)&big, 1, now + 600) == 1);
+    ttak_mem_free(big);
+
+    // Strict-check canaries follow the new end.
+    char *strict = ttak_mem_alloc_safe(320, __TTAK_UNSAFE_MEM_FOREVER__, now, false, false, true, true, TTAK_MEM_STRICT_CHECK);
+    ASSERT(strict != NULL);
+    ASSERT(ttak_mem_realloc(strict, 128, __TTAK_UNSAFE_MEM_FOREVER__, now) == strict);
+    ASSERT(ttak_mem_access(strict, now) == strict);
+    ttak_mem_unpin(strict);
+    ttak_mem_free(strict);
+
+    // The newest block of a huge region grows by bumping the region cursor.
+    char *h = ttak_mem_alloc_with_flags(8192, __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_HUGE_PAGES);
+    ASSERT(h != NULL);
+    h[8191] = 7;
+    char *hg = ttak_mem_realloc_with_flags(h, 65536, __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_HUGE_PAGES);
+    ASSERT(hg == h);
+    ASSERT(hg[8191] == 7 && hg[65535] == 0);
+    ttak_mem_free(hg);
+    ttak_mem_free(q);
+}
+
+static void *resize_reader(void *arg) {
+    char *p = arg;
+    for (int i = 0; i < 200000; i++) {
+        if (ttak_mem_access(p, 0) == p) ttak_mem_unpin(p);
+    }
+    return NULL;
+}
+
+void test_mem_realloc_in_place_concurrent_access() {
+    // Lock-free readers validate the header while it is being resized in place.
+    char *p = ttak_mem_alloc_safe(1000, 1000000, 0, false, false, true, true, TTAK_MEM_STRICT_CHECK);
+    ASSERT(p != NULL);
+    pthread_t th;
+    pthread_create(&th, NULL, resize_reader, p);
+    for (int i = 0; i < 200000; i++) {
+        ASSERT(ttak_mem_realloc(p, (i & 1) ? 600 : 1000, 1000000 + (uint64_t)i, 0) == p);
+    }
+    pthread_join(th, NULL);
+    ttak_mem_free(p);
+}
+
+void test_mem_slab_semantics() {
+    uint64_t now = 300;
+
+    // Small forever-lived blocks take the slab fast path and are recycled.
+    void *a = ttak_mem_alloc(32, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(a != NULL);
+#if defined(TTAK_MEM_COMPACT_HEADER)
+    ASSERT(((uintptr_t)a % 16) == 0);
+#else
+    ASSERT(((uintptr_t)a % 64) == 0);
+#endif
+    ttak_mem_free(a);
+    void *b = ttak_mem_alloc(32, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(b == a);
+    ASSERT(((unsigned char *)b)[0] == 0);
+    ttak_mem_free(b);
+
+    // Lifetime and allow_direct still apply to slab-backed blocks.
+    void *timed = ttak_mem_alloc(64, 100, now);
+    ASSERT(ttak_mem_access(timed, now + 50) == timed);
+    ttak_mem_unpin(timed);
+    ASSERT(ttak_mem_access(timed, now + 200) == NULL);
+    ttak_mem_free(timed);
+
+    void *guarded = ttak_mem_alloc_safe(64, __TTAK_UNSAFE_MEM_FOREVER__, now, false, false, false, true, TTAK_MEM_STRICT_CHECK);
+    ASSERT(guarded != NULL);
+    ASSERT(ttak_mem_access(guarded, now) == NULL);
+    memset(guarded, 0x5A, 64);
+    ttak_mem_free(guarded);
+}
+
+#define SLAB_XFER_COUNT 256
+
+static void *slab_producer(void *arg) {
+    void **out = (void **)arg;
+    for (int i = 0; i < SLAB_XFER_COUNT; i++) {
+        out[i] = ttak_mem_alloc(48, __TTAK_UNSAFE_MEM_FOREVER__, 400);
+        ((int *)out[i])[0] = i;
+    }
+    return NULL;
+}
+
+static void *slab_reuser(void *arg) {
+    void **freed = (void **)arg;
+    size_t reused = 0;
+    for (int i = 0; i < SLAB_XFER_COUNT; i++) {
+        void *p = ttak_mem_alloc(48, __TTAK_UNSAFE_MEM_FOREVER__, 500);
+        for (int j = 0; j < SLAB_XFER_COUNT; j++) {
+            if (freed[j] == p) { reused++; break; }
+        }
+    }
+    return (void *)reused;
+}
+
+void test_mem_slab_cross_thread_free() {
+    static void *blocks[SLAB_XFER_COUNT];
+    pthread_t t;
+    pthread_create(&t, NULL, slab_producer, blocks);
+    pthread_join(t, NULL);
+
+    // Free every block from a foreign thread; they land on the remote list.
+    for (int i = 0; i < SLAB_XFER_COUNT; i++) {
+        ASSERT(((int *)blocks[i])[0] == i);
+        ttak_mem_free(blocks[i]);
+    }
+
+    // The next thread adopts the orphaned cache and recycles the remote frees.
+    void *reused = NULL;
+    pthread_create(&t, NULL, slab_reuser, blocks);
+    pthread_join(t, &reused);
+    ASSERT((size_t)reused == SLAB_XFER_COUNT);
+}
+
+#define REGISTRY_N 2048
+
+void test_mem_registry_free_and_inspect() {
+    uint64_t now = 1000;
+    void **ptrs = malloc(sizeof(void *) * REGISTRY_N);
+    ASSERT(ptrs != NULL);
+    for (int i = 0; i < REGISTRY_N; i++) {
+        ptrs[i] = ttak_mem_alloc(32 + (i % 7) * 100, 10, now);
+        ASSERT(ptrs[i] != NULL);
+    }
+
+    // Free every other allocation; the rest must still be visible to inspection.
+    for (int i = 0; i < REGISTRY_N; i += 2) {
+        ttak_mem_free(ptrs[i]);
+    }
+
+    size_t count = 0;
+    void **dirty = tt_inspect_dirty_pointers(now + 100, &count);
+    ASSERT(dirty != NULL);
+    ASSERT(count >= REGISTRY_N / 2);
+    int seen_live = 0, seen_freed = 0;
+    for (size_t d = 0; d < count; d++) {
+        for (int i = 0; i < REGISTRY_N; i++) {
+            if (dirty[d] == ptrs[i]) {
+                if (i % 2) seen_live++; else seen_freed++;
+                break;
+            }
+        }
+    }
+    free(dirty);
+    ASSERT(seen_live == REGISTRY_N / 2);
+    ASSERT(seen_freed == 0);
+
+    for (int i = 1; i < REGISTRY_N; i += 2) {
+        ttak_mem_free(ptrs[i]);
+    }
+    free(ptrs);
+}
+
+void test_mem_tree_find_remove() {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+
+    void *ptrs[REGISTRY_N];
+    ttak_mem_node_t *nodes[REGISTRY_N];
+    for (int i = 0; i < REGISTRY_N; i++) {
+        ptrs[i] = ttak_mem_alloc(64, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+        nodes[i] = ttak_mem_tree_add(&tree, ptrs[i], 64, __TTAK_UNSAFE_MEM_FOREVER__, true);
+        ASSERT(nodes[i] != NULL);
+    }
+    for (int i = 0; i < REGISTRY_N; i++) {
+        ASSERT(ttak_mem_tree_find_node(&tree, ptrs[i]) == nodes[i]);
+    }
+    for (int i = 0; i < REGISTRY_N; i += 2) {
+        ttak_mem_tree_remove(&tree, nodes[i]);
+        ASSERT(ttak_mem_tree_find_node(&tree, ptrs[i]) == NULL);
+        ttak_mem_free(ptrs[i]);
+    }
+    for (int i = 1; i < REGISTRY_N; i += 2) {
+        ASSERT(ttak_mem_tree_find_node(&tree, ptrs[i]) == nodes[i]);
+    }
+
+    // Destroy releases the remaining tracked blocks.
+    ttak_mem_tree_destroy(&tree);
+}
+
+void test_mem_tree_timer_wheel() {
+    ttak_mem_tree_t tree;
+    ttak_mem_tree_init(&tree);
+    ttak_mem_tree_set_manual_cleanup(&tree, true);
+
+    // One expiry per wheel level plus one past the wheel horizon.
+    const uint64_t offsets[] = { 5, 100, 5000, 300000, 1ULL << 25 };
+    const int n = (int)(sizeof(offsets) / sizeof(offsets[0]));
+    uint64_t base = ttak_get_tick_count();
+    void *ptrs[5];
+    for (int i = 0; i < n; i++) {
+        ptrs[i] = ttak_mem_alloc(64, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+        ttak_mem_node_t *node = ttak_mem_tree_add(&tree, ptrs[i], 64, base + offsets[i], false);
+        ASSERT(node != NULL);
+        ttak_mem_node_release(node);
+    }
+
+    ttak_mem_tree_perform_cleanup(&tree, base + offsets[0] - 1);
+    for (int i = 0; i < n; i++) {
+        ASSERT(ttak_mem_tree_find_node(&tree, ptrs[i]) != NULL);
+    }
+
+    // Each step frees exactly the nodes whose expiry has been reached.
+    for (int step = 0; step < n; step++) {
+        ttak_mem_tree_perform_cleanup(&tree, base + offsets[step]);
+        for (int i = 0; i < n; i++) {
+            if (i <= step) {
+                ASSERT(ttak_mem_tree_find_node(&tree, ptrs[i]) == NULL);
+            } else {
+                ASSERT(ttak_mem_tree_find_node(&tree, ptrs[i]) != NULL);
+            }
+        }
+    }
+
+    ttak_mem_tree_destroy(&tree);
+}
+
+void test_mem_access_modes() {
+    uint64_t now = 300;
+    ASSERT(ttak_mem_get_access_mode() == TTAK_MEM_ACCESS_ATOMIC);
+
+    for (int mode = TTAK_MEM_ACCESS_ATOMIC; mode <= TTAK_MEM_ACCESS_LOCKED; mode++) {
+        ttak_mem_set_access_mode((ttak_mem_access_mode_t)mode);
+        ASSERT(ttak_mem_get_access_mode() == (ttak_mem_access_mode_t)mode);
+
+        void *ptr = ttak_mem_alloc(128, 1000, now);
+        ASSERT(ptr != NULL);
+        ASSERT(ttak_mem_access(ptr, now + 1000) == ptr);
+        ttak_mem_unpin(ptr);
+        ASSERT(ttak_mem_access(ptr, now + 1001) == NULL);
+
+        // Pins saturate instead of spilling into the freed bit; a saturated
+        // block is never reclaimed, so this free leaves it parked.
+        for (int i = 0; i < 40000; i++) {
+            ASSERT(ttak_mem_access(ptr, now) == ptr);
+        }
+        ttak_mem_free(ptr);
+
+        void *direct_off = ttak_mem_alloc_safe(64, __TTAK_UNSAFE_MEM_FOREVER__, now, false, false, false, true, TTAK_MEM_DEFAULT);
+        ASSERT(ttak_mem_access(direct_off, now) == NULL);
+        ttak_mem_free(direct_off);
+    }
+    ttak_mem_set_access_mode(TTAK_MEM_ACCESS_ATOMIC);
+}
+
+void test_mem_deferred_free() {
+    uint64_t now = 400;
+    size_t parked = ttak_mem_deferred_count();
+
+    // A pinned block survives ttak_mem_free until its last pin drops.
+    unsigned char *ptr = ttak_mem_alloc(48, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(ptr != NULL);
+    memset(ptr, 0x3C, 48);
+    ASSERT(ttak_mem_access(ptr, now) == ptr);
+    ASSERT(ttak_mem_access(ptr, now) == ptr);
+
+    ttak_mem_free(ptr);
+    ASSERT(ttak_mem_deferred_count() == parked + 1);
+    ASSERT(ttak_mem_access(ptr, now) == NULL);
+    ASSERT(ptr[47] == 0x3C);
+
+    ttak_mem_unpin(ptr);
+    ASSERT(ttak_mem_deferred_count() == parked + 1);
+    ttak_mem_unpin(ptr);
+    ASSERT(ttak_mem_deferred_count() == parked);
+
+    // The released slab slot is handed out again.
+    void *again = ttak_mem_alloc(48, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(again == ptr);
+    ttak_mem_free(again);
+
+    // Unpinned blocks are released immediately and stray unpins are ignored.
+    void *plain = ttak_mem_alloc(48, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ttak_mem_unpin(plain);
+    ttak_mem_free(plain);
+    ASSERT(ttak_mem_deferred_count() == parked);
+}
+
+void test_mem_access_audit() {
+    uint64_t now = ttak_get_tick_count();
+    void *ptr = ttak_mem_alloc(64, 3600000, now);
+    ASSERT(ptr != NULL);
+    ASSERT(count_dirty_matches(&ptr, 1, now) == 0);
+
+    // Past the audit limit (a lower one with compact headers) the block is
+    // reported as dirty long before it expires.
+    for (int i = 0; i <= 1000000; i++) {
+        ASSERT(ttak_mem_access(ptr, now) == ptr);
+        ttak_mem_unpin(ptr);
+    }
+    ASSERT(count_dirty_matches(&ptr, 1, now) == 1);
+    ttak_mem_free(ptr);
+}
+
+void test_arena_bump_release() {
+    uint64_t now = 500;
+    ttak_arena_t *arena = ttak_arena_create(256, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ASSERT(arena != NULL);
+
+    // Consecutive allocations are bumped out of the same chunk.
+    char *a = ttak_arena_alloc(arena, 10);
+    char *b = ttak_arena_alloc(arena, 16);
+    ASSERT(a != NULL && b != NULL);
+    ASSERT(((uintptr_t)a % TTAK_ARENA_ALIGN) == 0);
+    ASSERT(b == a + 16);
+    ASSERT(ttak_arena_used(arena) == 32);
+
+    // Growing past the inline chunk and oversized requests both succeed.
+    for (int i = 0; i < 64; i++) {
+        unsigned char *p = ttak_arena_alloc(arena, 24);
+        ASSERT(p != NULL && p[0] == 0);
+        memset(p, 0xEE, 24);
+    }
+    unsigned char *big = ttak_arena_alloc(arena, 4096);
+    ASSERT(big != NULL && big[4095] == 0);
+    ASSERT(arena->chunks != NULL);
+
+    ttak_arena_reset(arena);
+    ASSERT(ttak_arena_used(arena) == 0);
+    ASSERT(arena->chunks == NULL);
+    ASSERT(ttak_arena_alloc(arena, 10) == a);
+    ASSERT(a[0] == 0);
+
+    ttak_arena_release(arena);
+}
+
+void test_arena_expiry() {
+    // Real ticks with a long lifetime keep the cleanup thread off the arena.
+    uint64_t now = ttak_get_tick_count();
+    ttak_arena_t *arena = ttak_arena_create(128, 60000, now);
+    ASSERT(arena != NULL);
+    for (int i = 0; i < 32; i++) {
+        ASSERT(ttak_arena_alloc(arena, 64) != NULL);
+    }
+
+    // The lifetime is checked once for the whole arena.
+    ASSERT(ttak_mem_access(arena, now + 50) == arena);
+    ttak_mem_unpin(arena);
+    ASSERT(ttak_mem_access(arena, now + 120000) == NULL);
+
+    // The expiry sweep reclaims the arena and its overflow chunks as a unit.
+    void *ptrs[1] = { arena };
+    ASSERT(count_dirty_matches(ptrs, 1, now + 120000) == 1);
+    tt_autoclean_dirty_pointers(now + 120000);
+    ASSERT(count_dirty_matches(ptrs, 1, now + 120000) == 0);
+}
+
+void test_arena_cleanup_thread() {
+    // Short intervals make the registry's cleanup thread pass every millisecond.
+    ttak_mem_configure_gc(1000000ULL, 1000000ULL, 1024 * 1024);
+    size_t parked = ttak_mem_deferred_count();
+    uint64_t now = ttak_get_tick_count();
+    ttak_arena_t *arena = ttak_arena_create(128, 5, now);
+    ttak_arena_t *held = ttak_arena_create(128, 5, now);
+    ASSERT(arena != NULL && held != NULL);
+    for (int i = 0; i < 32; i++) {
+        ASSERT(ttak_arena_alloc(arena, 64) != NULL);
+    }
+    // A pin taken before expiry keeps the cleanup thread off an arena.
+    ASSERT(ttak_mem_access(held, now) == held);
+
+    // Nobody releases the arena: the cleanup thread frees it once expired.
+    void *ptrs[2] = { arena, held };
+    int waited = 0;
+    while (count_dirty_matches(ptrs, 1, now + 1000) != 0 && waited < 5000) {
+        usleep(1000);
+        waited++;
+    }
+    ASSERT(waited < 5000);
+    ASSERT(count_dirty_matches(ptrs + 1, 1, now + 1000) == 1);
+
+    // Released while pinned, the held arena is reclaimed by its last unpin.
+    ttak_arena_release(held);
+    ttak_mem_unpin(held);
+    ASSERT(count_dirty_matches(ptrs + 1, 1, now + 1000) == 0);
+    ASSERT(ttak_mem_deferred_count() == parked);
+    ttak_mem_configure_gc(500000000ULL, 10000000000ULL, 1024 * 1024);
+}
+
+static void *trace_worker(void *arg) {
+    void *ptr = arg;
+    for (int i = 0; i < 100; i++) {
+        if (ttak_mem_access(ptr, 700)) ttak_mem_unpin(ptr);
+    }
+    return NULL;
+}
+
+void test_mem_trace_ring() {
+    char path[] = "/tmp/ttak_trace_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    close(fd);
+
+    ASSERT(ttak_trace_set_output(path) == 0);
+    ttak_mem_set_trace(1);
+    ASSERT(ttak_mem_is_trace_enabled());
+    ASSERT(ttak_trace_set_output(NULL) == -1);
+
+    uint64_t dropped = ttak_trace_dropped();
+    void *ptr = ttak_mem_alloc(64, 1000, 700);
+    pthread_t th;
+    pthread_create(&th, NULL, trace_worker, ptr);
+    pthread_join(th, NULL);
+    ttak_mem_free(ptr);
+
+    // A failed batch rolls its blocks back through the free path.
+    void *batch[2];
+    size_t batch_sizes[2] = { 64, (size_t)1 << 62 };
+    ASSERT(!ttak_mem_alloc_batch(batch, batch_sizes, 2, 1000, 0, TTAK_MEM_DEFAULT));
+    ASSERT(batch[0] == NULL);
+    ttak_mem_set_trace(0);
+    ASSERT(ttak_trace_dropped() == dropped);
+    ASSERT(ttak_trace_set_output(NULL) == 0);
+
+    FILE *in = fopen(path, "rb");
+    FILE *out = tmpfile();
+    ASSERT(in && out);
+    ASSERT(ttak_trace_decode(in, out) == 1 + 1 + 100 + 1 + 2);
+    fclose(in);
+    remove(path);
+
+    char expect[128];
+    snprintf(expect, sizeof(expect), "{\"event\":\"alloc\",\"ptr\":\"%p\",\"size\":64,\"ts\":700,\"root\":1}", ptr);
+    rewind(out);
+    char line[256];
+    int allocs = 0, accesses = 0, frees = 0;
+    while (fgets(line, sizeof(line), out)) {
+        ASSERT(strncmp(line, "[MEM_TRACK] {", 13) == 0);
+        if (strstr(line, expect)) allocs++;
+        if (strstr(line, "\"event\":\"access\"")) accesses++;
+        if (strstr(line, "\"event\":\"free\"")) frees++;
+    }
+    fclose(out);
+    ASSERT(allocs == 1 && accesses == 100 && frees == 2);
+
+    // A file that is not a trace is rejected.
+    FILE *bogus = tmpfile();
+    fputs("not a trace", bogus);
+    rewind(bogus);
+    ASSERT(ttak_trace_decode(bogus, stdout) == -1);
+    fclose(bogus);
+}
+
+void test_mem_huge_pool() {
+    ttak_huge_stats_t before, during, after;
+    ttak_huge_get_stats(&before);
+
+    // Flagged allocations are carved from one shared region.
+    void *a = ttak_mem_alloc_with_flags(4096, __TTAK_UNSAFE_MEM_FOREVER__, 0, TTAK_MEM_HUGE_PAGES);
+    void *b = ttak_mem_alloc_with_flags(4096, __TTAK_UNSAFE_MEM_FOREVER__, 0, TTAK_MEM_HUGE_PAGES);
+    ASSERT(a && b);
+    uintptr_t mask = ~((uintptr_t)TTAK_HUGE_REGION_SIZE - 1);
+    ASSERT(((uintptr_t)a & mask) == ((uintptr_t)b & mask));
+    ((char *)a)[4095] = 1;
+
+    void *big = ttak_huge_alloc(TTAK_HUGE_MAX_CARVE + 1);
+    ASSERT(big != NULL);
+    ttak_huge_backing_t backing = ttak_huge_backing_of(big, TTAK_HUGE_MAX_CARVE + 1);
+    ASSERT(backing == TTAK_HUGE_BACKING_NONE || backing == TTAK_HUGE_BACKING_HUGETLB || backing == TTAK_HUGE_BACKING_THP);
+
+    ttak_huge_get_stats(&during);
+    ASSERT(during.live_blocks == before.live_blocks + 3);
+    size_t dedicated = during.dedicated[0] + during.dedicated[1] + during.dedicated[2];
+    size_t regions = during.regions[0] + during.regions[1] + during.regions[2];
+    ASSERT(dedicated == before.dedicated[0] + before.dedicated[1] + before.dedicated[2] + 1);
+    ASSERT(regions >= 1);
+
+    ttak_huge_free(big, TTAK_HUGE_MAX_CARVE + 1);
+    ttak_mem_free(a);
+    ttak_mem_free(b);
+
+    // The emptied region is rewound, so the next block reuses its start.
+    void *c = ttak_mem_alloc_with_flags(4096, __TTAK_UNSAFE_MEM_FOREVER__, 0, TTAK_MEM_HUGE_PAGES);
+    ASSERT(c == a);
+    ASSERT(((char *)c)[4095] == 0);
+    ttak_mem_free(c);
+
+    ttak_huge_get_stats(&after);
+    ASSERT(after.live_blocks == before.live_blocks);
+    ASSERT(after.mapped_bytes <= during.mapped_bytes);
+}
+
+#define BATCH_N 150
+
+
+void test_mem_batch_alloc_free() {
+    uint64_t now = 5000;
+    void *ptrs[BATCH_N];
+    size_t sizes[BATCH_N];
+    for (int i = 0; i < BATCH_N; i++) {
+        sizes[i] = 16 + (i % 5) * 300;
+    }
+    ASSERT(ttak_mem_alloc_batch(ptrs, sizes, BATCH_N, 10, now, TTAK_MEM_DEFAULT));
+    for (int i = 0; i < BATCH_N; i++) {
+        ASSERT(ptrs[i] != NULL);
+        ASSERT(((unsigned char *)ptrs[i])[sizes[i] - 1] == 0);
+    }
+
+    // Every block spans several registry chunks and must be tracked.
+    ASSERT(count_dirty_matches(ptrs, BATCH_N, now + 100) == BATCH_N);
+
+    // A pinned block is parked by the batch free like by ttak_mem_free.
+    size_t deferred = ttak_mem_deferred_count();
+    ASSERT(ttak_mem_access(ptrs[3], now) == ptrs[3]);
+    void *to_free[BATCH_N + 1];
+    memcpy(to_free, ptrs, sizeof(ptrs));
+    to_free[BATCH_N] = NULL;
+    ttak_mem_free_batch(to_free, BATCH_N + 1);
+    ASSERT(ttak_mem_deferred_count() == deferred + 1);
+    ASSERT(count_dirty_matches(ptrs, BATCH_N, now + 100) == 0);
+    ttak_mem_unpin(ptrs[3]);
+    ASSERT(ttak_mem_deferred_count() == deferred);
+
+    // Forever-lived batches work the same way.
+    size_t forever_sizes[3] = { 24, 4096, 64 };
+    void *forever[3];
+    ASSERT(ttak_mem_alloc_batch(forever, forever_sizes, 3, __TTAK_UNSAFE_MEM_FOREVER__, now, TTAK_MEM_DEFAULT));
+    ASSERT(ttak_mem_access(forever[1], now + 1000000) == forever[1]);
+    ttak_mem_unpin(forever[1]);
+    ttak_mem_free_batch(forever, 3);
+}
+
+#define SWEEP_N 100
+
+void test_mem_incremental_sweep() {
+    uint64_t now = 9000;
+    void *ptrs[SWEEP_N];
+    for (int i = 0; i < SWEEP_N; i++) {
+        ptrs[i] = ttak_mem_alloc(48, 10, now);
+        ASSERT(ptrs[i] != NULL);
+    }
+    ASSERT(count_dirty_matches(ptrs, SWEEP_N, now + 50) == SWEEP_N);
+
+    // Each call respects the node budget and resumes where the last one stopped.
+    ttak_mem_sweep_cursor_t cursor = {0};
+    size_t freed = 0;
+    int calls = 0;
+    while (count_dirty_matches(ptrs, SWEEP_N, now + 50) > 0) {
+        size_t step = tt_sweep_dirty_pointers(&cursor, now + 50, 8, 0);
+        ASSERT(step <= 8);
+        freed += step;
+        ASSERT(++calls < 10000);
+    }
+    ASSERT(freed >= SWEEP_N);
+    ASSERT(calls >= SWEEP_N / 8);
+
+    // The background sweeper reclaims with real ticks, off the caller's path.
+    uint64_t tick = ttak_get_tick_count();
+    for (int i = 0; i < SWEEP_N; i++) {
+        ptrs[i] = ttak_mem_alloc(48, 1, tick);
+    }
+    usleep(5000);
+    ASSERT(ttak_mem_sweeper_start(1000000, 16, 0));
+    for (int i = 0; i < 1000 && count_dirty_matches(ptrs, SWEEP_N, ttak_get_tick_count()) > 0; i++) {
+        usleep(1000);
+    }
+    ttak_mem_sweeper_stop();
+    ASSERT(count_dirty_matches(ptrs, SWEEP_N, ttak_get_tick_count()) == 0);
+}
+
+void test_mem_profile_sampling() {
+    ttak_profile_reset();
+    // A 1-byte interval samples every allocation.
+    ttak_profile_start(1);
+    ASSERT(ttak_profile_is_enabled());
+    void *forever[10];
+    for (int i = 0; i < 10; i++) {
+        forever[i] = ttak_mem_alloc(64, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+    }
+    void *short_lived = ttak_mem_alloc(128, 50, 0);
+    ttak_profile_stop();
+    void *unsampled = ttak_mem_alloc(64, __TTAK_UNSAFE_MEM_FOREVER__, 0);
+
+    ttak_profile_stats_t stats;
+    ttak_profile_get_stats(&stats);
+    ASSERT(stats.live_samples == 11 && stats.total_samples == 11);
+    ASSERT(stats.live_bytes[TTAK_PROFILE_LIFETIME_FOREVER] >= 640);
+    ASSERT(stats.live_bytes[TTAK_PROFILE_LIFETIME_SHORT] >= 128);
+    ASSERT(stats.sites >= 2);
+
+    FILE *out = tmpfile();
+    ASSERT(out != NULL);
+    ASSERT(ttak_profile_dump_folded(out) >= 2);
+    rewind(out);
+    char line[2048];
+    int forever_lines = 0, short_lines = 0;
+    while (fgets(line, sizeof(line), out)) {
+        if (strncmp(line, "lifetime=forever;", 17) == 0) forever_lines++;
+        if (strncmp(line, "lifetime=short;", 15) == 0) short_lines++;
+        ASSERT(strrchr(line, ' ') != NULL);
+    }
+    fclose(out);
+    ASSERT(forever_lines >= 1 && short_lines >= 1);
+
+    // A block resized in place moves its sample to the new size and lifetime.
+    ASSERT(ttak_mem_realloc(short_lived, 64, 5000, 0) == short_lived);
+    ttak_profile_get_stats(&stats);
+    ASSERT(stats.live_samples == 11);
+    ASSERT(stats.live_bytes[TTAK_PROFILE_LIFETIME_SHORT] == 0);
+    ASSERT(stats.live_bytes[TTAK_PROFILE_LIFETIME_MEDIUM] >= 64);
+
+    // Freed samples leave the live totals; unsampled blocks never enter them.
+    for (int i = 0; i < 10; i++) {
+        ttak_mem_free(forever[i]);
+    }
+    ttak_mem_free(unsampled);
+    ttak_profile_get_stats(&stats);
+    ASSERT(stats.live_samples == 1);
+    ASSERT(stats.live_bytes[TTAK_PROFILE_LIFETIME_FOREVER] == 0);
+    ttak_mem_free(short_lived);
+    ttak_profile_get_stats(&stats);
+    ASSERT(stats.live_samples == 0 && stats.live_bytes[TTAK_PROFILE_LIFETIME_MEDIUM] == 0);
+
+    // Blocks rolled back by a failed batch leave the live totals as well.
+    uint64_t total = stats.total_samples;
+    ttak_profile_start(1);
+    void *batch[2];
+    size_t batch_sizes[2] = { 64, (size_t)1 << 62 };
+    ASSERT(!ttak_mem_alloc_batch(batch, batch_sizes, 2, 1000, 0, TTAK_MEM_DEFAULT));
+    ttak_profile_stop();
+    ttak_profile_get_stats(&stats);
+    ASSERT(stats.total_samples == total + 1 && stats.live_samples == 0);
+    ttak_profile_reset();
+}
+
+#define GEN_N 1000
+
+void test_mem_generations() {
+    uint64_t now = 100000;
+    ttak_gen_stats_t before, stats;
+    ttak_gen_get_stats(&before);
+
+    // Blocks with the same lifetime land in one generation; a longer lifetime opens another.
+    void *short_lived[GEN_N];
+    for (int i = 0; i < GEN_N; i++) {
+        short_lived[i] = ttak_mem_alloc_with_flags(200, 100, now, TTAK_MEM_GENERATIONAL);
+        ASSERT(short_lived[i] != NULL);
+        ASSERT(ttak_gen_contains(short_lived[i]));
+        ASSERT(((unsigned char *)short_lived[i])[199] == 0);
+    }
+    void *long_lived = ttak_mem_alloc_with_flags(64, 10000, now, TTAK_MEM_GENERATIONAL);
+    ASSERT(long_lived && ttak_gen_contains(long_lived));
+    ttak_gen_get_stats(&stats);
+    ASSERT(stats.generations == before.generations + 2);
+    ASSERT(stats.live_blocks == before.live_blocks + GEN_N + 1);
+
+    // Generation blocks stay off the registry the sweeps walk.
+    ASSERT(count_dirty_matches(short_lived, GEN_N, now + 1000) == 0);
+
+    ttak_mem_free(short_lived[0]);
+    ttak_gen_get_stats(&stats);
+    ASSERT(stats.live_blocks == before.live_blocks + GEN_N);
+
+    // A reader's pin holds the whole generation past its deadline.
+    ASSERT(ttak_mem_access(short_lived[5], now) == short_lived[5]);
+    tt_autoclean_dirty_pointers(now + 200);
+    ttak_gen_get_stats(&stats);
+    ASSERT(stats.reclaimed_generations == before.reclaimed_generations);
+    ASSERT(((char *)short_lived[5])[0] == 0);
+    ttak_mem_unpin(short_lived[5]);
+
+    tt_autoclean_dirty_pointers(now + 200);
+    ttak_gen_get_stats(&stats);
+    ASSERT(stats.reclaimed_generations == before.reclaimed_generations + 1);
+    ASSERT(stats.reclaimed_blocks == before.reclaimed_blocks + GEN_N - 1);
+    ASSERT(stats.generations == before.generations + 1);
+
+    // Stale pointers into the dropped generation fail instead of faulting.
+    ASSERT(ttak_mem_access(short_lived[1], now) == NULL);
+    ttak_mem_free(short_lived[2]);
+    ASSERT(ttak_mem_realloc(short_lived[3], 400, 100, now) == NULL);
+
+    // The next generation reuses the dropped segment instead of a fresh one.
+    void *reborn = ttak_mem_alloc_with_flags(200, 100, now + 300, TTAK_MEM_GENERATIONAL);
+    ASSERT(reborn && ttak_gen_contains(reborn));
+    uintptr_t seg_mask = ~(uintptr_t)(TTAK_GEN_SEGMENT_SIZE - 1);
+    ASSERT(((uintptr_t)reborn & seg_mask) == ((uintptr_t)short_lived[1] & seg_mask));
+    ttak_gen_get_stats(&stats);
+    ASSERT(stats.reused_segments == before.reused_segments + 1);
+    ASSERT(stats.exhausted == before.exhausted);
+    ASSERT(((unsigned char *)reborn)[199] == 0);
+    ASSERT(ttak_mem_access(reborn, now + 300) == reborn);
+    ttak_mem_unpin(reborn);
+    ttak_mem_free(reborn);
+
+    // The longer-lived generation is untouched.
+    ASSERT(ttak_mem_access(long_lived, now + 200) == long_lived);
+    ttak_mem_unpin(long_lived);
+    ttak_mem_free(long_lived);
+
+    // Generational mode routes plain allocations, but never forever-lived ones or arenas.
+    ttak_mem_set_generational(1);
+    ASSERT(ttak_mem_is_generational());
+    void *routed = ttak_mem_alloc(64, 50, now);
+    void *forever = ttak_mem_alloc(64, __TTAK_UNSAFE_MEM_FOREVER__, now);
+    ttak_arena_t *arena = ttak_arena_create(0, 60000, ttak_get_tick_count());
+    ttak_mem_set_generational(0);
+    ASSERT(routed && ttak_gen_contains(routed));
+    ASSERT(forever && !ttak_gen_contains(forever));
+    ASSERT(arena && !ttak_gen_contains(arena));
+    ttak_mem_free(routed);
+    ttak_mem_free(forever);
+    ttak_arena_release(arena);
+    tt_autoclean_dirty_pointers(now + 1000000);
+    ttak_gen_get_stats(&stats);
+    ASSERT(stats.generations == before.generations);
+    ASSERT(stats.live_blocks == before.live_blocks);
+}
+
 int main() {
     RUN_TEST(test_mem_alloc_free);
     RUN_TEST(test_mem_realloc);
+    RUN_TEST(test_mem_realloc_in_place);
+    RUN_TEST(test_mem_realloc_in_place_concurrent_access);
+    RUN_TEST(test_mem_access_modes);
+    RUN_TEST(test_mem_slab_semantics);
+    RUN_TEST(test_mem_deferred_free);
+    RUN_TEST(test_mem_access_audit);
+    RUN_TEST(test_arena_bump_release);
+    RUN_TEST(test_arena_expiry);
+    RUN_TEST(test_arena_cleanup_thread);
+    RUN_TEST(test_mem_trace_ring);
+    RUN_TEST(test_mem_huge_pool);
+    RUN_TEST(test_mem_generations);
+    RUN_TEST(test_mem_batch_alloc_free);
+    RUN_TEST(test_mem_incremental_sweep);
+    RUN_TEST(test_mem_profile_sampling);
+    RUN_TEST(test_mem_slab_cross_thread_free);
+    RUN_TEST(test_mem_registry_free_and_inspect);
+    RUN_TEST(test_mem_tree_find_remove);
+    RUN_TEST(test_mem_tree_timer_wheel);
     return 0;
 }
@@ -1,15 +1,26 @@
 #include <ttak/limit/limit.h>
 #include <ttak/stats/stats.h>
 #include <ttak/log/logger.h>
+#include <ttak/log/wal.h>
 #include <ttak/container/ringbuf.h>
 #include <ttak/container/pool.h>
 #include <ttak/mem/epoch_gc.h>
+#include <ttak/mem/hazard.h>
 #include <ttak/sync/spinlock.h>
 #include <ttak/timing/deadline.h>
 #include <ttak/mem/mem.h>
+#include <ttak/unsafe/channel.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include "../tests/test_macros.h"
 
 // --- Logger Mock ---
@@ -109,6 +120,226 @@ void test_epoch_gc() {
     ttak_epoch_gc_destroy(&gc);
 }
 
+static _Atomic int epoch_reclaimed = 0;
+
+static void count_reclaim(void *ptr) {
+    atomic_fetch_add(&epoch_reclaimed, 1);
+    free(ptr);
+}
+
+void test_epoch_gc_grace_period() {
+    ttak_epoch_gc_t gc;
+    ttak_epoch_gc_init(&gc);
+    atomic_store(&epoch_reclaimed, 0);
+
+    ttak_epoch_gc_enter(&gc);
+    ttak_epoch_gc_retire(&gc, malloc(16), count_reclaim);
+
+    // The reader announced the retire epoch, so at most one advance happens.
+    ttak_epoch_gc_rotate(&gc);
+    ttak_epoch_gc_rotate(&gc);
+    ASSERT(atomic_load(&epoch_reclaimed) == 0);
+    ASSERT(ttak_epoch_gc_try_advance(&gc) == false);
+
+    ttak_epoch_gc_exit(&gc);
+    ttak_epoch_gc_rotate(&gc);
+    ASSERT(atomic_load(&epoch_reclaimed) == 1);
+
+    // Blocks left behind by an unregistered thread are reclaimed by rotation.
+    ttak_epoch_gc_retire(&gc, malloc(16), count_reclaim);
+    ttak_epoch_gc_unregister_thread(&gc);
+    ttak_epoch_gc_rotate(&gc);
+    ttak_epoch_gc_rotate(&gc);
+    ASSERT(atomic_load(&epoch_reclaimed) == 2);
+
+    ttak_epoch_gc_retire(&gc, malloc(16), count_reclaim);
+    ttak_epoch_gc_destroy(&gc);
+    ASSERT(atomic_load(&epoch_reclaimed) == 3);
+}
+
+#define EPOCH_NODE_MAGIC 0x45504F43U
+#define EPOCH_READERS 3
+#define EPOCH_UPDATES 20000
+
+typedef struct {
+    uint32_t magic;
+    uint32_t value;
+} epoch_node_t;
+
+static ttak_epoch_gc_t shared_gc;
+static epoch_node_t *_Atomic shared_node;
+static _Atomic int epoch_stop = 0;
+static _Atomic int epoch_torn = 0;
+
+static void poison_reclaim(void *ptr) {
+    epoch_node_t *node = ptr;
+    node->magic = 0;
+    free(node);
+}
+
+static void *epoch_reader(void *arg) {
+    (void)arg;
+    while (!atomic_load(&epoch_stop)) {
+        ttak_epoch_gc_enter(&shared_gc);
+        epoch_node_t *node = atomic_load(&shared_node);
+        if (node->magic != EPOCH_NODE_MAGIC) atomic_store(&epoch_torn, 1);
+        ttak_epoch_gc_exit(&shared_gc);
+    }
+    ttak_epoch_gc_unregister_thread(&shared_gc);
+    return NULL;
+}
+
+void test_epoch_gc_concurrent() {
+    ttak_epoch_gc_init(&shared_gc);
+    epoch_node_t *first = malloc(sizeof(*first));
+    first->magic = EPOCH_NODE_MAGIC;
+    first->value = 0;
+    atomic_store(&shared_node, first);
+    atomic_store(&epoch_stop, 0);
+
+    pthread_t readers[EPOCH_READERS];
+    for (int i = 0; i < EPOCH_READERS; i++) {
+        pthread_create(&readers[i], NULL, epoch_reader, NULL);
+    }
+
+    for (uint32_t i = 1; i <= EPOCH_UPDATES; i++) {
+        epoch_node_t *next = malloc(sizeof(*next));
+        next->magic = EPOCH_NODE_MAGIC;
+        next->value = i;
+        epoch_node_t *old = atomic_load(&shared_node);
+        atomic_store(&shared_node, next);
+        ttak_epoch_gc_retire(&shared_gc, old, poison_reclaim);
+    }
+
+    atomic_store(&epoch_stop, 1);
+    for (int i = 0; i < EPOCH_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    ASSERT(atomic_load(&epoch_torn) == 0);
+    ASSERT(atomic_load(&shared_gc.current_epoch) > 0);
+
+    ttak_epoch_gc_destroy(&shared_gc);
+    free(atomic_load(&shared_node));
+}
+
+static _Atomic int hazard_reclaimed = 0;
+
+static void count_hazard_reclaim(void *ptr) {
+    atomic_fetch_add(&hazard_reclaimed, 1);
+    free(ptr);
+}
+
+void test_hazard_protect_retire() {
+    ttak_hazard_domain_t dom;
+    ttak_hazard_domain_init(&dom);
+    atomic_store(&hazard_reclaimed, 0);
+
+    void *_Atomic shared = malloc(16);
+    void *held = ttak_hazard_protect(&dom, 0, &shared);
+    ASSERT(held == atomic_load(&shared));
+
+    // A protected block survives scans; an unprotected one does not.
+    atomic_store(&shared, NULL);
+    ttak_hazard_retire(&dom, held, count_hazard_reclaim);
+    ttak_hazard_retire(&dom, malloc(16), count_hazard_reclaim);
+    ASSERT(ttak_hazard_scan(&dom) == 1);
+    ASSERT(atomic_load(&hazard_reclaimed) == 1);
+
+    ttak_hazard_clear(&dom, 0);
+    ASSERT(ttak_hazard_scan(&dom) == 1);
+    ASSERT(atomic_load(&hazard_reclaimed) == 2);
+
+    // Retired lists stay bounded without explicit scans.
+    for (int i = 0; i < 1000; i++) {
+        ttak_hazard_retire(&dom, malloc(16), count_hazard_reclaim);
+    }
+    ASSERT(atomic_load(&hazard_reclaimed) >= 1002 - TTAK_HAZARD_MIN_SCAN);
+
+    ttak_hazard_unregister_thread(&dom);
+    ttak_hazard_domain_destroy(&dom);
+    ASSERT(atomic_load(&hazard_reclaimed) == 1002);
+}
+
+void test_hazard_two_domains() {
+    ttak_hazard_domain_t a, b;
+    ttak_hazard_domain_init(&a);
+    ttak_hazard_domain_init(&b);
+    atomic_store(&hazard_reclaimed, 0);
+
+    // One thread alternating between domains keeps a record in each.
+    void *_Atomic shared_a = malloc(16);
+    void *_Atomic shared_b = malloc(16);
+    void *held_a = NULL, *held_b = NULL;
+    for (int i = 0; i < 100; i++) {
+        held_a = ttak_hazard_protect(&a, 0, &shared_a);
+        held_b = ttak_hazard_protect(&b, 0, &shared_b);
+    }
+    ASSERT(atomic_load(&a.record_count) == 1 && atomic_load(&b.record_count) == 1);
+
+    // Each domain's hazard only guards blocks retired to that domain.
+    ttak_hazard_retire(&a, held_a, count_hazard_reclaim);
+    ttak_hazard_retire(&b, held_b, count_hazard_reclaim);
+    ASSERT(ttak_hazard_scan(&a) == 0 && ttak_hazard_scan(&b) == 0);
+    ttak_hazard_clear(&a, 0);
+    ASSERT(ttak_hazard_scan(&a) == 1 && ttak_hazard_scan(&b) == 0);
+    ttak_hazard_clear(&b, 0);
+    ASSERT(ttak_hazard_scan(&b) == 1);
+    ASSERT(atomic_load(&hazard_reclaimed) == 2);
+
+    ttak_hazard_unregister_thread(&a);
+    ttak_hazard_unregister_thread(&b);
+    ttak_hazard_domain_destroy(&a);
+    ttak_hazard_domain_destroy(&b);
+}
+
+static ttak_hazard_domain_t shared_dom;
+static void *_Atomic hazard_node;
+static _Atomic int hazard_stop = 0;
+static _Atomic int hazard_torn = 0;
+
+static void *hazard_reader(void *arg) {
+    (void)arg;
+    while (!atomic_load(&hazard_stop)) {
+        epoch_node_t *node = ttak_hazard_protect(&shared_dom, 0, &hazard_node);
+        if (node->magic != EPOCH_NODE_MAGIC) atomic_store(&hazard_torn, 1);
+        ttak_hazard_clear(&shared_dom, 0);
+    }
+    ttak_hazard_unregister_thread(&shared_dom);
+    return NULL;
+}
+
+void test_hazard_concurrent() {
+    ttak_hazard_domain_init(&shared_dom);
+    epoch_node_t *first = malloc(sizeof(*first));
+    first->magic = EPOCH_NODE_MAGIC;
+    first->value = 0;
+    atomic_store(&hazard_node, first);
+    atomic_store(&hazard_stop, 0);
+
+    pthread_t readers[EPOCH_READERS];
+    for (int i = 0; i < EPOCH_READERS; i++) {
+        pthread_create(&readers[i], NULL, hazard_reader, NULL);
+    }
+
+    for (uint32_t i = 1; i <= EPOCH_UPDATES; i++) {
+        epoch_node_t *next = malloc(sizeof(*next));
+        next->magic = EPOCH_NODE_MAGIC;
+        next->value = i;
+        void *old = atomic_load(&hazard_node);
+        atomic_store(&hazard_node, next);
+        ttak_hazard_retire(&shared_dom, old, poison_reclaim);
+    }
+
+    atomic_store(&hazard_stop, 1);
+    for (int i = 0; i < EPOCH_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    ASSERT(atomic_load(&hazard_torn) == 0);
+
+    ttak_hazard_domain_destroy(&shared_dom);
+    free(atomic_load(&hazard_node));
+}
+
 void test_sync_timing() {
     ttak_spin_t lock;
     ttak_spin_init(&lock);
@@ -125,6 +356,353 @@ void test_sync_timing() {
     ASSERT(ttak_deadline_is_expired(&dl) == true);
 }
 
+// --- WAL ---
+#define WAL_THREADS 8
+#define WAL_WRITES 50
+
+typedef struct {
+    ttak_wal_t *wal;
+    int id;
+} wal_worker_arg_t;
+
+static void *wal_worker(void *arg) {
+    wal_worker_arg_t *w = arg;
+    for (int i = 0; i < WAL_WRITES; i++) {
+        uint32_t value = (uint32_t)(w->id * 1000 + i);
+        uint64_t offset = ((uint64_t)w->id * WAL_WRITES + (uint64_t)i) * sizeof(value);
+        if (ttak_wal_write(w->wal, offset, &value, sizeof(value)) != 0) return (void *)1;
+    }
+    return NULL;
+}
+
+static void wal_check_image(ttak_wal_t *wal) {
+    ASSERT(ttak_wal_size(wal) == WAL_THREADS * WAL_WRITES * sizeof(uint32_t));
+    for (int t = 0; t < WAL_THREADS; t++) {
+        for (int i = 0; i < WAL_WRITES; i++) {
+            uint32_t value = 0;
+            ttak_wal_read(wal, ((uint64_t)t * WAL_WRITES + (uint64_t)i) * sizeof(value), &value, sizeof(value));
+            ASSERT(value == (uint32_t)(t * 1000 + i));
+        }
+    }
+}
+
+static size_t wal_segment_count(const char *dir) {
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "ls %s | grep -c '\\.wal\\.'", dir);
+    FILE *p = popen(cmd, "r");
+    size_t n = 0;
+    if (p) {
+        if (fscanf(p, "%zu", &n) != 1) n = 0;
+        pclose(p);
+    }
+    return n;
+}
+
+/**
+ * @brief Removes a test directory with its snapshot, segments and lock file.
+ */
+static void wal_remove_dir(const char *dir) {
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+    ASSERT(system(cmd) == 0);
+}
+
+void test_wal_group_commit() {
+    char dir[] = "/tmp/ttak_wal_XXXXXX";
+    ASSERT(mkdtemp(dir) != NULL);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/state", dir);
+
+    // Small segments so that rotation and compaction happen during the run.
+    ttak_wal_options_t opts = { .segment_bytes = 2048, .compact_segments = 2 };
+    ttak_wal_t *wal = ttak_wal_open(path, &opts);
+    ASSERT(wal != NULL);
+
+    pthread_t threads[WAL_THREADS];
+    wal_worker_arg_t args[WAL_THREADS];
+    for (int i = 0; i < WAL_THREADS; i++) {
+        args[i].wal = wal;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, wal_worker, &args[i]);
+    }
+    for (int i = 0; i < WAL_THREADS; i++) {
+        void *ret;
+        pthread_join(threads[i], &ret);
+        ASSERT(ret == NULL);
+    }
+
+    ttak_wal_stats_t stats;
+    ttak_wal_get_stats(wal, &stats);
+    ASSERT(stats.commits == WAL_THREADS * WAL_WRITES);
+    ASSERT(stats.syncs >= 1 && stats.syncs <= stats.commits);
+    ASSERT(stats.durable_lsn == WAL_THREADS * WAL_WRITES);
+    ASSERT(stats.compactions >= 1);
+    wal_check_image(wal);
+
+    // A second handle on a live log is refused.
+    errno = 0;
+    ASSERT(ttak_wal_open(path, &opts) == NULL);
+    ASSERT(errno == EBUSY);
+
+    // Close keeps the active segment and folds everything into the snapshot,
+    // whose header carries the last LSN it covers.
+    ttak_wal_close(wal);
+    ASSERT(wal_segment_count(dir) == 1);
+    FILE *f = fopen(path, "rb");
+    ASSERT(f != NULL);
+    uint32_t head[2];
+    uint64_t snap[2];
+    uint32_t first[2];
+    ASSERT(fread(head, sizeof(uint32_t), 2, f) == 2);
+    ASSERT(fread(snap, sizeof(uint64_t), 2, f) == 2);
+    ASSERT(fread(first, sizeof(uint32_t), 2, f) == 2);
+    fclose(f);
+    ASSERT(head[0] == 0x31504E53U);
+    ASSERT(snap[0] == WAL_THREADS * WAL_WRITES);
+    ASSERT(snap[1] == WAL_THREADS * WAL_WRITES * sizeof(uint32_t));
+    ASSERT(first[0] == 0 && first[1] == 1);
+
+    // Recovery from the snapshot alone: the kept segment's records are all below its LSN.
+    wal = ttak_wal_open(path, &opts);
+    ASSERT(wal != NULL);
+    ttak_wal_get_stats(wal, &stats);
+    ASSERT(stats.replayed == 0 && stats.durable_lsn == WAL_THREADS * WAL_WRITES);
+    wal_check_image(wal);
+    uint32_t extra = 42;
+    ASSERT(ttak_wal_write(wal, 0, &extra, sizeof(extra)) == 0);
+    ttak_wal_close(wal);
+
+    // LSNs keep rising past the snapshot, so the new record survives the next open.
+    wal = ttak_wal_open(path, &opts);
+    ASSERT(wal != NULL);
+    ASSERT(ttak_wal_read(wal, 0, &extra, sizeof(extra)) == sizeof(extra) && extra == 42);
+    ttak_wal_close(wal);
+
+    wal_remove_dir(dir);
+}
+
+#define WAL_BATCH_THREADS 16
+#define WAL_BATCH_COMMITS 100
+
+static pthread_barrier_t wal_batch_start;
+
+static void *wal_batch_worker(void *arg) {
+    wal_worker_arg_t *w = arg;
+    pthread_barrier_wait(&wal_batch_start);
+    for (int i = 0; i < WAL_BATCH_COMMITS; i++) {
+        uint64_t value = ((uint64_t)w->id << 32) | (uint64_t)i;
+        if (ttak_wal_write(w->wal, (uint64_t)w->id * sizeof(value), &value, sizeof(value)) != 0) return (void *)1;
+    }
+    return NULL;
+}
+
+void test_wal_group_commit_batches() {
+    char dir[] = "/tmp/ttak_wal_XXXXXX";
+    ASSERT(mkdtemp(dir) != NULL);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/state", dir);
+    ttak_wal_t *wal = ttak_wal_open(path, NULL);
+    ASSERT(wal != NULL);
+
+    pthread_t threads[WAL_BATCH_THREADS];
+    wal_worker_arg_t args[WAL_BATCH_THREADS];
+    pthread_barrier_init(&wal_batch_start, NULL, WAL_BATCH_THREADS);
+    for (int i = 0; i < WAL_BATCH_THREADS; i++) {
+        args[i].wal = wal;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, wal_batch_worker, &args[i]);
+    }
+    for (int i = 0; i < WAL_BATCH_THREADS; i++) {
+        void *ret;
+        pthread_join(threads[i], &ret);
+        ASSERT(ret == NULL);
+    }
+    pthread_barrier_destroy(&wal_batch_start);
+
+    // Committers that queue behind a running flush share its fdatasync.
+    ttak_wal_stats_t stats;
+    ttak_wal_get_stats(wal, &stats);
+    ASSERT(stats.commits == WAL_BATCH_THREADS * WAL_BATCH_COMMITS);
+    ASSERT(stats.syncs < stats.commits);
+    ttak_wal_close(wal);
+    wal_remove_dir(dir);
+}
+
+void test_wal_crash_recovery() {
+    char dir[] = "/tmp/ttak_wal_XXXXXX";
+    ASSERT(mkdtemp(dir) != NULL);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/state", dir);
+
+    pid_t pid = fork();
+    ASSERT(pid >= 0);
+    if (pid == 0) {
+        ttak_wal_t *wal = ttak_wal_open(path, NULL);
+        if (!wal) _exit(1);
+        char block[256];
+        memset(block, 'a', sizeof(block));
+        if (ttak_wal_write(wal, 0, block, sizeof(block)) != 0) _exit(2);
+        ttak_wal_range_t ranges[2] = { { 16, "xyz", 3 }, { 200, "tail", 4 } };
+        if (ttak_wal_commit(wal, 512, ranges, 2) != 0) _exit(3);
+
+        // A record torn halfway through its append.
+        char seg[300];
+        snprintf(seg, sizeof(seg), "%s.wal.%016x", path, 1);
+        int fd = open(seg, O_WRONLY | O_APPEND);
+        if (fd < 0 || write(fd, "\x57\x41\x4c\x31garbage", 11) != 11) _exit(4);
+        _exit(0); // Crash: no close, no compaction.
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    ttak_wal_t *wal = ttak_wal_open(path, NULL);
+    ASSERT(wal != NULL);
+    ttak_wal_stats_t stats;
+    ttak_wal_get_stats(wal, &stats);
+    ASSERT(stats.replayed == 2);
+    ASSERT(ttak_wal_size(wal) == 512);
+
+    char buf[512];
+    ASSERT(ttak_wal_read(wal, 0, buf, sizeof(buf)) == 512);
+    ASSERT(buf[0] == 'a' && memcmp(buf + 16, "xyz", 3) == 0 && buf[19] == 'a');
+    ASSERT(memcmp(buf + 200, "tail", 4) == 0 && buf[255] == 'a' && buf[256] == 0);
+
+    // Appends continue after the cut-off tail.
+    ASSERT(ttak_wal_write(wal, 511, "z", 1) == 0);
+    ttak_wal_close(wal);
+
+    wal = ttak_wal_open(path, NULL);
+    ASSERT(wal != NULL);
+    ASSERT(ttak_wal_read(wal, 0, buf, sizeof(buf)) == 512);
+    ASSERT(buf[511] == 'z' && memcmp(buf + 16, "xyz", 3) == 0);
+    ttak_wal_close(wal);
+
+    wal_remove_dir(dir);
+}
+
+void test_save_current_progress() {
+    char dir[] = "/tmp/ttak_wal_XXXXXX";
+    ASSERT(mkdtemp(dir) != NULL);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/progress.bin", dir);
+
+    static uint8_t state[64 * 1024];
+    for (size_t i = 0; i < sizeof(state); i++) state[i] = (uint8_t)i;
+    save_current_progress(path, state, sizeof(state));
+    state[12345] = 0xAB;
+    state[40000] = 0xCD;
+    save_current_progress(path, state, sizeof(state));
+
+    static uint8_t loaded[64 * 1024];
+    ASSERT(load_current_progress(path, loaded, sizeof(loaded)) == sizeof(state));
+    ASSERT(memcmp(loaded, state, sizeof(state)) == 0);
+
+    // Only the two changed blocks went to the log after the first save.
+    struct stat st;
+    char seg[300];
+    snprintf(seg, sizeof(seg), "%s.wal.%016x", path, 1);
+    ASSERT(stat(seg, &st) == 0);
+    ASSERT((size_t)st.st_size < sizeof(state) + 1024);
+
+    // The file is the log's snapshot; the state is read back through the log.
+    close_current_progress(path);
+    ASSERT(stat(path, &st) == 0 && (size_t)st.st_size > sizeof(state));
+    memset(loaded, 0, sizeof(loaded));
+    ASSERT(load_current_progress(path, loaded, sizeof(loaded)) == sizeof(state));
+    ASSERT(memcmp(loaded, state, sizeof(state)) == 0);
+    close_current_progress(path);
+    wal_remove_dir(dir);
+
+    // A bare file written before the log existed is loaded as the state.
+    ASSERT(mkdtemp(strcpy(dir, "/tmp/ttak_wal_XXXXXX")) != NULL);
+    snprintf(path, sizeof(path), "%s/progress.bin", dir);
+    FILE *f = fopen(path, "wb");
+    ASSERT(f != NULL);
+    ASSERT(fwrite(state, 1, 1000, f) == 1000);
+    fclose(f);
+    ASSERT(load_current_progress(path, loaded, sizeof(loaded)) == 1000);
+    ASSERT(memcmp(loaded, state, 1000) == 0);
+    close_current_progress(path);
+    wal_remove_dir(dir);
+}
+
+#define CHANNEL_CTX_PRODUCER 7U
+#define CHANNEL_CTX_CONSUMER 9U
+#define CHANNEL_MESSAGES 20000
+
+static void *channel_producer(void *arg) {
+    ttak_region_channel_t *ch = arg;
+    for (uint32_t i = 0; i < CHANNEL_MESSAGES; i++) {
+        uint32_t *payload = malloc(sizeof(*payload));
+        *payload = i;
+        ttak_unsafe_region_t region;
+        ttak_unsafe_region_init(&region, CHANNEL_CTX_PRODUCER, "producer");
+        ttak_unsafe_region_adopt(&region, payload, sizeof(*payload), sizeof(*payload), "producer", CHANNEL_CTX_PRODUCER);
+        while (!ttak_region_channel_send(ch, &region)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+void test_region_channel() {
+    ttak_region_channel_t ch;
+    ASSERT(ttak_region_channel_init(&ch, 100, CHANNEL_CTX_PRODUCER, "producer", CHANNEL_CTX_CONSUMER, "consumer"));
+    ASSERT(ch.mask == 127);
+
+    // Pinned regions and regions of another context never enter the channel.
+    uint32_t value = 42;
+    ttak_unsafe_region_t region;
+    ttak_unsafe_region_init(&region, CHANNEL_CTX_PRODUCER, "producer");
+    ASSERT(!ttak_region_channel_send(&ch, &region));
+    ASSERT(ttak_unsafe_region_adopt(&region, &value, sizeof(value), sizeof(value), "producer", CHANNEL_CTX_PRODUCER));
+    ttak_unsafe_region_pin(&region);
+    ASSERT(!ttak_region_channel_send(&ch, &region));
+    ttak_unsafe_region_unpin(&region);
+    region.ctx_id = CHANNEL_CTX_CONSUMER;
+    ASSERT(!ttak_region_channel_send(&ch, &region));
+    region.ctx_id = CHANNEL_CTX_PRODUCER;
+    ASSERT(ttak_region_channel_send(&ch, &region));
+    ASSERT(ttak_unsafe_region_is_empty(&region));
+    ASSERT(ttak_region_channel_count(&ch) == 1);
+
+    // The receiving side must offer an empty, unpinned region of its own context.
+    ttak_unsafe_region_t out;
+    ttak_unsafe_region_init(&out, CHANNEL_CTX_PRODUCER, NULL);
+    ASSERT(!ttak_region_channel_recv(&ch, &out));
+    ttak_unsafe_region_init(&out, CHANNEL_CTX_CONSUMER, NULL);
+    ttak_unsafe_region_pin(&out);
+    ASSERT(!ttak_region_channel_recv(&ch, &out));
+    ttak_unsafe_region_unpin(&out);
+    ASSERT(ttak_region_channel_recv(&ch, &out));
+    ASSERT(out.ptr == &value && out.ctx_id == CHANNEL_CTX_CONSUMER);
+    ASSERT(strcmp(out.allocator_tag, "consumer") == 0);
+    ASSERT(!ttak_region_channel_recv(&ch, &out));
+
+    // A producer thread streams payloads; the consumer drains them in batches, in order.
+    pthread_t producer;
+    pthread_create(&producer, NULL, channel_producer, &ch);
+    ttak_unsafe_region_t batch[32];
+    uint32_t expected = 0;
+    while (expected < CHANNEL_MESSAGES) {
+        for (int i = 0; i < 32; i++) {
+            ttak_unsafe_region_init(&batch[i], CHANNEL_CTX_CONSUMER, NULL);
+        }
+        size_t n = ttak_region_channel_recv_batch(&ch, batch, 32);
+        for (size_t i = 0; i < n; i++) {
+            ASSERT(*(uint32_t *)batch[i].ptr == expected);
+            ASSERT(batch[i].ctx_id == CHANNEL_CTX_CONSUMER);
+            expected++;
+            free(batch[i].ptr);
+        }
+        if (n == 0) sched_yield();
+    }
+    pthread_join(producer, NULL);
+    ASSERT(ttak_region_channel_count(&ch) == 0);
+    ttak_region_channel_destroy(&ch);
+}
+
 int main() {
     printf("=== Test: New Features ===\n");
     RUN_TEST(test_logger);
@@ -133,7 +711,17 @@ int main() {
     RUN_TEST(test_ringbuf);
     RUN_TEST(test_pool);
     RUN_TEST(test_epoch_gc);
+    RUN_TEST(test_epoch_gc_grace_period);
+    RUN_TEST(test_epoch_gc_concurrent);
+    RUN_TEST(test_hazard_protect_retire);
+    RUN_TEST(test_hazard_two_domains);
+    RUN_TEST(test_hazard_concurrent);
     RUN_TEST(test_sync_timing);
+    RUN_TEST(test_wal_group_commit);
+    RUN_TEST(test_wal_group_commit_batches);
+    RUN_TEST(test_wal_crash_recovery);
+    RUN_TEST(test_save_current_progress);
+    RUN_TEST(test_region_channel);
     printf("=== All New Feature Tests Passed ===\n");
     return 0;
 }
\ No newline at end of file
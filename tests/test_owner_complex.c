@@ -1,5 +1,10 @@
 #include <ttak/mem/owner.h>
 #include <ttak/mem/mem.h>
+#include <ttak/unsafe/context.h>
+#include <ttak/timing/timing.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
@@ -56,6 +61,197 @@ static void root_supervisor(void *ctx, void *args) {
     printf("[Root] Child execution finished and destroyed.\n");
 }
 
+static void add_task(void *ctx, void *args) {
+    if (ctx) *(int *)ctx += *(int *)args;
+}
+
+static void mul_task(void *ctx, void *args) {
+    if (ctx) *(int *)ctx *= *(int *)args;
+}
+
+static void null_ctx_task(void *ctx, void *args) {
+    *(bool *)args = (ctx == NULL);
+}
+
+// Registers into the owner it runs in; needs the lock to be free during the call.
+static void reentrant_task(void *ctx, void *args) {
+    ttak_owner_t *owner = (ttak_owner_t *)args;
+    ASSERT(ttak_owner_register_resource(owner, "late", ctx));
+}
+
+void test_owner_handles() {
+    ttak_owner_t *owner = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(owner != NULL);
+
+    int counter = 1;
+    ASSERT(ttak_owner_register_resource(owner, "counter", &counter));
+    ASSERT(ttak_owner_register_func(owner, "add", add_task));
+    // "aX" and "b7" have the same DJB2 hash; they must still be separate entries.
+    ASSERT(ttak_owner_register_func(owner, "aX", add_task));
+    ASSERT(ttak_owner_register_func(owner, "b7", mul_task));
+
+    ttak_owner_handle_t add = ttak_owner_resolve_func(owner, "add");
+    ttak_owner_handle_t ax = ttak_owner_resolve_func(owner, "aX");
+    ttak_owner_handle_t b7 = ttak_owner_resolve_func(owner, "b7");
+    ttak_owner_handle_t res = ttak_owner_resolve_resource(owner, "counter");
+    ASSERT(add != TTAK_OWNER_INVALID_HANDLE && res != TTAK_OWNER_INVALID_HANDLE);
+    ASSERT(ax != b7 && ax != TTAK_OWNER_INVALID_HANDLE && b7 != TTAK_OWNER_INVALID_HANDLE);
+    ASSERT(ttak_owner_resolve_func(owner, "missing") == TTAK_OWNER_INVALID_HANDLE);
+
+    int two = 2;
+    ASSERT(ttak_owner_execute_handle(owner, add, res, &two));
+    ASSERT(counter == 3);
+    ASSERT(ttak_owner_execute_handle(owner, b7, res, &two));
+    ASSERT(counter == 6);
+    ASSERT(ttak_owner_execute(owner, "aX", "counter", &two));
+    ASSERT(counter == 8);
+    ASSERT(!ttak_owner_execute_handle(owner, 9999, res, &two));
+    ASSERT(!ttak_owner_execute_handle(owner, TTAK_OWNER_INVALID_HANDLE, res, &two));
+
+    // Re-registering keeps the handle and swaps the target.
+    ASSERT(ttak_owner_register_func(owner, "add", mul_task));
+    ASSERT(ttak_owner_resolve_func(owner, "add") == add);
+    ASSERT(ttak_owner_execute_handle(owner, add, res, &two));
+    ASSERT(counter == 16);
+
+    // A transferred resource reaches the callback as NULL through the stale handle.
+    ttak_owner_t *other = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ASSERT(other != NULL);
+    ASSERT(ttak_owner_transfer_resource(owner, other, "counter"));
+    ASSERT(!ttak_owner_transfer_resource(owner, other, "counter"));
+    ASSERT(ttak_owner_register_func(owner, "null_ctx", null_ctx_task));
+    bool was_null = false;
+    ASSERT(ttak_owner_execute_handle(owner, ttak_owner_resolve_func(owner, "null_ctx"), res, &was_null));
+    ASSERT(was_null);
+    ASSERT(ttak_owner_transfer_resource(other, owner, "counter"));
+    ASSERT(ttak_owner_resolve_resource(owner, "counter") == res);
+    ASSERT(ttak_owner_execute_handle(owner, b7, res, &two));
+    ASSERT(counter == 32);
+
+    ASSERT(ttak_owner_register_func(owner, "reentrant", reentrant_task));
+    ASSERT(ttak_owner_execute(owner, "reentrant", "counter", owner));
+    ASSERT(ttak_owner_resolve_resource(owner, "late") != TTAK_OWNER_INVALID_HANDLE);
+
+    ttak_owner_destroy(other);
+    ttak_owner_destroy(owner);
+}
+
+static int dtor_calls;
+
+static void count_dtor(void *data) {
+    dtor_calls++;
+    *(int *)data = -1;
+}
+
+static void read_blob(void *ctx, void *args) {
+    memcpy(args, ctx, 16);
+}
+
+void test_owner_arena_teardown() {
+    ttak_owner_t *parent = ttak_owner_create_sized(TTAK_OWNER_SAFE_DEFAULT, 1024);
+    ttak_owner_t *other = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_owner_t *child = ttak_owner_create(TTAK_OWNER_STRICT_ISOLATION);
+    ASSERT(parent && other && child);
+
+    // Plenty of small objects; none of them is freed on its own.
+    for (int i = 0; i < 1000; i++) {
+        int *obj = ttak_owner_alloc(parent, 24);
+        ASSERT(obj != NULL && obj[0] == 0);
+        obj[0] = i;
+    }
+
+    int parent_res = 1, child_res = 2;
+    dtor_calls = 0;
+    ASSERT(ttak_owner_register_resource_dtor(parent, "res", &parent_res, count_dtor));
+    ASSERT(ttak_owner_register_resource_dtor(child, "res", &child_res, count_dtor));
+    ASSERT(ttak_owner_adopt(parent, "child", child));
+
+    char *blob = ttak_owner_alloc_resource(parent, "blob", 16, NULL);
+    ASSERT(blob != NULL);
+    memcpy(blob, "arena-resident!", 16);
+
+    // Moving the child owner moves its resources along with it.
+    ASSERT(ttak_owner_transfer_resource(parent, other, "child"));
+
+    // Arena-resident resources stay with the arena they live in.
+    ASSERT(!ttak_owner_transfer_resource(parent, other, "blob"));
+    ASSERT(ttak_owner_resolve_resource(other, "blob") == TTAK_OWNER_INVALID_HANDLE);
+    ASSERT(ttak_owner_register_func(parent, "read_blob", read_blob));
+    char out[16] = {0};
+    ASSERT(ttak_owner_execute(parent, "read_blob", "blob", out));
+    ASSERT(memcmp(out, "arena-resident!", 16) == 0);
+
+    ttak_owner_destroy(parent);
+    ASSERT(dtor_calls == 1 && parent_res == -1);
+    ASSERT(child_res == 2);
+
+    ttak_owner_destroy(other);
+    ASSERT(dtor_calls == 2 && child_res == -1);
+}
+
+static _Atomic int readers_inside = 0;
+static _Atomic int readers_overlapped = 0;
+
+static void overlapping_reader(const void *shared_mem, size_t shared_size, void *arg) {
+    (void)arg;
+    ASSERT(shared_size == sizeof(int) && *(const int *)shared_mem == 7);
+    atomic_fetch_add(&readers_inside, 1);
+    // Wait (bounded) for the other reader to enter as well.
+    uint64_t give_up = ttak_get_tick_count() + 2000;
+    while (atomic_load(&readers_inside) < 2 && ttak_get_tick_count() < give_up) {
+        sched_yield();
+    }
+    if (atomic_load(&readers_inside) >= 2) atomic_store(&readers_overlapped, 1);
+}
+
+static void *context_reader_thread(void *arg) {
+    ttak_context_run_read((ttak_context_t *)arg, __TTAK_CTX_USE_FIRST__, overlapping_reader, NULL);
+    return NULL;
+}
+
+static void add_to_shared(void *shared_mem, size_t shared_size, void *arg) {
+    (void)shared_size;
+    *(int *)shared_mem += *(int *)arg;
+}
+
+void test_context_read_write_batch() {
+    ttak_owner_t *first = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    ttak_owner_t *second = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
+    int shared = 7;
+    ttak_context_t ctx;
+    ASSERT(ttak_context_init(&ctx, first, second, &shared, sizeof(shared), __TTAK_CTX_USE_FIRST__));
+
+    // Two read runs are inside their callbacks at the same time.
+    pthread_t readers[2];
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&readers[i], NULL, context_reader_thread, &ctx);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    ASSERT(atomic_load(&readers_overlapped) == 1);
+
+    // A batch runs every callback in order under one acquisition.
+    int one = 1, ten = 10;
+    ttak_context_op_t ops[3] = {
+        { add_to_shared, &one }, { add_to_shared, &ten }, { add_to_shared, &one }
+    };
+    ASSERT(ttak_context_run_batch(&ctx, __TTAK_CTX_USE_SECOND__, TTAK_CONTEXT_WRITE, ops, 3));
+    ASSERT(shared == 19);
+    ops[1].cb = NULL;
+    ASSERT(!ttak_context_run_batch(&ctx, __TTAK_CTX_USE_FIRST__, TTAK_CONTEXT_WRITE, ops, 3));
+    ASSERT(shared == 19);
+
+    ASSERT(ttak_context_reassign(&ctx, __TTAK_CTX_USE_SECOND__));
+    ASSERT(ttak_context_run_write(&ctx, __TTAK_CTX_USE_SECOND__, add_to_shared, &one));
+    ASSERT(ttak_context_run(&ctx, __TTAK_CTX_USE_SECOND__, add_to_shared, &one));
+    ASSERT(shared == 21 && ttak_context_active(&ctx) == __TTAK_CTX_USE_SECOND__);
+
+    ttak_context_destroy(&ctx);
+    ttak_owner_destroy(second);
+    ttak_owner_destroy(first);
+}
+
 int main() {
     printf("=== Test: Complex Owner Hierarchy ===\n");
     
@@ -75,6 +271,10 @@ int main() {
     
     // 4. Cleanup
     ttak_owner_destroy(root);
+
+    RUN_TEST(test_owner_handles);
+    RUN_TEST(test_owner_arena_teardown);
+    RUN_TEST(test_context_read_write_batch);
     
     printf("=== Test: Owner Passed ===\n");
     return 0;
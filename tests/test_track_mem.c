@@ -10,7 +10,9 @@ int main() {
     void *ptr = ttak_mem_alloc(1024, TT_SECOND(10), now);
     
     // 2. Access
-    ttak_mem_access(ptr, now + 100);
+    if (ttak_mem_access(ptr, now + 100)) {
+        ttak_mem_unpin(ptr);
+    }
     
     // 3. Ownership and Transfer
     ttak_owner_t *owner1 = ttak_owner_create(TTAK_OWNER_SAFE_DEFAULT);
@@ -43,6 +43,7 @@ int main(void) {
     char *midway = ttak_mem_access(message, checkpoint);
     if (midway) {
         printf("[midway @ %" PRIu64 "] %s\n", checkpoint, midway);
+        ttak_mem_unpin(midway);
     } else {
         printf("[midway @ %" PRIu64 "] Allocation expired earlier than expected\n", checkpoint);
     }
@@ -2,16 +2,30 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ttak/mem/epoch_gc.h>
+#include <ttak/mem/mem.h>
 
 int main(void) {
     ttak_epoch_gc_t gc;
     ttak_epoch_gc_init(&gc);
-    int *value = malloc(sizeof(*value));
+    int *value = ttak_mem_alloc(sizeof(*value), __TTAK_UNSAFE_MEM_FOREVER__, 0);
     if (value) {
         *value = 7;
         ttak_epoch_gc_register(&gc, value, sizeof(*value));
         puts("registered allocation with epoch GC");
     }
+
+    /* Readers bracket shared accesses; writers retire what they unlink. */
+    int *shared = malloc(sizeof(*shared));
+    if (shared) {
+        *shared = 42;
+        ttak_epoch_gc_enter(&gc);
+        printf("reader sees %d\n", *shared);
+        ttak_epoch_gc_retire(&gc, shared, free);
+        ttak_epoch_gc_exit(&gc);
+        puts("retired block waits until every reader has moved on");
+    }
+
+    ttak_epoch_gc_rotate(&gc);
     ttak_epoch_gc_rotate(&gc);
     ttak_epoch_gc_destroy(&gc);
     return 0;
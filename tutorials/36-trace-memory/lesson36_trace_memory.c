@@ -104,7 +104,8 @@ void lru_put_ex(lru_cache_t *cache, const char *key, size_t val_size, uint64_t n
 	cache->buckets[idx] = node;
 
 	/* Structural Update */
-	ttak_mem_access(node->data, now);
+	if (ttak_mem_access(node->data, now))
+		ttak_mem_unpin(node->data);
 	ttak_owner_register_resource(cache->owner, key, node->data);
 	attach_to_head(cache, node);
 
@@ -121,7 +122,8 @@ void lru_get(lru_cache_t *cache, const char *key, uint64_t now) {
 	lru_entry_t *curr = cache->buckets[idx];
 	while (curr) {
 		if (strcmp(curr->key, key) == 0) {
-			ttak_mem_access(curr->data, now);
+			if (ttak_mem_access(curr->data, now))
+				ttak_mem_unpin(curr->data);
 			curr->last_access = now;
 			detach_node(cache, curr);
 			attach_to_head(cache, curr);